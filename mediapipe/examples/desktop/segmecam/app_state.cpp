@@ -6,9 +6,10 @@ namespace segmecam {
 
 void AppState::SaveToProfile(cv::FileStorage& fs) const {
   fs << "vsync_on" << (int)vsync_on;
-  fs << "show_mask" << (int)show_mask << "bg_mode" << bg_mode << "blur_strength" << blur_strength << "feather_px" << feather_px;
+  fs << "show_mask" << (int)show_mask << "bg_mode" << bg_mode << "blur_strength" << blur_strength << "blur_backend" << blur_backend << "mask_upsampler" << mask_upsampler << "feather_px" << feather_px;
   fs << "solid_color" << "[" << solid_color[0] << solid_color[1] << solid_color[2] << "]";
   fs << "bg_path" << bg_path_buf;
+  fs << "bg_video_path" << bg_video_path_buf << "bg_video_preload" << (int)bg_video_preload;
   fs << "show_landmarks" << (int)show_landmarks << "lm_roi_mode" << (int)lm_roi_mode << "lm_apply_rot" << (int)lm_apply_rot
       << "lm_flip_x" << (int)lm_flip_x << "lm_flip_y" << (int)lm_flip_y << "lm_swap_xy" << (int)lm_swap_xy
       << "show_mesh" << (int)show_mesh << "show_mesh_dense" << (int)show_mesh_dense;
@@ -35,6 +36,8 @@ void AppState::LoadFromProfile(const cv::FileNode& root) {
   show_mask = ReadInt(root["show_mask"], show_mask);
   bg_mode = ReadInt(root["bg_mode"], bg_mode);
   blur_strength = ReadInt(root["blur_strength"], blur_strength);
+  blur_backend = ReadInt(root["blur_backend"], blur_backend);
+  mask_upsampler = ReadInt(root["mask_upsampler"], mask_upsampler);
   feather_px = ReadFloat(root["feather_px"], feather_px);
   
   // Load solid color array
@@ -51,6 +54,12 @@ void AppState::LoadFromProfile(const cv::FileNode& root) {
     root["bg_path"] >> bg_path_str;
     std::snprintf(bg_path_buf, sizeof(bg_path_buf), "%s", bg_path_str.c_str());
   }
+  if (!root["bg_video_path"].empty()) {
+    std::string bg_video_path_str;
+    root["bg_video_path"] >> bg_video_path_str;
+    std::snprintf(bg_video_path_buf, sizeof(bg_video_path_buf), "%s", bg_video_path_str.c_str());
+  }
+  bg_video_preload = ReadInt(root["bg_video_preload"], bg_video_preload);
   
   show_landmarks = ReadInt(root["show_landmarks"], show_landmarks);
   lm_roi_mode = ReadInt(root["lm_roi_mode"], lm_roi_mode);
@@ -9,10 +9,14 @@
 
 namespace segmecam {
 
+class SessionRecorder;
+
 struct AppState {
   // Display and processing state
   bool show_mask = false;
   int blur_strength = 25;
+  int blur_backend = 0;  // 0=Gaussian, 1=Box (constant time), 2=Pyramid (push-pull)
+  int mask_upsampler = 0;  // 0=Bilinear, 1=Guided (edge-aware)
   float feather_px = 2.0f;
   int64_t frame_id = 0;
   bool dbg_composite_rgb = false;
@@ -39,12 +43,21 @@ struct AppState {
   uint32_t auto_scale_last_time_ms = 0;
   bool auto_scale_enabled = false;
   
-  // Background mode: 0=None, 1=Blur, 2=Image, 3=Solid Color
+  // Background mode: 0=None, 1=Blur, 2=Image, 3=Solid Color, 4=Video
   int bg_mode = 1; // Default to Blur mode to show segmentation effects
   cv::Mat bg_image; // background image (BGR)
   char bg_path_buf[512] = {0};
+  char bg_video_path_buf[512] = {0};
+  bool bg_video_preload = true; // Hold short clips fully decoded in memory
   float solid_color[3] = {0.0f, 0.0f, 0.0f}; // RGB 0..1
   
+  // Frame/mask fusion: 0=wait for matching mask, 1=use latest, 2=extrapolate
+  int fusion_policy = 0;
+  int fusion_max_wait_ms = 100;
+  
+  // Session recording (--record); frame loops tap their synchronizer into it
+  SessionRecorder* session_recorder = nullptr;
+  
   // Cached data
   cv::Mat last_mask_u8;  // cache latest mask to avoid blocking
   cv::Mat last_display_rgb;
@@ -0,0 +1,479 @@
+#include "composite_kernels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SEGMECAM_BLEND_X86 1
+#define SEGMECAM_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SEGMECAM_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SEGMECAM_BLEND_NEON 1
+#endif
+
+namespace segmecam {
+
+namespace {
+
+// Blends `width` pixels of one row; fg/bg BGR, out RGB
+using BlendRowFn = void (*)(const uint8_t* fg, const uint8_t* bg, const uint8_t* mask,
+                            uint8_t* out, int width);
+
+// Rounded x / 255 for x in [0, 255 * 255]
+inline int Div255(int x) {
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+void BlendRowScalar(const uint8_t* fg, const uint8_t* bg, const uint8_t* mask,
+                    uint8_t* out, int width) {
+  for (int x = 0; x < width; ++x) {
+    const int a = mask[x];
+    const int ia = 255 - a;
+    const uint8_t* f = fg + x * 3;
+    const uint8_t* b = bg + x * 3;
+    uint8_t* o = out + x * 3;
+    o[0] = (uint8_t)Div255(f[2] * a + b[2] * ia);
+    o[1] = (uint8_t)Div255(f[1] * a + b[1] * ia);
+    o[2] = (uint8_t)Div255(f[0] * a + b[0] * ia);
+  }
+}
+
+// Masked LUT over `width` pixels of one 8-bit row, in place
+using LutRowFn = void (*)(uint8_t* row, const uint8_t* lut, const uint8_t* mask, int width);
+
+void LutRowScalar(uint8_t* row, const uint8_t* lut, const uint8_t* mask, int width) {
+  for (int x = 0; x < width; ++x) {
+    const int a = mask[x];
+    if (a == 0) continue;
+    row[x] = (uint8_t)Div255(lut[row[x]] * a + row[x] * (255 - a));
+  }
+}
+
+// Mask == 255 (or 0 with fg = bg) across the row: BGR -> RGB copy
+using SwapRowFn = void (*)(const uint8_t* bgr, uint8_t* out, int width);
+
+void SwapRowScalar(const uint8_t* bgr, uint8_t* out, int width) {
+  for (int x = 0; x < width; ++x) {
+    out[x * 3 + 0] = bgr[x * 3 + 2];
+    out[x * 3 + 1] = bgr[x * 3 + 1];
+    out[x * 3 + 2] = bgr[x * 3 + 0];
+  }
+}
+
+#if defined(SEGMECAM_BLEND_X86)
+
+// x86 kernels work on 16 pixels = three 16-byte registers of packed BGR.
+// alpha[k] spreads the 16 mask bytes over register k's bytes (pixel i/3);
+// swap[k][j] picks register j's bytes for output register k with B and R
+// exchanged (a pixel may straddle two registers, hence the OR of shuffles).
+struct ShuffleTables {
+  alignas(16) uint8_t alpha[3][16];
+  alignas(16) uint8_t swap[3][3][16];
+};
+
+ShuffleTables MakeShuffleTables() {
+  ShuffleTables t;
+  for (int i = 0; i < 48; ++i) {
+    const int k = i / 16;
+    const int src = (i / 3) * 3 + 2 - (i % 3);
+    t.alpha[k][i % 16] = (uint8_t)(i / 3);
+    for (int j = 0; j < 3; ++j) {
+      t.swap[k][j][i % 16] = (src / 16 == j) ? (uint8_t)(src % 16) : 0x80;  // 0x80 -> zero
+    }
+  }
+  return t;
+}
+
+const ShuffleTables& Tables() {
+  static const ShuffleTables tables = MakeShuffleTables();
+  return tables;
+}
+
+// Output registers 0 and 2 only draw from their neighbours (see swap tables)
+#define SEGMECAM_STORE_SWAPPED(out, r, s)                                                  \
+  do {                                                                                     \
+    __m128i o0 = _mm_or_si128(_mm_shuffle_epi8(r[0], s[0][0]), _mm_shuffle_epi8(r[1], s[0][1])); \
+    __m128i o1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(r[0], s[1][0]),                 \
+                                           _mm_shuffle_epi8(r[1], s[1][1])),                \
+                              _mm_shuffle_epi8(r[2], s[1][2]));                             \
+    __m128i o2 = _mm_or_si128(_mm_shuffle_epi8(r[1], s[2][1]), _mm_shuffle_epi8(r[2], s[2][2])); \
+    _mm_storeu_si128((__m128i*)(out), o0);                                                 \
+    _mm_storeu_si128((__m128i*)((out) + 16), o1);                                          \
+    _mm_storeu_si128((__m128i*)((out) + 32), o2);                                          \
+  } while (0)
+
+SEGMECAM_TARGET_SSE41 inline __m128i Div255Epu16SSE(__m128i x) {
+  __m128i t = _mm_add_epi16(x, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+SEGMECAM_TARGET_SSE41 inline __m128i Blend16SSE(__m128i f, __m128i b, __m128i a) {
+  const __m128i ia = _mm_xor_si128(a, _mm_set1_epi8(-1));  // 255 - a
+  const __m128i zero = _mm_setzero_si128();
+  __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_cvtepu8_epi16(f), _mm_cvtepu8_epi16(a)),
+                             _mm_mullo_epi16(_mm_cvtepu8_epi16(b), _mm_cvtepu8_epi16(ia)));
+  __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(f, zero), _mm_unpackhi_epi8(a, zero)),
+                             _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(ia, zero)));
+  return _mm_packus_epi16(Div255Epu16SSE(lo), Div255Epu16SSE(hi));
+}
+
+SEGMECAM_TARGET_SSE41 void BlendRowSSE41(const uint8_t* fg, const uint8_t* bg, const uint8_t* mask,
+                                         uint8_t* out, int width) {
+  const ShuffleTables& t = Tables();
+  __m128i A[3], S[3][3];
+  for (int k = 0; k < 3; ++k) {
+    A[k] = _mm_load_si128((const __m128i*)t.alpha[k]);
+    for (int j = 0; j < 3; ++j) S[k][j] = _mm_load_si128((const __m128i*)t.swap[k][j]);
+  }
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8_t* f = fg + x * 3;
+    const uint8_t* b = bg + x * 3;
+    const __m128i m = _mm_loadu_si128((const __m128i*)(mask + x));
+    __m128i r[3];
+    for (int k = 0; k < 3; ++k) {
+      r[k] = Blend16SSE(_mm_loadu_si128((const __m128i*)(f + 16 * k)),
+                        _mm_loadu_si128((const __m128i*)(b + 16 * k)),
+                        _mm_shuffle_epi8(m, A[k]));
+    }
+    SEGMECAM_STORE_SWAPPED(out + x * 3, r, S);
+  }
+  BlendRowScalar(fg + x * 3, bg + x * 3, mask + x, out + x * 3, width - x);
+}
+
+// Same data movement as SSE4.1; the multiply-adds run 16 lanes wide
+SEGMECAM_TARGET_AVX2 inline __m128i Blend16AVX2(__m128i f, __m128i b, __m128i a) {
+  const __m256i a16 = _mm256_cvtepu8_epi16(a);
+  const __m256i ia16 = _mm256_sub_epi16(_mm256_set1_epi16(255), a16);
+  __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_cvtepu8_epi16(f), a16),
+                               _mm256_mullo_epi16(_mm256_cvtepu8_epi16(b), ia16));
+  __m256i t = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+  t = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+  return _mm_packus_epi16(_mm256_castsi256_si128(t), _mm256_extracti128_si256(t, 1));
+}
+
+SEGMECAM_TARGET_AVX2 void BlendRowAVX2(const uint8_t* fg, const uint8_t* bg, const uint8_t* mask,
+                                       uint8_t* out, int width) {
+  const ShuffleTables& t = Tables();
+  __m128i A[3], S[3][3];
+  for (int k = 0; k < 3; ++k) {
+    A[k] = _mm_load_si128((const __m128i*)t.alpha[k]);
+    for (int j = 0; j < 3; ++j) S[k][j] = _mm_load_si128((const __m128i*)t.swap[k][j]);
+  }
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8_t* f = fg + x * 3;
+    const uint8_t* b = bg + x * 3;
+    const __m128i m = _mm_loadu_si128((const __m128i*)(mask + x));
+    __m128i r[3];
+    for (int k = 0; k < 3; ++k) {
+      r[k] = Blend16AVX2(_mm_loadu_si128((const __m128i*)(f + 16 * k)),
+                         _mm_loadu_si128((const __m128i*)(b + 16 * k)),
+                         _mm_shuffle_epi8(m, A[k]));
+    }
+    SEGMECAM_STORE_SWAPPED(out + x * 3, r, S);
+  }
+  BlendRowScalar(fg + x * 3, bg + x * 3, mask + x, out + x * 3, width - x);
+}
+
+// There is no byte gather: the 16 lookups are scalar, the blend is not
+#define SEGMECAM_LUT_ROW(Blend16)                                            \
+  int x = 0;                                                                 \
+  alignas(16) uint8_t looked[16];                                            \
+  for (; x + 16 <= width; x += 16) {                                         \
+    const __m128i m = _mm_loadu_si128((const __m128i*)(mask + x));           \
+    if (_mm_testz_si128(m, m)) continue;                                     \
+    for (int i = 0; i < 16; ++i) looked[i] = lut[row[x + i]];                \
+    const __m128i p = _mm_loadu_si128((const __m128i*)(row + x));            \
+    _mm_storeu_si128((__m128i*)(row + x),                                    \
+                     Blend16(_mm_load_si128((const __m128i*)looked), p, m)); \
+  }                                                                          \
+  LutRowScalar(row + x, lut, mask + x, width - x)
+
+SEGMECAM_TARGET_SSE41 void LutRowSSE41(uint8_t* row, const uint8_t* lut, const uint8_t* mask, int width) {
+  SEGMECAM_LUT_ROW(Blend16SSE);
+}
+
+SEGMECAM_TARGET_AVX2 void LutRowAVX2(uint8_t* row, const uint8_t* lut, const uint8_t* mask, int width) {
+  SEGMECAM_LUT_ROW(Blend16AVX2);
+}
+
+#undef SEGMECAM_LUT_ROW
+
+// pshufb is SSSE3, covered by the SSE4.1 target and by every AVX2 CPU
+SEGMECAM_TARGET_SSE41 void SwapRowSSE41(const uint8_t* bgr, uint8_t* out, int width) {
+  const ShuffleTables& t = Tables();
+  __m128i S[3][3];
+  for (int k = 0; k < 3; ++k) {
+    for (int j = 0; j < 3; ++j) S[k][j] = _mm_load_si128((const __m128i*)t.swap[k][j]);
+  }
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8_t* f = bgr + x * 3;
+    __m128i r[3];
+    for (int k = 0; k < 3; ++k) r[k] = _mm_loadu_si128((const __m128i*)(f + 16 * k));
+    SEGMECAM_STORE_SWAPPED(out + x * 3, r, S);
+  }
+  SwapRowScalar(bgr + x * 3, out + x * 3, width - x);
+}
+
+#undef SEGMECAM_STORE_SWAPPED
+
+#elif defined(SEGMECAM_BLEND_NEON)
+
+// vld3/vst3 de-interleave and re-interleave BGR for free, so the channel
+// swap is just a register permutation
+inline uint8x8_t Div255NarrowNEON(uint16x8_t x) {
+  uint16x8_t t = vaddq_u16(x, vdupq_n_u16(128));
+  return vaddhn_u16(t, vshrq_n_u16(t, 8));  // (t + (t >> 8)) >> 8
+}
+
+void BlendRowNEON(const uint8_t* fg, const uint8_t* bg, const uint8_t* mask,
+                  uint8_t* out, int width) {
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8x16x3_t f = vld3q_u8(fg + x * 3);
+    const uint8x16x3_t b = vld3q_u8(bg + x * 3);
+    const uint8x16_t a = vld1q_u8(mask + x);
+    const uint8x16_t ia = vmvnq_u8(a);
+    uint8x16x3_t o;
+    for (int c = 0; c < 3; ++c) {
+      uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(f.val[c]), vget_low_u8(a)),
+                               vget_low_u8(b.val[c]), vget_low_u8(ia));
+      uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(f.val[c]), vget_high_u8(a)),
+                               vget_high_u8(b.val[c]), vget_high_u8(ia));
+      o.val[2 - c] = vcombine_u8(Div255NarrowNEON(lo), Div255NarrowNEON(hi));
+    }
+    vst3q_u8(out + x * 3, o);
+  }
+  BlendRowScalar(fg + x * 3, bg + x * 3, mask + x, out + x * 3, width - x);
+}
+
+void LutRowNEON(uint8_t* row, const uint8_t* lut, const uint8_t* mask, int width) {
+  int x = 0;
+  uint8_t looked[16];
+  for (; x + 16 <= width; x += 16) {
+    const uint8x16_t a = vld1q_u8(mask + x);
+    const uint8x8_t any = vorr_u8(vget_low_u8(a), vget_high_u8(a));
+    if (vget_lane_u64(vreinterpret_u64_u8(any), 0) == 0) continue;
+    for (int i = 0; i < 16; ++i) looked[i] = lut[row[x + i]];
+    const uint8x16_t f = vld1q_u8(looked);
+    const uint8x16_t p = vld1q_u8(row + x);
+    const uint8x16_t ia = vmvnq_u8(a);
+    uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(f), vget_low_u8(a)), vget_low_u8(p), vget_low_u8(ia));
+    uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(f), vget_high_u8(a)), vget_high_u8(p), vget_high_u8(ia));
+    vst1q_u8(row + x, vcombine_u8(Div255NarrowNEON(lo), Div255NarrowNEON(hi)));
+  }
+  LutRowScalar(row + x, lut, mask + x, width - x);
+}
+
+void SwapRowNEON(const uint8_t* bgr, uint8_t* out, int width) {
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    uint8x16x3_t v = vld3q_u8(bgr + x * 3);
+    const uint8x16_t b = v.val[0];
+    v.val[0] = v.val[2];
+    v.val[2] = b;
+    vst3q_u8(out + x * 3, v);
+  }
+  SwapRowScalar(bgr + x * 3, out + x * 3, width - x);
+}
+
+#endif
+
+struct BlendKernel {
+  BlendRowFn row;
+  SwapRowFn swap;
+  LutRowFn lut;
+  const char* name;
+};
+
+BlendKernel SelectKernel() {
+#if defined(SEGMECAM_BLEND_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return {BlendRowAVX2, SwapRowSSE41, LutRowAVX2, "avx2"};
+  if (__builtin_cpu_supports("sse4.1")) return {BlendRowSSE41, SwapRowSSE41, LutRowSSE41, "sse4.1"};
+#elif defined(SEGMECAM_BLEND_NEON)
+  return {BlendRowNEON, SwapRowNEON, LutRowNEON, "neon"};
+#endif
+  return {BlendRowScalar, SwapRowScalar, LutRowScalar, "scalar"};
+}
+
+const BlendKernel& Kernel() {
+  static const BlendKernel kernel = SelectKernel();
+  return kernel;
+}
+
+bool ValidInputs(const cv::Mat& fg_bgr, const cv::Mat& mask_u8) {
+  return !fg_bgr.empty() && fg_bgr.type() == CV_8UC3 && mask_u8.type() == CV_8UC1 &&
+         mask_u8.size() == fg_bgr.size();
+}
+
+// Horizontal run of same-class tiles within one tile row, in pixels
+struct TileSpan {
+  int x;
+  int width;
+  MaskTile cls;
+};
+
+// Merges neighbouring tiles of band ty into spans, so each output row is a
+// handful of long copies/blends instead of one call per tile
+void BandSpans(const MaskTileMap& map, int ty, int cols, std::vector<TileSpan>& spans) {
+  spans.clear();
+  for (int tx = 0; tx < map.tiles_x; ++tx) {
+    const MaskTile cls = map.At(tx, ty);
+    const int x = tx * map.tile_size;
+    const int w = std::min(map.tile_size, cols - x);
+    if (!spans.empty() && spans.back().cls == cls) spans.back().width += w;
+    else spans.push_back({x, w, cls});
+  }
+}
+
+// Row loop shared by the image and solid blends. bg(y) is the BGR
+// background row (blend input); bg_fill writes a pure-background span.
+template <typename BgRow, typename BgFill>
+void BlendByTiles(const cv::Mat& fg_bgr, const cv::Mat& mask_u8, cv::Mat& out_rgb,
+                  BgRow bg, BgFill bg_fill) {
+  thread_local MaskTileMap map;
+  thread_local std::vector<TileSpan> spans;
+  ClassifyMaskTiles(mask_u8, map);
+  const BlendKernel& k = Kernel();
+  for (int ty = 0; ty < map.tiles_y; ++ty) {
+    BandSpans(map, ty, fg_bgr.cols, spans);
+    const int y1 = std::min(fg_bgr.rows, (ty + 1) * map.tile_size);
+    for (int y = ty * map.tile_size; y < y1; ++y) {
+      const uint8_t* f = fg_bgr.ptr<uint8_t>(y);
+      const uint8_t* m = mask_u8.ptr<uint8_t>(y);
+      uint8_t* o = out_rgb.ptr<uint8_t>(y);
+      for (const TileSpan& sp : spans) {
+        switch (sp.cls) {
+          case MaskTile::kForeground:
+            k.swap(f + sp.x * 3, o + sp.x * 3, sp.width);
+            break;
+          case MaskTile::kBackground:
+            bg_fill(y, sp.x, sp.width, o + sp.x * 3);
+            break;
+          default:
+            k.row(f + sp.x * 3, bg(y) + sp.x * 3, m + sp.x, o + sp.x * 3, sp.width);
+            break;
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+void ClassifyMaskTiles(const cv::Mat& mask_u8, MaskTileMap& map, int tile_size) {
+  CV_Assert(mask_u8.type() == CV_8UC1 && tile_size > 0);
+  map.tile_size = tile_size;
+  map.tiles_x = (mask_u8.cols + tile_size - 1) / tile_size;
+  map.tiles_y = (mask_u8.rows + tile_size - 1) / tile_size;
+  map.tiles.resize((size_t)map.tiles_x * map.tiles_y);
+  map.counts[0] = map.counts[1] = map.counts[2] = 0;
+
+  // Running min/max per tile of the current band; a tile that already holds
+  // both a non-255 and a non-0 value is an edge and is not scanned further
+  thread_local std::vector<uint8_t> lo, hi;
+  for (int ty = 0; ty < map.tiles_y; ++ty) {
+    lo.assign(map.tiles_x, 255);
+    hi.assign(map.tiles_x, 0);
+    const int y1 = std::min(mask_u8.rows, (ty + 1) * tile_size);
+    for (int y = ty * tile_size; y < y1; ++y) {
+      const uint8_t* m = mask_u8.ptr<uint8_t>(y);
+      for (int tx = 0; tx < map.tiles_x; ++tx) {
+        if (lo[tx] != 255 && hi[tx] != 0) continue;
+        const int x0 = tx * tile_size;
+        const int x1 = std::min(mask_u8.cols, x0 + tile_size);
+        uint8_t mn = lo[tx], mx = hi[tx];
+        for (int x = x0; x < x1; ++x) {
+          mn = std::min(mn, m[x]);
+          mx = std::max(mx, m[x]);
+        }
+        lo[tx] = mn;
+        hi[tx] = mx;
+      }
+    }
+    for (int tx = 0; tx < map.tiles_x; ++tx) {
+      MaskTile cls = lo[tx] == 255 ? MaskTile::kForeground
+                     : hi[tx] == 0 ? MaskTile::kBackground
+                                   : MaskTile::kEdge;
+      map.tiles[(size_t)ty * map.tiles_x + tx] = cls;
+      map.counts[(int)cls]++;
+    }
+  }
+}
+
+void BlendMaskedToRGB(const cv::Mat& fg_bgr, const cv::Mat& bg_bgr,
+                      const cv::Mat& mask_u8, cv::Mat& out_rgb) {
+  CV_Assert(ValidInputs(fg_bgr, mask_u8) && bg_bgr.type() == CV_8UC3 && bg_bgr.size() == fg_bgr.size());
+  out_rgb.create(fg_bgr.size(), CV_8UC3);
+  const SwapRowFn swap = Kernel().swap;
+  BlendByTiles(fg_bgr, mask_u8, out_rgb,
+               [&](int y) { return bg_bgr.ptr<uint8_t>(y); },
+               [&](int y, int x, int width, uint8_t* out) { swap(bg_bgr.ptr<uint8_t>(y) + x * 3, out, width); });
+}
+
+void BlendMaskedSolidToRGB(const cv::Mat& fg_bgr, const cv::Scalar& bg_bgr,
+                           const cv::Mat& mask_u8, cv::Mat& out_rgb) {
+  CV_Assert(ValidInputs(fg_bgr, mask_u8));
+  out_rgb.create(fg_bgr.size(), CV_8UC3);
+  // One background row per channel order, reused for every row (stays in cache)
+  thread_local std::vector<uint8_t> bg_row, fill_row;
+  bg_row.resize((size_t)fg_bgr.cols * 3);
+  fill_row.resize(bg_row.size());
+  const uint8_t color[3] = {cv::saturate_cast<uint8_t>(bg_bgr[0]), cv::saturate_cast<uint8_t>(bg_bgr[1]),
+                            cv::saturate_cast<uint8_t>(bg_bgr[2])};
+  for (size_t i = 0; i < bg_row.size(); ++i) {
+    bg_row[i] = color[i % 3];
+    fill_row[i] = color[2 - i % 3];
+  }
+
+  BlendByTiles(fg_bgr, mask_u8, out_rgb,
+               [&](int) { return (const uint8_t*)bg_row.data(); },
+               [&](int, int x, int width, uint8_t* out) { std::memcpy(out, fill_row.data() + x * 3, (size_t)width * 3); });
+}
+
+void MaskToRGB(const cv::Mat& mask_u8, cv::Mat& out_rgb) {
+  CV_Assert(mask_u8.type() == CV_8UC1);
+  out_rgb.create(mask_u8.size(), CV_8UC3);
+  thread_local MaskTileMap map;
+  thread_local std::vector<TileSpan> spans;
+  ClassifyMaskTiles(mask_u8, map);
+  for (int ty = 0; ty < map.tiles_y; ++ty) {
+    BandSpans(map, ty, mask_u8.cols, spans);
+    const int y1 = std::min(mask_u8.rows, (ty + 1) * map.tile_size);
+    for (int y = ty * map.tile_size; y < y1; ++y) {
+      const uint8_t* m = mask_u8.ptr<uint8_t>(y);
+      uint8_t* o = out_rgb.ptr<uint8_t>(y);
+      for (const TileSpan& sp : spans) {
+        if (sp.cls != MaskTile::kEdge) {
+          std::memset(o + sp.x * 3, sp.cls == MaskTile::kForeground ? 255 : 0, (size_t)sp.width * 3);
+          continue;
+        }
+        for (int x = sp.x; x < sp.x + sp.width; ++x) {
+          o[x * 3 + 0] = o[x * 3 + 1] = o[x * 3 + 2] = m[x];
+        }
+      }
+    }
+  }
+}
+
+void BlendLutMasked(cv::Mat& plane_u8, const uint8_t lut[256], const cv::Mat& mask_u8) {
+  CV_Assert(plane_u8.type() == CV_8UC1 && mask_u8.type() == CV_8UC1 && mask_u8.size() == plane_u8.size());
+  const LutRowFn row = Kernel().lut;
+  for (int y = 0; y < plane_u8.rows; ++y) {
+    row(plane_u8.ptr<uint8_t>(y), lut, mask_u8.ptr<uint8_t>(y), plane_u8.cols);
+  }
+}
+
+const char* BlendKernelName() {
+  return Kernel().name;
+}
+
+} // namespace segmecam
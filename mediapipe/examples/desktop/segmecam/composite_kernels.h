@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+
+namespace segmecam {
+
+// Fused alpha-composite kernels. One pass over the frame: reads 8-bit BGR
+// foreground, 8-bit background and the 8-bit mask, and writes 8-bit RGB:
+//
+//   out = (fg * m + bg * (255 - m)) / 255   (rounded), channels swapped to RGB
+//
+// Fixed-point only, no float planes or temporaries. The SIMD variant
+// (AVX2 / SSE4.1 on x86, chosen at runtime; NEON on ARM) is picked on first
+// use; results are bit-identical across variants.
+//
+// Only the transition band is blended: the mask is first classified in
+// 32x32 tiles (ClassifyMaskTiles) and pure-foreground / pure-background
+// tiles become straight copies or fills. The output is identical to blending
+// every pixel (m = 255 and m = 0 round exactly).
+
+enum class MaskTile : uint8_t { kBackground = 0, kForeground = 1, kEdge = 2 };
+
+struct MaskTileMap {
+  int tile_size = 32;
+  int tiles_x = 0;
+  int tiles_y = 0;
+  std::vector<MaskTile> tiles;  // Row-major, tiles_x * tiles_y
+  int counts[3] = {0, 0, 0};    // Tiles per MaskTile value
+
+  MaskTile At(int tx, int ty) const { return tiles[(size_t)ty * tiles_x + tx]; }
+  float EdgeFraction() const { return tiles.empty() ? 0.0f : (float)counts[2] / (float)tiles.size(); }
+};
+
+// Per-tile min/max of mask_u8 (CV_8UC1): all 255 -> foreground, all 0 ->
+// background, anything else -> edge. Border tiles cover the remainder.
+void ClassifyMaskTiles(const cv::Mat& mask_u8, MaskTileMap& map, int tile_size = 32);
+
+// fg_bgr, bg_bgr: CV_8UC3 of the same size; mask_u8: CV_8UC1 of that size.
+// out_rgb is (re)created as CV_8UC3 unless it already has that size/type,
+// so a pooled lease is written in place.
+void BlendMaskedToRGB(const cv::Mat& fg_bgr, const cv::Mat& bg_bgr,
+                      const cv::Mat& mask_u8, cv::Mat& out_rgb);
+
+// Same with a constant background color.
+void BlendMaskedSolidToRGB(const cv::Mat& fg_bgr, const cv::Scalar& bg_bgr,
+                           const cv::Mat& mask_u8, cv::Mat& out_rgb);
+
+// Mask visualization (gray -> RGB), same tile fast path: pure tiles are
+// memset, only edge tiles are expanded per pixel.
+void MaskToRGB(const cv::Mat& mask_u8, cv::Mat& out_rgb);
+
+// Masked 8-bit LUT, in place on one plane (e.g. a Lab channel):
+//
+//   p = (lut[p] * m + p * (255 - m)) / 255   (rounded)
+//
+// plane_u8, mask_u8: CV_8UC1 of the same size (views are fine). 16-pixel
+// chunks whose mask is all zero are skipped; same variants as the blends.
+void BlendLutMasked(cv::Mat& plane_u8, const uint8_t lut[256], const cv::Mat& mask_u8);
+
+// Variant in use: "avx2", "sse4.1", "neon" or "scalar"
+const char* BlendKernelName();
+
+} // namespace segmecam
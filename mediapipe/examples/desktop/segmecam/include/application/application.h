@@ -19,6 +19,7 @@ class OutputStreamPoller;
 #include "application/mediapipe_setup.h"
 #include "application/manager_coordination.h"
 #include "application/manager_coordination.h"
+#include "pipeline/session_file.h"
 #include "app_state.h"
 
 namespace segmecam {
@@ -69,6 +70,8 @@ private:
     std::unique_ptr<mediapipe::OutputStreamPoller> face_rects_poller_;             // Face rects poller
     ManagerCoordination::Managers managers_;
     segmecam::AppState app_state_;  // Shared app state for manager coordination
+    std::unique_ptr<SessionRecorder> session_recorder_;  // --record
+    std::unique_ptr<SessionReader> session_reader_;      // --replay
     
     // TODO: Enhanced UI panels integration (Phase 8 next iteration)
     // std::unique_ptr<segmecam::UIManager> ui_manager_;
@@ -10,6 +10,17 @@ struct ApplicationConfig {
     std::string cpu_graph_path = "mediapipe_graphs/selfie_seg_cpu_min.pbtxt";
     std::string resource_root_dir = ".";
     int cam_index = 0;
+    bool pipelined = false;  // Run capture/effects/vcam on separate threads
+    bool async_capture = false;  // Camera-owned capture thread (always on when pipelined)
+    int fusion_policy = 0;   // 0=wait for matching mask, 1=use latest, 2=extrapolate
+    int fusion_max_wait_ms = 100;
+    bool trace = false;      // Record stage spans from startup (F12 toggles at runtime)
+    std::string trace_file = "segmecam_trace.json";
+    bool headless = false;   // No window/GL/ImGui: capture -> effects -> virtual camera only
+    std::string profile;     // Settings profile to load (empty = default profile)
+    std::string vcam_device; // Loopback device for headless output (empty = AppState default)
+    std::string record_file; // Record frames + graph outputs to a session file
+    std::string replay_file; // Replay a session instead of camera + graph (implies headless)
     
     // Static factory method for command line parsing
     static ApplicationConfig FromCommandLine(int argc, char** argv);
@@ -33,8 +33,8 @@ public:
      * @param mask_poller Output stream poller to create
      * @param multi_face_landmarks_poller Face landmarks poller to create
      * @param face_rects_poller Face rects poller to create  
-     * @param window SDL window to create
-     * @param gl_context SDL OpenGL context to create
+     * @param window SDL window to create (left null in headless mode)
+     * @param gl_context SDL OpenGL context to create (left null in headless mode)
      * @param gpu_setup_state GPU setup state to populate
      * @return 0 for success, negative error code for failure
      */
@@ -79,10 +79,14 @@ private:
     
     /**
      * Initialize all Phase 1-7 managers
+     * @param profile_name Settings profile to apply (empty = default profile)
+     * @param camera_optional Tolerate a missing camera (session replay)
      */
     static int InitializeManagers(
         ManagerCoordination::Managers& managers,
-        AppState& app_state
+        AppState& app_state,
+        const std::string& profile_name,
+        bool camera_optional
     );
 };
 
@@ -2,22 +2,29 @@
 #define APPLICATION_RUN_H
 
 #include <memory>
+#include <mutex>
 #include <opencv2/opencv.hpp>
 #include <SDL.h>
 #include <GL/gl.h>
 #include "application/manager_coordination.h"
 #include "app_state.h"
+#include "pipeline/frame_synchronizer.h"
+#include "pipeline/mask_decoder.h"
 
 // Forward declarations
 namespace segmecam {
     class UIManager;
     class EffectsManager;
+    struct EffectsState;
+    class FramePool;
+    class SessionReplaySource;
 }
 
 // MediaPipe includes for complete types
 #include "mediapipe/framework/calculator_graph.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/output_stream_poller.h"
+#include "mediapipe/framework/formats/landmark.pb.h"
 
 namespace segmecam {
 
@@ -51,21 +58,117 @@ public:
         AppState& app_state
     );
 
+    /**
+     * Execute the staged, multi-threaded application loop
+     *
+     * Capture, effects and virtual camera output each run on their own thread
+     * and hand frames over through bounded lock-free queues that drop the
+     * oldest frame when full, so a slow stage never stalls the one in front
+     * of it. Rendering and UI stay on the calling (GL) thread.
+     * Parameters are identical to ExecuteMainLoop.
+     * @return Exit code (0 for success, non-zero for error)
+     */
+    static int ExecutePipelinedLoop(
+        ManagerCoordination::Managers& managers,
+        std::unique_ptr<mediapipe::CalculatorGraph>& mediapipe_graph,
+        std::unique_ptr<mediapipe::OutputStreamPoller>& mask_poller,
+        std::unique_ptr<mediapipe::OutputStreamPoller>& multi_face_landmarks_poller,
+        std::unique_ptr<mediapipe::OutputStreamPoller>& face_rects_poller,
+        SDL_Window* window,
+        AppState& app_state
+    );
+
+    /**
+     * Execute the headless loop (no SDL window, OpenGL or ImGui)
+     *
+     * Drives capture -> MediaPipe -> EffectsManager -> virtual camera using the
+     * settings already applied from the startup profile, writing to
+     * app_state.virtual_camera_path. Runs until SIGINT/SIGTERM.
+     * @param replay Optional recorded session used instead of camera + graph
+     *               (graph and pollers may then be null); ends with the session
+     * @return Exit code (0 for success, non-zero for error)
+     */
+    static int ExecuteHeadlessLoop(
+        ManagerCoordination::Managers& managers,
+        std::unique_ptr<mediapipe::CalculatorGraph>& mediapipe_graph,
+        std::unique_ptr<mediapipe::OutputStreamPoller>& mask_poller,
+        std::unique_ptr<mediapipe::OutputStreamPoller>& multi_face_landmarks_poller,
+        std::unique_ptr<mediapipe::OutputStreamPoller>& face_rects_poller,
+        AppState& app_state,
+        SessionReplaySource* replay = nullptr
+    );
+
     /**
      * Sync status FROM EffectsManager back TO app_state (e.g., OpenCL availability)
      */
     static void SyncStatusFromEffectsManager(const EffectsManager& effects_manager, AppState& app_state);
+    static void SyncStatusFromEffectsManager(const EffectsState& effects_state, AppState& app_state);
 
     /**
-     * Sync app_state settings to EffectsManager
+     * Publish app_state effect settings to EffectsManager as a versioned snapshot
+     * (no-op when nothing changed; applied by EffectsManager on its next frame)
      */
-    static void SyncSettingsToEffectsManager(EffectsManager& effects_manager, const AppState& app_state);
+    static void PublishEffectsSettings(EffectsManager& effects_manager, const AppState& app_state);
 
 private:
     /**
-     * Helper function to convert MediaPipe ImageFrame to OpenCV Mat
+     * Shared state of the pipelined loop (queues, locks, stop flag)
+     */
+    struct PipelineContext;
+
+    /**
+     * Pipeline stage bodies, each run on a dedicated thread
+     */
+    static void RunCaptureStage(PipelineContext& ctx);
+    static void RunEffectsStage(PipelineContext& ctx);
+    static void RunVCamStage(PipelineContext& ctx);
+
+    /**
+     * Drain the segmentation mask poller (non-blocking) into the synchronizer
+     * @param mask_decoder Per-stream decoder (keeps the SRGBA channel choice)
+     * @return true if at least one new mask was decoded
+     */
+    static bool PollSegmentationMask(mediapipe::OutputStreamPoller* mask_poller,
+                                     MaskDecoder& mask_decoder,
+                                     FrameSynchronizer& frame_sync, FramePool* pool,
+                                     bool verbose);
+
+    /**
+     * Drain the face landmarks/rects pollers (non-blocking) into the synchronizer
+     * @return true if landmarks for at least one face were received
+     */
+    static bool PollFaceLandmarks(mediapipe::OutputStreamPoller* landmarks_poller,
+                                  mediapipe::OutputStreamPoller* rects_poller,
+                                  FrameSynchronizer& frame_sync,
+                                  bool verbose);
+
+    /**
+     * Run EffectsManager on a frame matched with its mask/landmarks
+     * @return Processed frame in RGB (display format)
+     */
+    static cv::Mat ProcessFusedFrame(ManagerCoordination::Managers& managers,
+                                     const FusedFrame& fused);
+
+    /**
+     * Write an RGB frame to the virtual camera, reopening it on size change
+     * @param camera_mutex Held while reading the loopback list, if given
+     */
+    static void WriteToVirtualCamera(ManagerCoordination::Managers& managers,
+                                     AppState& app_state,
+                                     const cv::Mat& display_rgb,
+                                     std::mutex* camera_mutex = nullptr);
+
+    /**
+     * Load dropped image files as background (switches to Image mode)
+     */
+    static void HandleDroppedFiles(UIManager& ui_manager, AppState& app_state);
+
+    /**
+     * Convert a BGR Mat to an SRGB ImageFrame for the graph
+     * @param pool Optional buffer pool; the ImageFrame then owns a pooled lease
      */
-    static void MatToImageFrame(const cv::Mat& mat_bgr, std::unique_ptr<mediapipe::ImageFrame>& frame);
+    static void MatToImageFrame(const cv::Mat& mat_bgr, std::unique_ptr<mediapipe::ImageFrame>& frame,
+                                FramePool* pool = nullptr);
     
     /**
      * Process SDL events and handle ImGui integration
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <iostream>
+#include <string>
 #include "src/config/config_manager.h"  // Include for complete type
 
 // Forward declare segmecam::AppState to avoid circular dependencies  
@@ -45,15 +46,22 @@ public:
         Managers& operator=(const Managers&) = delete;
     };
     
-    static bool SetupManagers(Managers& managers, segmecam::AppState& app_state);
+    // profile_name selects the settings profile; empty uses the default profile.
+    // camera_optional: continue without a CameraManager (session replay)
+    static bool SetupManagers(Managers& managers, segmecam::AppState& app_state,
+                              const std::string& profile_name = "", bool camera_optional = false);
     static void ShutdownManagers(Managers& managers);
     static bool ValidateManagers(const Managers& managers);
     
-    // Post-initialization step to load default profile's background image
-    static void LoadDefaultProfileBackgroundImage(Managers& managers, segmecam::AppState& app_state);
+    // Post-initialization step to load the profile's background image
+    static void LoadDefaultProfileBackgroundImage(Managers& managers, segmecam::AppState& app_state,
+                                                  const std::string& profile_name = "");
     
 private:
-    static bool InitializeConfigManager(Managers& managers, segmecam::AppState& app_state);
+    // Explicit profile if given, otherwise the configured default profile
+    static bool ResolveProfileName(const Managers& managers, const std::string& requested, std::string& name);
+    static bool InitializeConfigManager(Managers& managers, segmecam::AppState& app_state,
+                                        const std::string& profile_name);
     static bool InitializeCameraManager(Managers& managers, segmecam::AppState& app_state);
     static bool InitializeEffectsManager(Managers& managers, segmecam::AppState& app_state);
 };
@@ -3,6 +3,10 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <opencv2/opencv.hpp>
 #include <linux/videodev2.h>
 #include "cam_enum.h"
@@ -19,6 +23,11 @@ struct CameraConfig {
     bool enable_auto_focus = true;
     bool enable_auto_gain = true;
     bool enable_auto_exposure = true;
+    
+    // Asynchronous capture: a camera-owned thread dequeues/decodes frames
+    // into a preallocated pool and publishes the newest one via a mailbox
+    bool async_capture = false;
+    int capture_pool_size = 4;
 };
 
 // State tracking for camera system
@@ -60,7 +69,20 @@ public:
     bool IsOpened() const;
     
     // Frame capture
-    bool CaptureFrame(cv::Mat& frame);
+    // In async mode this returns the newest frame not returned before, waiting
+    // at most ~2 frame intervals. The frame shares a pool buffer: treat it as
+    // read-only (the pool only reuses buffers nobody references anymore).
+    bool CaptureFrame(cv::Mat& frame, uint64_t* sequence = nullptr);
+    
+    // Asynchronous capture control (restarted automatically on reopen)
+    void SetAsyncCapture(bool enabled);
+    // Grow the capture pool to at least buffers; a consumer that holds on to
+    // frames (e.g. a FrameSynchronizer) pins one buffer per frame it keeps
+    void SetMinCapturePoolSize(int buffers);
+    bool IsAsyncCaptureEnabled() const { return async_enabled_.load(); }
+    bool IsAsyncCaptureRunning() const { return async_running_.load(); }
+    uint64_t GetLatestFrameSequence() const;
+    uint64_t GetDroppedFrameCount() const { return frames_dropped_.load(); }
     
     // Camera enumeration and selection
     const std::vector<CameraDesc>& GetCameraList() const { return cam_list_; }
@@ -149,6 +171,20 @@ private:
     // OpenCV capture
     cv::VideoCapture cap_;
     
+    // Async capture thread and latest-frame mailbox
+    std::thread capture_thread_;
+    std::atomic<bool> async_enabled_{false};
+    std::atomic<bool> async_running_{false};
+    std::atomic<bool> capture_stop_{false};
+    std::atomic<uint64_t> frames_dropped_{0};
+    mutable std::mutex mailbox_mutex_;
+    std::condition_variable mailbox_cv_;
+    std::vector<cv::Mat> capture_pool_;   // Guarded by mailbox_mutex_ (slot selection)
+    int mailbox_slot_ = -1;               // Pool index of the newest frame
+    uint64_t mailbox_seq_ = 0;            // Sequence of the newest frame
+    uint64_t consumed_seq_ = 0;           // Last sequence handed out by CaptureFrame
+    int capture_wait_ms_ = 100;
+    
     // V4L2 control ranges
     CtrlRange r_brightness_, r_contrast_, r_saturation_, r_gain_;
     CtrlRange r_sharpness_, r_zoom_, r_focus_;
@@ -173,6 +209,12 @@ private:
     bool SetCtrl(const std::string& cam_path, uint32_t id, int32_t value);
     bool GetCtrl(const std::string& cam_path, uint32_t id, int32_t* value);
     void UpdateFPSOptions(const std::string& cam_path, int width, int height);
+    
+    // Async capture helpers
+    bool StartAsyncCapture();
+    void StopAsyncCapture();
+    void CaptureThreadLoop();
+    int AcquireFreePoolSlot();
 
 #ifdef FLATPAK_BUILD
     // PipeWire/GStreamer specific methods
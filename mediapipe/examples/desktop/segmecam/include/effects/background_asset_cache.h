@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace segmecam {
+
+struct BackgroundAssetCacheStats {
+    uint64_t lookups = 0;
+    uint64_t rebuilds = 0;   // Plates resized from the source image
+};
+
+// Background image plates prescaled to the resolutions the compositor asks
+// for (output size, and the reduced processing-scale size when in use).
+//
+// Keyed by a content generation, which the owner bumps whenever the image
+// itself changes, and by target size; never by buffer address, so handing in
+// a different Mat header or a copy of the same image still hits. A new
+// generation drops every plate of the old one. Not thread-safe: used from
+// the processing thread only.
+class BackgroundAssetCache {
+public:
+    // Plate of image at size (BGR 8UC3). Valid until the next Get()/Clear().
+    const cv::Mat& Get(const cv::Mat& image, uint64_t generation, const cv::Size& size);
+
+    void Clear() { plates_.clear(); }
+    const BackgroundAssetCacheStats& GetStats() const { return stats_; }
+
+private:
+    struct Plate {
+        uint64_t generation = 0;
+        cv::Size size;
+        cv::Mat bgr;
+        uint64_t last_used = 0;
+    };
+    static constexpr size_t kMaxPlates = 3;  // Output size + processing-scale sizes in flight
+
+    std::vector<Plate> plates_;
+    uint64_t clock_ = 0;
+    BackgroundAssetCacheStats stats_;
+};
+
+} // namespace segmecam
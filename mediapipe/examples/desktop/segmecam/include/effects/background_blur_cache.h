@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "include/pipeline/frame_pool.h"
+
+namespace segmecam {
+
+struct BackgroundBlurCacheStats {
+    uint64_t frames = 0;          // Update() calls that went through the cache
+    uint64_t tiles_total = 0;     // Tiles covered by those frames
+    uint64_t tiles_reused = 0;    // Tiles served from the previous plate
+    uint64_t full_refreshes = 0;  // Whole-plate recomputes (first frame, settings change, periodic)
+
+    double HitRate() const { return tiles_total ? (double)tiles_reused / (double)tiles_total : 0.0; }
+};
+
+// Temporal reuse of the blurred background plate for bg_mode 1.
+//
+// Keeps the last plate plus a 1/4-scale reference of the frame and mask each
+// tile was computed from. Per frame, a tile is stale when the mean absolute
+// difference of its downscaled luma or the peak change of its mask exceeds a
+// threshold; stale tiles are grown by the blur radius (a change moves the
+// blur that far) and recomputed as rectangles (runs of dirty tiles stacked
+// with the same extent) on a margin-padded ROI, so the result matches a full
+// recompute. Everything else is reused. When more than
+// full_refresh_dirty_ratio of the tiles are dirty, or every
+// full_refresh_interval frames, the whole plate is redone instead.
+//
+// Used with the Gaussian and box engines; the pyramid engine is global by
+// construction and always recomputes the whole plate.
+class BackgroundBlurCache {
+public:
+    struct Config {
+        int tile_size = 64;                 // Full-resolution pixels
+        float luma_sad_threshold = 4.0f;    // Mean |diff| per tile, 0..255 (above sensor noise)
+        int mask_threshold = 24;            // Peak |diff| of the mask per tile, 0..255
+        int full_refresh_interval = 150;    // Frames (~5 s at 30 fps)
+        float full_refresh_dirty_ratio = 0.4f;  // Dirty tile share above which the whole plate is redone
+    };
+
+    BackgroundBlurCache() = default;
+    explicit BackgroundBlurCache(const Config& config) : config_(config) {}
+
+    // Blurred background plate (BGR) for this frame; mask_u8 is the
+    // feathered blend mask. The returned Mat is owned by the cache and stays
+    // valid until the next Update()/Reset().
+    const cv::Mat& Update(const cv::Mat& frame_bgr, const cv::Mat& mask_u8,
+                          int blur_strength, int engine, FramePool* pool);
+
+    void Reset();
+    const BackgroundBlurCacheStats& GetStats() const { return stats_; }
+    void ResetStats() { stats_ = BackgroundBlurCacheStats{}; }
+
+private:
+    void FullRefresh(const cv::Mat& frame_bgr, const cv::Mat& mask_u8, FramePool* pool);
+    void Downscale(const cv::Mat& frame_bgr, const cv::Mat& mask_u8, cv::Mat& luma, cv::Mat& mask);
+
+    Config config_;
+    BackgroundBlurCacheStats stats_;
+
+    cv::Mat plate_;                 // Blurred background, frame size
+    cv::Mat ref_luma_, ref_mask_;   // Downscaled inputs each tile's plate came from
+    cv::Mat cur_luma_, cur_mask_;   // This frame, downscaled (reused buffers)
+    cv::Mat small_bgr_;
+    std::vector<uint8_t> stale_, dirty_;
+    std::vector<cv::Rect> regions_;  // Dirty tile rectangles (tile units)
+    int blur_strength_ = -1;
+    int engine_ = -1;
+    int frames_since_refresh_ = 0;
+};
+
+} // namespace segmecam
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include "include/pipeline/bounded_queue.h"
+
+namespace segmecam {
+
+struct BackgroundVideoStats {
+    uint64_t frames_decoded = 0;  // Plates produced by the decode thread
+    uint64_t frames_shown = 0;    // Distinct plates handed to the compositor
+    uint64_t underruns = 0;       // Frames that repeated a plate because the next one was late
+    bool in_memory = false;       // Playing a preloaded loop
+};
+
+// Looping video background (bg_mode 4).
+//
+// A decode thread owns the cv::VideoCapture and turns frames into BGR plates
+// at the size the compositor works at (colour-converted and resized there),
+// queued in a small bounded ring. Frame() only takes plates that are due on
+// the video's own clock and otherwise keeps returning the current one: it
+// never waits for the decoder, so a slow decode repeats a background frame
+// instead of delaying the camera frame.
+//
+// With preload, a clip that fits kPreloadBudgetBytes is decoded once into
+// memory at the output size and then played from there without any further
+// decoding; the compositor resizes it to its working size, so processing
+// scale changes never reload the clip (output size changes do). Longer clips
+// fall back to streaming.
+class BackgroundVideoSource {
+public:
+    BackgroundVideoSource() = default;
+    ~BackgroundVideoSource();
+
+    BackgroundVideoSource(const BackgroundVideoSource&) = delete;
+    BackgroundVideoSource& operator=(const BackgroundVideoSource&) = delete;
+
+    // Start playing path (opened on the decode thread), replacing any open video
+    void Open(const std::string& path, bool preload);
+
+    // Stop the decode thread; waits for at most the frame being decoded
+    void Close();
+
+    // Decoding or about to; false once the decode thread gave up
+    bool IsOpen() const { return decode_thread_.joinable() && !failed_.load(); }
+    // The file could not be opened or stopped decoding; Close() joins the
+    // finished decode thread so that Open() can retry
+    bool Failed() const { return failed_.load(); }
+    const std::string& Path() const { return path_; }
+    bool Preload() const { return preload_; }
+
+    // Plate to show now (BGR 8UC3, read-only): of output_size when preloaded,
+    // otherwise ideally of working_size; plates decoded for an earlier size
+    // are returned until new ones arrive. Empty until the first frame is
+    // decoded. Processing thread only.
+    cv::Mat Frame(const cv::Size& output_size, const cv::Size& working_size);
+
+    BackgroundVideoStats GetStats() const;
+
+private:
+    struct Plate {
+        cv::Mat bgr;
+        double pts_ms = 0.0;     // On the video's clock, increasing across loops
+        double frame_ms = 0.0;
+    };
+    struct Loop {
+        std::vector<cv::Mat> frames;
+        cv::Size size;
+        double frame_ms = 0.0;
+    };
+    static constexpr size_t kRingFrames = 8;
+    static constexpr size_t kPreloadBudgetBytes = size_t(256) << 20;
+    static constexpr double kMaxLagMs = 250.0;  // Re-anchor the clock after a decoder stall
+
+    void DecodeThreadLoop(std::string path, bool preload);
+    bool DecodeIntoMemory(cv::VideoCapture& cap, const std::string& path,
+                          const cv::Size& size, double frame_ms);
+    cv::Size LoopSize() const;
+    cv::Size StreamSize() const;
+
+    std::string path_;
+    bool preload_ = false;
+    std::thread decode_thread_;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> failed_{false};
+    // width << 32 | height, set by Frame()
+    std::atomic<uint64_t> loop_size_{0};    // Preloaded loop: output size
+    std::atomic<uint64_t> stream_size_{0};  // Streamed plates: working size
+    std::atomic<uint64_t> frames_decoded_{0};
+    BoundedQueue<Plate> ring_{kRingFrames};
+
+    // Preloaded clip, published by the decode thread
+    mutable std::mutex loop_mutex_;
+    std::shared_ptr<const Loop> published_loop_;
+    std::atomic<uint64_t> loop_version_{0};
+
+    // Playback state (processing thread)
+    std::shared_ptr<const Loop> loop_;
+    uint64_t loop_version_seen_ = 0;
+    Plate pending_;   // Taken from the ring but not due yet
+    cv::Mat current_;
+    double current_pts_ms_ = 0.0;
+    double current_frame_ms_ = 0.0;
+    bool playing_ = false;
+    std::chrono::steady_clock::time_point play_start_;
+    uint64_t frames_shown_ = 0;
+    uint64_t underruns_ = 0;
+};
+
+} // namespace segmecam
@@ -7,6 +7,12 @@
 #include "segmecam_face_effects.h"
 #include "segmecam_composite.h"
 #include "presets.h"
+#include "include/effects/effects_settings.h"
+#include "include/pipeline/frame_pool.h"
+#include "include/effects/background_asset_cache.h"
+#include "include/effects/background_blur_cache.h"
+#include "include/effects/background_video_source.h"
+#include "include/effects/face_geometry_cache.h"
 
 namespace segmecam {
 
@@ -18,6 +24,7 @@ struct EffectsConfig {
     float default_processing_scale = 1.0f;
     bool enable_performance_logging = false;
     int performance_log_interval_ms = 5000;
+    bool enable_background_blur_cache = true; // Reuse unchanged tiles of the blurred background
 };
 
 // State tracking for effects system
@@ -36,6 +43,9 @@ struct EffectsState {
     double total_processing_time_ms = 0.0;
     int frames_processed = 0;
     
+    // Frame buffer pool: allocations made during the last processed frame (0 = steady state)
+    uint64_t last_frame_pool_allocations = 0;
+    
     // Debug state
     bool show_mask = false;
     bool show_landmarks = false;
@@ -64,12 +74,17 @@ public:
     
     // Face effects
     void ApplyFaceEffects(cv::Mat& frame_bgr, const mediapipe::NormalizedLandmarkList& landmarks);
-    void ApplySkinSmoothing(cv::Mat& frame_bgr, const FaceRegions& regions);
-    void ApplySkinSmoothingAdvanced(cv::Mat& frame_bgr, const FaceRegions& regions, 
-                                   const mediapipe::NormalizedLandmarkList& landmarks);
-    void ApplyLipEffects(cv::Mat& frame_bgr, const FaceRegions& regions, 
-                        const mediapipe::NormalizedLandmarkList& landmarks, const cv::Size& frame_size);
-    void ApplyTeethWhitening(cv::Mat& frame_bgr, const FaceRegions& regions);
+    void ApplySkinSmoothing(FaceEffectsContext& ctx);
+    void ApplySkinSmoothingAdvanced(FaceEffectsContext& ctx, const mediapipe::NormalizedLandmarkList& landmarks);
+    void ApplyLipEffects(FaceEffectsContext& ctx, const mediapipe::NormalizedLandmarkList& landmarks);
+    void ApplyTeethWhitening(FaceEffectsContext& ctx);
+    int FaceEffectsPad() const;  // Largest reach of the enabled face effects
+    
+    // Settings snapshot handoff: the UI publishes immutable snapshots from any
+    // thread; ProcessFrame applies the newest one only when its version changed
+    void PublishSettings(std::shared_ptr<const EffectsSettings> settings);
+    std::shared_ptr<const EffectsSettings> GetPublishedSettings() const { return settings_mailbox_.Load(); }
+    uint64_t GetAppliedSettingsVersion() const { return applied_settings_version_; }
     
     // Beauty presets
     void ApplyBeautyPreset(int preset_index);
@@ -77,11 +92,15 @@ public:
     void SetBeautyState(const BeautyState& state);
     
     // Background settings
-    void SetBackgroundMode(int mode); // 0=None, 1=Blur, 2=Image, 3=Solid
+    void SetBackgroundMode(int mode); // 0=None, 1=Blur, 2=Image, 3=Solid, 4=Video
     void SetBlurStrength(int strength);
+    void SetBlurBackend(int backend); // 0=Gaussian, 1=Box (constant time), 2=Pyramid (push-pull)
+    void SetMaskUpsampler(int upsampler); // 0=Bilinear, 1=Guided (edge-aware, frame as guide)
+    void SetBackgroundBlurCacheEnabled(bool enabled);
     void SetFeatherAmount(float feather_px);
     void SetBackgroundImage(const cv::Mat& image);
     void SetBackgroundImageFromPath(const std::string& path);
+    void SetBackgroundVideo(const std::string& path, bool preload); // Decoded only while bg_mode is 4
     void SetSolidBackgroundColor(float r, float g, float b);
     void SetShowMask(bool enabled);
     
@@ -162,6 +181,13 @@ public:
     const EffectsState& GetState() const { return state_; }
     const EffectsConfig& GetConfig() const { return config_; }
     
+    // Pooled per-frame buffers (shared with graph input conversion / mask decoding)
+    FramePool& GetFramePool() { return frame_pool_; }
+    const BackgroundBlurCacheStats& GetBackgroundBlurCacheStats() const { return blur_cache_.GetStats(); }
+    const BackgroundAssetCacheStats& GetBackgroundAssetCacheStats() const { return bg_asset_cache_.GetStats(); }
+    BackgroundVideoStats GetBackgroundVideoStats() const { return bg_video_.GetStats(); }
+    const FaceGeometryCacheStats& GetFaceGeometryCacheStats() const { return face_geometry_cache_.GetStats(); }
+    
     // Background image management
     bool LoadBackgroundImage(const std::string& path);
     void ClearBackgroundImage();
@@ -173,8 +199,30 @@ private:
     EffectsState state_;
     BeautyState beauty_state_;
     
-    // Background image storage
+    // Background image storage; the content id changes whenever the image
+    // does and keys the prescaled plates in bg_asset_cache_
     cv::Mat background_image_;
+    uint64_t background_content_id_ = 0;
+    BackgroundAssetCache bg_asset_cache_;
+    
+    // Video background (bg_mode 4): plates come from its decode thread
+    std::string background_video_path_;
+    bool background_video_preload_ = true;
+    BackgroundVideoSource bg_video_;
+    
+    // Reused intermediate/output buffers; results returned by ProcessFrame are leases
+    FramePool frame_pool_;
+    
+    // Blurred background plate kept across frames (bg_mode 1)
+    BackgroundBlurCache blur_cache_;
+    
+    // Skin mask and edge weight kept across frames (advanced skin smoothing)
+    FaceGeometryCache face_geometry_cache_;
+    
+    // Newest published settings and what the processing side has applied
+    EffectsSettingsMailbox settings_mailbox_;
+    uint64_t applied_settings_version_ = 0;
+    uint64_t applied_background_generation_ = 0;
     
     // Performance tracking
     std::chrono::steady_clock::time_point last_perf_log_time_;
@@ -199,6 +247,9 @@ private:
     cv::Scalar ConvertRGBColorToBGR(float r, float g, float b);
     void LogPerformanceStats();
     bool ShouldLogPerformance();
+    void ApplyPendingSettings();
+    void ApplySettings(const EffectsSettings& settings);
+    void UpdateBackgroundVideo();
     
     // Processing scale optimization for skin smoothing
     void ApplySkinSmoothingWithProcessingScale(cv::Mat& frame_bgr, const FaceRegions& regions, 
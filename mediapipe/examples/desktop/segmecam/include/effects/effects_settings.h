@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <opencv2/core.hpp>
+#include "presets.h"
+
+namespace segmecam {
+
+// Immutable snapshot of the user-controlled effect settings.
+// Built by the UI side and handed to EffectsManager as a whole; never
+// modified after publication, so any thread may read a snapshot it holds.
+struct EffectsSettings {
+    uint64_t version = 0;               // Strictly increasing per published snapshot
+    BeautyState beauty;                 // Background + beauty parameters
+    bool show_landmarks = false;
+
+    // Background image (BGR). Shared with the UI copy, never cloned per frame;
+    // the buffer is replaced (not written to) when the user picks a new image.
+    std::shared_ptr<const cv::Mat> background_image;
+    uint64_t background_generation = 0; // Changes only when the image changes
+
+    // Video background (bg_mode 4); decoded by the effects side
+    std::string background_video_path;
+    bool background_video_preload = true;
+};
+
+// Single-slot mailbox for the newest settings snapshot.
+//
+// The version is published through an atomic so consumers can check for a
+// new snapshot every frame without locking; the pointer swap itself is
+// guarded by a mutex held only for a shared_ptr copy.
+class EffectsSettingsMailbox {
+public:
+    void Publish(std::shared_ptr<const EffectsSettings> settings) {
+        uint64_t version = settings ? settings->version : 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            current_ = std::move(settings);
+        }
+        version_.store(version, std::memory_order_release);
+    }
+
+    std::shared_ptr<const EffectsSettings> Load() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return current_;
+    }
+
+    uint64_t Version() const { return version_.load(std::memory_order_acquire); }
+
+private:
+    mutable std::mutex mutex_;
+    std::shared_ptr<const EffectsSettings> current_;
+    std::atomic<uint64_t> version_{0};
+};
+
+} // namespace segmecam
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "mediapipe/framework/formats/landmark.pb.h"
+#include "segmecam_face_effects.h"
+
+namespace segmecam {
+
+struct FaceGeometryCacheStats {
+    uint64_t frames = 0;   // Apply() calls
+    uint64_t reused = 0;   // Landmarks within kReuseMaxPx: maps taken as they are
+    uint64_t warped = 0;   // Small rigid motion: maps warped by a similarity transform
+    uint64_t rebuilt = 0;  // Maps recomputed from the face polygons
+
+    double HitRate() const { return frames ? (double)(reused + warped) / (double)frames : 0.0; }
+};
+
+// Skin mask and edge-feather weight (the distance-transform part of the skin
+// weight map) carried across frames for the advanced skin smoothing.
+//
+// Both depend only on face geometry, so they are keyed by the landmark pixel
+// positions in the context's frame rather than by the integer polygons. Per
+// frame, with d the largest landmark displacement since the maps were built:
+// below kReuseMaxPx the maps are reused as they are; up to kWarpMaxPx a
+// least-squares similarity transform (scale, rotation, translation) is fitted
+// to the landmarks and, if no landmark is off it by more than
+// kWarpResidualMaxPx, the maps are warped with it; anything else (expression
+// change, head turn, fast motion) rebuilds them. Warps always start from the
+// maps of the last rebuild, so their error does not accumulate.
+//
+// The texture term of the weight map follows the pixels and is still computed
+// every frame. Not thread-safe: used from the processing thread only.
+class FaceGeometryCache {
+public:
+    // Install the skin mask and edge weight for edge_feather_px into ctx,
+    // from the cache or freshly built. lms are normalized to ctx's frame.
+    void Apply(FaceEffectsContext& ctx, const mediapipe::NormalizedLandmarkList& lms,
+               float edge_feather_px);
+
+    void Reset();
+    const FaceGeometryCacheStats& GetStats() const { return stats_; }
+    void ResetStats() { stats_ = FaceGeometryCacheStats{}; }
+
+private:
+    static constexpr double kReuseMaxPx = 0.5;
+    static constexpr double kWarpMaxPx = 6.0;
+    static constexpr double kWarpResidualMaxPx = 1.0;
+
+    void Rebuild(FaceEffectsContext& ctx, float edge_feather_px);
+
+    // State of the last rebuild
+    bool valid_ = false;
+    float edge_feather_px_ = 0.0f;
+    cv::Rect box_;                       // Frame coordinates the maps cover
+    std::vector<cv::Point2f> points_;    // Landmark pixel positions
+    cv::Mat skin_mask_;                  // 8U, box_-sized
+    cv::Mat edge_weight_;                // 32F, box_-sized
+
+    std::vector<cv::Point2f> current_;   // Scratch: this frame's positions
+    FaceGeometryCacheStats stats_;
+};
+
+} // namespace segmecam
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace segmecam {
+
+// Bounded lock-free queue used to connect pipeline stages.
+//
+// Based on Dmitry Vyukov's bounded MPMC ring: every cell carries a sequence
+// number, so producers and consumers only contend on a single atomic each.
+// Because any thread may pop, a producer can implement drop-oldest by popping
+// the head itself when the ring is full, which keeps the queue non-blocking
+// for real-time video: a slow consumer loses stale frames instead of stalling
+// the stage in front of it.
+//
+// Capacity is rounded up to the next power of two (minimum 2).
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+        buffer_ = std::make_unique<Cell[]>(cap);
+        for (size_t i = 0; i < cap; ++i) {
+            buffer_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos_.store(0, std::memory_order_relaxed);
+        dequeue_pos_.store(0, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Push if there is room. On failure the value is left untouched.
+    bool TryPush(T&& value) {
+        Cell* cell = nullptr;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &buffer_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false; // Full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pop the oldest element if any. The cell is left moved-from so the queue
+    // never keeps large buffers (frames) alive after they were consumed.
+    bool TryPop(T& out) {
+        Cell* cell = nullptr;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &buffer_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (dif == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false; // Empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->data);
+        cell->data = T{};
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Drop-oldest policy: always enqueue, evicting the oldest elements while
+    // the ring is full. Returns the number of elements dropped by this call.
+    size_t PushDropOldest(T&& value) {
+        size_t dropped = 0;
+        while (!TryPush(std::move(value))) {
+            T discarded;
+            if (TryPop(discarded)) {
+                ++dropped;
+            }
+        }
+        if (dropped > 0) {
+            dropped_total_.fetch_add(dropped, std::memory_order_relaxed);
+        }
+        return dropped;
+    }
+
+    size_t Capacity() const { return mask_ + 1; }
+
+    // Approximate number of queued elements (exact only when quiescent).
+    size_t SizeApprox() const {
+        size_t enq = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t deq = dequeue_pos_.load(std::memory_order_relaxed);
+        return enq >= deq ? enq - deq : 0;
+    }
+
+    uint64_t DroppedCount() const { return dropped_total_.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T data{};
+    };
+
+    std::unique_ptr<Cell[]> buffer_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+    alignas(64) std::atomic<uint64_t> dropped_total_{0};
+};
+
+} // namespace segmecam
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace segmecam {
+
+// Counters for verifying steady-state behaviour
+struct FramePoolStats {
+    uint64_t acquisitions = 0;   // Acquire() calls
+    uint64_t allocations = 0;    // New buffers allocated (pooled or overflow)
+    uint64_t overflows = 0;      // Allocations that could not be pooled (slab full)
+    size_t pooled_buffers = 0;   // Buffers currently owned by the pool
+    size_t pooled_bytes = 0;
+};
+
+// Reusable image buffer pool: a slab of cv::Mat per (rows, cols, type).
+//
+// A lease is simply a cv::Mat sharing a pooled buffer; cv::Mat's own
+// reference count tracks it. A buffer is handed out again once only the
+// pool references it, so callers release a lease by dropping their Mat
+// (they must not call create()/release() expecting to keep the buffer).
+// OpenCV functions writing into a leased Mat of the right size/type reuse
+// its memory, which is what makes the steady state allocation-free.
+// Thread-safe.
+class FramePool {
+public:
+    explicit FramePool(size_t max_buffers_per_key = 16);
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // Lease a buffer; contents are undefined
+    cv::Mat Acquire(int rows, int cols, int type);
+    cv::Mat Acquire(const cv::Size& size, int type) { return Acquire(size.height, size.width, type); }
+
+    // Call once per processed frame; slabs unused for a while (e.g. after a
+    // resolution or processing-scale change) give their free buffers back
+    void BeginFrame();
+
+    // Release every buffer that is not currently leased
+    void Trim();
+
+    uint64_t AllocationCount() const;
+    FramePoolStats GetStats() const;
+
+private:
+    struct Slab {
+        std::vector<cv::Mat> buffers;
+        uint64_t last_used_frame = 0;
+    };
+
+    static uint64_t MakeKey(int rows, int cols, int type);
+    static bool IsFree(const cv::Mat& buf);
+    void ReleaseFreeBuffers(Slab& slab);  // Caller holds mutex_
+
+    size_t max_buffers_per_key_;
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, Slab> slabs_;
+    uint64_t frame_counter_ = 0;
+    FramePoolStats stats_;
+};
+
+// Lease from pool when available, plain allocation otherwise
+inline cv::Mat AcquireFrame(FramePool* pool, const cv::Size& size, int type) {
+    return pool ? pool->Acquire(size, type) : cv::Mat(size, type);
+}
+
+} // namespace segmecam
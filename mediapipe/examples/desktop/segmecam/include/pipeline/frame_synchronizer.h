@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <opencv2/opencv.hpp>
+#include "mediapipe/framework/timestamp.h"
+#include "mediapipe/framework/formats/landmark.pb.h"
+
+namespace segmecam {
+
+class SessionRecorder;
+
+// How a submitted frame is paired with graph outputs
+enum class FusionPolicy {
+    kWaitForMatch = 0,  // Hold the frame until its own mask (and landmarks) arrive
+    kUseLatest = 1,     // Release the newest frame with the newest outputs (lowest latency)
+    kExtrapolate = 2,   // Like kUseLatest, but predict landmarks/mask motion up to the frame
+};
+
+// Configuration for frame/mask/landmark fusion
+struct FrameSyncConfig {
+    FusionPolicy policy = FusionPolicy::kWaitForMatch;
+    bool expect_landmarks = false;   // Graph produces multi_face_landmarks
+    size_t max_pending_frames = 6;   // Ring capacity, oldest frame is dropped when full
+    int max_wait_ms = 100;           // kWaitForMatch: release with latest outputs after this
+    int landmark_grace_ms = 15;      // Extra wait for landmarks once the mask matched (no face => no packet)
+};
+
+// Counters for the debug panel / logs
+struct FrameSyncStats {
+    uint64_t released = 0;
+    uint64_t exact_matches = 0;      // Mask timestamp == frame timestamp
+    uint64_t fallbacks = 0;          // Released after max_wait_ms with older outputs
+    uint64_t extrapolated = 0;       // kExtrapolate produced a predicted mask/landmarks
+    uint64_t dropped_frames = 0;     // Ring overflow or frame dropped by the graph
+    uint64_t superseded_frames = 0;  // Skipped in favour of a newer ready frame
+};
+
+// Frame matched with the segmentation mask and landmarks that belong to it
+struct FusedFrame {
+    mediapipe::Timestamp timestamp;
+    cv::Mat frame_bgr;
+    cv::Mat mask_u8;                                  // Empty until the first mask arrives
+    mediapipe::NormalizedLandmarkList landmarks;
+    bool has_landmarks = false;
+    bool exact_mask = false;                          // mask_u8 was computed from frame_bgr
+};
+
+// Small ring of submitted frames keyed by mediapipe::Timestamp.
+//
+// Frames are held until the graph outputs for the same timestamp arrive and
+// are then released together, so effects composite a frame with its own mask
+// instead of one from an older frame. MediaPipe emits packets on every stream
+// in timestamp order, which lets the synchronizer infer that a frame was
+// dropped by the graph (flow limiter) when a newer mask shows up first.
+// Not thread-safe: owned by whichever stage drains the pollers.
+class FrameSynchronizer {
+public:
+    FrameSynchronizer() = default;
+    explicit FrameSynchronizer(const FrameSyncConfig& config) : config_(config) {}
+
+    void SetConfig(const FrameSyncConfig& config) { config_ = config; }
+    void SetPolicy(FusionPolicy policy) { config_.policy = policy; }
+    const FrameSyncConfig& GetConfig() const { return config_; }
+
+    // Optional tap: every input below is also appended to a session recording
+    void SetRecorder(SessionRecorder* recorder) { recorder_ = recorder; }
+
+    // Inputs (frame as submitted to the graph, outputs as polled)
+    void AddFrame(mediapipe::Timestamp ts, const cv::Mat& frame_bgr);
+    void AddMask(mediapipe::Timestamp ts, const cv::Mat& mask_u8);
+    void AddLandmarks(mediapipe::Timestamp ts, const mediapipe::NormalizedLandmarkList& landmarks);
+
+    // Release the newest frame that is ready under the current policy.
+    // Older ready frames are skipped (counted as superseded).
+    bool PopReady(FusedFrame& out);
+
+    size_t PendingFrames() const { return frames_.size(); }
+    const FrameSyncStats& GetStats() const { return stats_; }
+    void Reset();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingFrame {
+        mediapipe::Timestamp ts;
+        cv::Mat frame_bgr;
+        Clock::time_point arrival;
+    };
+    struct MaskEntry {
+        mediapipe::Timestamp ts;
+        cv::Mat mask_u8;
+        Clock::time_point arrival;
+    };
+    struct LandmarksEntry {
+        mediapipe::Timestamp ts;
+        mediapipe::NormalizedLandmarkList landmarks;
+    };
+
+    // Returns 1 = ready, 0 = keep waiting, -1 = frame will never match (drop it)
+    int CheckMatch(const PendingFrame& frame, Clock::time_point now, bool* timed_out) const;
+    void Fill(const PendingFrame& frame, bool allow_extrapolation, FusedFrame& out);
+    bool Extrapolate(const PendingFrame& frame, FusedFrame& out) const;
+    void PruneOutputs();
+
+    const MaskEntry* FindMask(mediapipe::Timestamp ts) const;
+    const LandmarksEntry* FindLandmarks(mediapipe::Timestamp ts) const;
+
+    FrameSyncConfig config_;
+    FrameSyncStats stats_;
+    SessionRecorder* recorder_ = nullptr;
+    std::deque<PendingFrame> frames_;      // Ascending timestamps
+    std::deque<MaskEntry> masks_;          // Ascending timestamps
+    std::deque<LandmarksEntry> landmarks_; // Ascending timestamps
+};
+
+} // namespace segmecam
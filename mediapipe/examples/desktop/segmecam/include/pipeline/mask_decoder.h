@@ -0,0 +1,44 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "include/pipeline/frame_pool.h"
+
+namespace segmecam {
+
+// Turns segmentation mask packets (ImageFrame) into 8-bit 0..255 masks.
+//
+// One decoder per mask stream. For 4xU8 (SRGBA) masks the channel carrying
+// the segmentation is picked once, from the first frame's channel means, and
+// kept for the stream: no per-frame switching (which looks like flicker) and
+// no per-frame statistics. Every format is decoded in a single pass into a
+// pooled buffer; 1xU8 masks can skip even that (DecodeView).
+// Not thread-safe: owned by whichever stage drains the mask poller.
+class MaskDecoder {
+public:
+    MaskDecoder() = default;
+
+    // Decode into a buffer leased from pool (plain cv::Mat if pool is null)
+    cv::Mat Decode(const mediapipe::ImageFrame& mask, FramePool* pool = nullptr);
+
+    // Zero-copy for 1xU8 masks: the returned Mat points at the packet's
+    // pixels and holds a reference to the Packet, released with the last
+    // copy of the Mat, so it may be queued like any other Mat. It must not
+    // be written to. Other formats fall back to Decode().
+    cv::Mat DecodeView(const mediapipe::Packet& packet, FramePool* pool = nullptr);
+
+    // Channel picked for 4xU8 masks (0=B,1=G,2=R,3=A), -1 until the first one
+    int SelectedChannel() const { return rgba_channel_; }
+
+    // New stream (e.g. graph restart): pick the channel again
+    void Reset() { rgba_channel_ = -1; }
+
+private:
+    void SelectChannel(const cv::Mat& rgba);
+
+    int rgba_channel_ = -1;
+    bool warned_format_ = false;
+};
+
+} // namespace segmecam
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "mediapipe/framework/formats/landmark.pb.h"
+
+namespace segmecam {
+
+// Session container: what the pipeline saw, for reproducible benchmarks.
+//
+// A single append-only file: a 64-byte file header followed by records of a
+// 64-byte record header and a payload padded to 64 bytes, so every image
+// payload is cache-line aligned when the file is mapped. Images are stored
+// raw (rows * step bytes), landmarks as a serialized NormalizedLandmarkList.
+// A record cut short (crash while recording) ends the session cleanly.
+enum class SessionRecordType : uint16_t {
+    kFrame = 1,      // Camera frame, BGR CV_8UC3, as submitted to the graph
+    kMask = 2,       // Decoded segmentation_mask_cpu, CV_8UC1
+    kLandmarks = 3,  // multi_face_landmarks[0]
+};
+
+// Appends records; thread-safe (capture and effects stages may both write).
+class SessionRecorder {
+public:
+    SessionRecorder() = default;
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    // Creates (truncates) the file and writes the file header
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const;
+
+    // ts is the mediapipe::Timestamp value the data belongs to
+    bool WriteFrame(int64_t ts, const cv::Mat& frame_bgr);
+    bool WriteMask(int64_t ts, const cv::Mat& mask_u8);
+    bool WriteLandmarks(int64_t ts, const mediapipe::NormalizedLandmarkList& landmarks);
+
+    uint64_t RecordCount() const;
+    uint64_t BytesWritten() const;
+
+private:
+    bool WriteImage(SessionRecordType type, int64_t ts, const cv::Mat& img);
+    bool WriteRecord(SessionRecordType type, int64_t ts, int rows, int cols, int cv_type,
+                     uint32_t step, const void* data, uint64_t bytes);  // Caller holds mutex_
+    void Fail();  // Caller holds mutex_
+
+    mutable std::mutex mutex_;
+    std::FILE* file_ = nullptr;
+    std::string path_;
+    uint64_t records_ = 0;
+    uint64_t bytes_ = 0;
+};
+
+// Read-only view of a session file through mmap. Images are returned as
+// cv::Mat headers pointing into the mapping (no copy, no decode); they stay
+// valid until Close() and must not be written to.
+class SessionReader {
+public:
+    struct FrameRecord {
+        int64_t timestamp = 0;
+        int64_t capture_us = 0;  // Steady-clock time the frame was recorded
+        cv::Mat frame_bgr;
+    };
+
+    SessionReader() = default;
+    ~SessionReader();
+
+    SessionReader(const SessionReader&) = delete;
+    SessionReader& operator=(const SessionReader&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return base_ != nullptr; }
+
+    size_t FrameCount() const { return frames_.size(); }
+    size_t MaskCount() const { return masks_.size(); }
+    size_t LandmarksCount() const { return landmarks_.size(); }
+
+    FrameRecord Frame(size_t index) const;
+
+    // Outputs recorded for exactly this timestamp
+    bool FindMask(int64_t ts, cv::Mat& mask_u8) const;
+    bool FindLandmarks(int64_t ts, mediapipe::NormalizedLandmarkList& landmarks) const;
+
+private:
+    struct IndexEntry {
+        int64_t timestamp;
+        int64_t capture_us;
+        size_t offset;  // Of the record header
+    };
+
+    const IndexEntry* Find(const std::vector<IndexEntry>& index, int64_t ts) const;
+    cv::Mat ImageAt(const IndexEntry& entry) const;
+
+    const uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    std::vector<IndexEntry> frames_;
+    std::vector<IndexEntry> masks_;
+    std::vector<IndexEntry> landmarks_;
+};
+
+} // namespace segmecam
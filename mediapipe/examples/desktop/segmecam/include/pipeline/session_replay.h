@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include "mediapipe/framework/timestamp.h"
+#include "include/pipeline/frame_synchronizer.h"
+#include "include/pipeline/session_file.h"
+
+namespace segmecam {
+
+// Stands in for CameraManager + the graph output pollers during replay.
+//
+// NextFrame() plays the camera side, FeedOutputs() the poller side: it
+// hands the recorded mask/landmarks for a frame to the synchronizer exactly
+// as PollSegmentationMask/PollFaceLandmarks would have. Frames and masks
+// are views into the mapped session (see SessionReader).
+class SessionReplaySource {
+public:
+    // realtime: pace frames at their recorded capture interval
+    // loop: restart at the end (timestamps keep increasing across loops)
+    SessionReplaySource(const SessionReader& reader, bool realtime, bool loop);
+
+    bool NextFrame(cv::Mat& frame_bgr, mediapipe::Timestamp& ts);
+    void FeedOutputs(mediapipe::Timestamp ts, FrameSynchronizer& frame_sync) const;
+
+    bool HasLandmarks() const { return reader_.LandmarksCount() > 0; }
+    bool Finished() const { return finished_; }
+    uint64_t FramesDelivered() const { return delivered_; }
+
+private:
+    const SessionReader& reader_;
+    bool realtime_;
+    bool loop_;
+    size_t next_ = 0;
+    int64_t ts_offset_ = 0;       // Added to recorded timestamps on later loops
+    int64_t loop_span_ = 0;       // Recorded timestamp range + 1
+    bool finished_ = false;
+    uint64_t delivered_ = 0;
+    int64_t last_capture_us_ = 0;
+    std::chrono::steady_clock::time_point last_delivery_;
+};
+
+} // namespace segmecam
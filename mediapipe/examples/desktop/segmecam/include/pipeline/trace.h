@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace segmecam {
+
+struct TraceRing;
+
+// One completed span as read back from the rings
+struct TraceEvent {
+    const char* name = nullptr;
+    uint32_t tid = 0;
+    uint64_t start_ns = 0;
+    uint64_t dur_ns = 0;
+};
+
+// Lightweight in-process tracer for per-frame stage timing.
+//
+// Every thread records complete spans into its own fixed-size ring (oldest
+// events are overwritten), so recording never locks or allocates after the
+// thread's first span. A thread's ring goes back to a free list when it
+// exits and is reused by the next new thread, so threads that come and go
+// (decoders, capture restarts) don't grow the tracer. The rings can be
+// dumped at any time as Chrome trace JSON (chrome://tracing or
+// ui.perfetto.dev).
+// Recording is off by default; a disabled span costs one relaxed load.
+class Tracer {
+public:
+    static Tracer& Instance();
+
+    void SetEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    void SetOutputPath(const std::string& path);
+    std::string GetOutputPath() const;
+
+    // Label the calling thread in the exported trace
+    void SetThreadName(const char* name);
+
+    // name must have static storage duration (string literal)
+    void Record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+    // Write all recorded spans; safe while other threads keep recording
+    bool WriteChromeTrace(const std::string& path) const;
+    bool WriteChromeTrace() const { return WriteChromeTrace(GetOutputPath()); }
+
+    // Copy out all recorded spans (e.g. for in-process statistics)
+    std::vector<TraceEvent> CollectEvents() const;
+
+    // Discard everything recorded so far
+    void Clear();
+
+    // Monotonic time since process start
+    static uint64_t NowNs();
+
+private:
+    Tracer() = default;
+    TraceRing& ThreadRing();
+    TraceRing* AcquireRing();
+    void ReleaseRing(TraceRing* ring);
+
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex mutex_;  // Ring registry, thread names, output path
+    std::vector<std::shared_ptr<TraceRing>> rings_;
+    std::vector<TraceRing*> free_rings_;  // Of exited threads, for new ones
+    std::string output_path_ = "segmecam_trace.json";
+};
+
+// RAII span: records [construction, destruction) when tracing is enabled
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : name_(Tracer::Instance().IsEnabled() ? name : nullptr),
+          start_ns_(name_ ? Tracer::NowNs() : 0) {}
+    ~TraceSpan() {
+        if (name_) Tracer::Instance().Record(name_, start_ns_, Tracer::NowNs());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_ns_;
+};
+
+} // namespace segmecam
+
+#define SEGMECAM_TRACE_CONCAT_INNER(a, b) a##b
+#define SEGMECAM_TRACE_CONCAT(a, b) SEGMECAM_TRACE_CONCAT_INNER(a, b)
+// Trace the rest of the enclosing scope under a string-literal name
+#define SEGMECAM_TRACE_SCOPE(name) \
+    ::segmecam::TraceSpan SEGMECAM_TRACE_CONCAT(segmecam_trace_span_, __LINE__)(name)
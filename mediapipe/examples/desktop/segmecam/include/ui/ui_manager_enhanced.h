@@ -25,8 +25,10 @@ public:
   bool Initialize();
   bool Initialize(SDL_Window* existing_window);
   
-  // Initialize UI panels with dependencies
-  void InitializePanels(AppState& state, CameraManager& camera_mgr, class EffectsManager& effects_mgr, ConfigManager* config_mgr = nullptr);
+  // Initialize UI panels with dependencies; locks when other threads use the
+  // camera and virtual camera while the UI runs
+  void InitializePanels(AppState& state, CameraManager& camera_mgr, ConfigManager* config_mgr = nullptr,
+                        const PanelLocks& locks = {});
   
   // Event handling
   bool ProcessEvents(bool& running);
@@ -75,6 +77,9 @@ private:
   bool InitializeImGui();
   void DrawInitialFrame();
   
+  // F12: start a fresh trace, or stop and write it out
+  void ToggleTracing();
+  
   // Panel management
   void RegisterPanel(std::unique_ptr<UIPanel> panel);
   UIPanel* FindPanel(const std::string& name);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "imgui.h"
+#include <mutex>
 #include <string>
 #include <vector>
 #include "app_state.h"
@@ -9,6 +10,19 @@
 
 namespace segmecam {
 
+// Stage locks of the pipelined loop, null when everything runs on one thread.
+// Panels take one only around the manager call that needs it; effect settings
+// never need one, they reach the effects through the published snapshot.
+struct PanelLocks {
+    std::mutex* camera = nullptr;  // CameraManager reconfiguration
+    std::mutex* vcam = nullptr;    // AppState::vcam
+};
+
+// Locks m if there is one
+inline std::unique_lock<std::mutex> LockIf(std::mutex* m) {
+    return m ? std::unique_lock<std::mutex>(*m) : std::unique_lock<std::mutex>();
+}
+
 // Base class for all UI panels
 class UIPanel {
 public:
@@ -29,7 +43,7 @@ protected:
 // Camera selection and controls panel
 class CameraPanel : public UIPanel {
 public:
-    CameraPanel(AppState& state, CameraManager& camera_mgr, class EffectsManager& effects_mgr);
+    CameraPanel(AppState& state, CameraManager& camera_mgr, const PanelLocks& locks = {});
     ~CameraPanel() override = default;
     
     void Render() override;
@@ -60,7 +74,7 @@ private:
     
     AppState& state_;
     CameraManager& camera_mgr_;
-    class EffectsManager& effects_mgr_;
+    PanelLocks locks_;
     class ConfigManager* config_mgr_ = nullptr;
     
     // UI state
@@ -102,10 +116,13 @@ private:
     void RenderBackgroundMode();
     void RenderBlurControls();
     void RenderImageControls();
+    void RenderVideoControls();
     void RenderSolidColorControls();
     void RenderMaskControls();
     
     AppState& state_;
+    // Path being typed; only "Load" hands it to the effects (a new decoder per keystroke otherwise)
+    char video_path_edit_[512] = {0};
 };
 
 // Beauty and face effects panel
@@ -48,5 +48,28 @@ void ApplyPreset(int idx, BeautyState& s) {
   }
 }
 
+bool operator==(const BeautyState& a, const BeautyState& b) {
+  auto same3 = [](const float* x, const float* y) { return x[0] == y[0] && x[1] == y[1] && x[2] == y[2]; };
+  return a.bg_mode == b.bg_mode && a.blur_strength == b.blur_strength && a.blur_backend == b.blur_backend &&
+         a.mask_upsampler == b.mask_upsampler && a.feather_px == b.feather_px &&
+         a.show_mask == b.show_mask && same3(a.solid_color, b.solid_color) &&
+         a.fx_skin == b.fx_skin && a.fx_skin_adv == b.fx_skin_adv && a.fx_skin_amount == b.fx_skin_amount &&
+         a.fx_skin_radius == b.fx_skin_radius && a.fx_skin_tex == b.fx_skin_tex && a.fx_skin_edge == b.fx_skin_edge &&
+         a.fx_skin_wrinkle == b.fx_skin_wrinkle && a.fx_skin_smile_boost == b.fx_skin_smile_boost &&
+         a.fx_skin_squint_boost == b.fx_skin_squint_boost && a.fx_skin_forehead_boost == b.fx_skin_forehead_boost &&
+         a.fx_skin_wrinkle_gain == b.fx_skin_wrinkle_gain && a.fx_wrinkle_suppress_lower == b.fx_wrinkle_suppress_lower &&
+         a.fx_wrinkle_lower_ratio == b.fx_wrinkle_lower_ratio && a.fx_wrinkle_ignore_glasses == b.fx_wrinkle_ignore_glasses &&
+         a.fx_wrinkle_glasses_margin == b.fx_wrinkle_glasses_margin && a.fx_wrinkle_keep_ratio == b.fx_wrinkle_keep_ratio &&
+         a.fx_wrinkle_custom_scales == b.fx_wrinkle_custom_scales && a.fx_wrinkle_min_px == b.fx_wrinkle_min_px &&
+         a.fx_wrinkle_max_px == b.fx_wrinkle_max_px && a.fx_wrinkle_use_skin_gate == b.fx_wrinkle_use_skin_gate &&
+         a.fx_wrinkle_mask_gain == b.fx_wrinkle_mask_gain && a.fx_wrinkle_baseline == b.fx_wrinkle_baseline &&
+         a.fx_wrinkle_neg_cap == b.fx_wrinkle_neg_cap && a.fx_wrinkle_preview == b.fx_wrinkle_preview &&
+         a.fx_adv_scale == b.fx_adv_scale && a.fx_adv_detail_preserve == b.fx_adv_detail_preserve &&
+         a.fx_lipstick == b.fx_lipstick && a.fx_lip_alpha == b.fx_lip_alpha && a.fx_lip_feather == b.fx_lip_feather &&
+         a.fx_lip_light == b.fx_lip_light && a.fx_lip_band == b.fx_lip_band && same3(a.fx_lip_color, b.fx_lip_color) &&
+         a.fx_teeth == b.fx_teeth && a.fx_teeth_strength == b.fx_teeth_strength && a.fx_teeth_margin == b.fx_teeth_margin &&
+         a.auto_processing_scale == b.auto_processing_scale && a.target_fps == b.target_fps;
+}
+
 } // namespace segmecam
 
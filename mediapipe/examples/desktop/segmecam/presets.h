@@ -9,6 +9,8 @@ struct BeautyState {
   // Background
   int bg_mode = 0;            // 0(None) 1(Blur) 2(Image) 3(Color)
   int blur_strength = 25;     // odd kernel
+  int blur_backend = 0;       // 0(Gaussian) 1(Box: constant time) 2(Pyramid: push-pull)
+  int mask_upsampler = 0;     // 0(Bilinear) 1(Guided: edge-aware, frame as guide)
   float feather_px = 2.0f;
   bool show_mask = false;
   float solid_color[3] = {0.0f, 0.0f, 0.0f}; // RGB 0..1 for solid background
@@ -65,5 +67,9 @@ struct BeautyState {
 // idx: 0=Default, 1=Natural, 2=Studio, 3=Glam, 4=Meeting
 void ApplyPreset(int idx, BeautyState& s);
 
+// Field-wise comparison (used to publish settings snapshots only on change).
+bool operator==(const BeautyState& a, const BeautyState& b);
+inline bool operator!=(const BeautyState& a, const BeautyState& b) { return !(a == b); }
+
 } // namespace segmecam
 
@@ -0,0 +1,486 @@
+// Offline replay benchmark for EffectsManager.
+//
+// Replays a sequence of frames, segmentation masks and face landmarks through
+// EffectsManager::ProcessFrame for every beauty preset and background mode at
+// 720p / 1080p / 4K, and writes per-stage latency percentiles (taken from the
+// pipeline trace spans) plus throughput as JSON. No camera, GPU or display.
+//
+// Input (--input_dir) is a directory of
+//   frame_000000.png      BGR camera frame (any size, rescaled per resolution)
+//   mask_000000.png       8-bit segmentation mask (kept at model resolution)
+//   landmarks_000000.txt  optional, one "x y z" normalized landmark per line
+// or (--session) a file written by `segmecam --record=FILE`, which is mapped
+// and replayed without decoding. Without either a deterministic synthetic
+// sequence is used (moving person mask + synthetic face mesh); use a
+// recording for representative face-effect numbers.
+//
+//   bazel run -c opt //mediapipe/examples/desktop/segmecam:segmecam_bench -- \
+//     --session=/path/to/capture.sgms --output=/tmp/bench.json
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "include/effects/effects_manager.h"
+#include "include/pipeline/session_file.h"
+#include "include/pipeline/trace.h"
+#include "presets.h"
+
+ABSL_FLAG(std::string, input_dir, "", "Recorded sequence directory (empty = synthetic sequence)");
+ABSL_FLAG(std::string, session, "", "Session file from segmecam --record (takes precedence over --input_dir)");
+ABSL_FLAG(int, synthetic_frames, 60, "Length of the synthetic sequence");
+ABSL_FLAG(int, frames, 100, "Measured frames per configuration (sequence is looped)");
+ABSL_FLAG(int, warmup, 10, "Unmeasured frames per configuration");
+ABSL_FLAG(std::string, resolutions, "720p,1080p,4k", "Comma-separated subset of 720p,1080p,4k");
+ABSL_FLAG(std::string, presets, "0,1,2,3,4", "Beauty presets (0=Default 1=Natural 2=Studio 3=Glam 4=Meeting)");
+ABSL_FLAG(std::string, bg_modes, "0,1,2,3", "Background modes (0=None 1=Blur 2=Image 3=Solid 4=Video)");
+ABSL_FLAG(int, blur_backend, 0, "Engine for bg mode 1 (0=Gaussian 1=Box 2=Pyramid)");
+ABSL_FLAG(int, mask_upsampler, 0, "Mask upsampling (0=Bilinear 1=Guided)");
+ABSL_FLAG(bool, blur_cache, true, "Reuse unchanged tiles of the blurred background across frames");
+ABSL_FLAG(std::string, bg_image, "", "Background image for mode 2 (empty = synthetic gradient)");
+ABSL_FLAG(std::string, bg_video, "", "Background video for mode 4");
+ABSL_FLAG(bool, bg_video_preload, true, "Hold the background video decoded in memory if it is short enough");
+ABSL_FLAG(bool, use_opencl, false, "Allow OpenCL acceleration (off for reproducible CPU numbers)");
+ABSL_FLAG(std::string, output, "segmecam_bench.json", "JSON result file");
+
+namespace segmecam {
+namespace {
+
+struct ReplayFrame {
+  cv::Mat frame_bgr;
+  cv::Mat mask_u8;
+  bool has_landmarks = false;
+  mediapipe::NormalizedLandmarkList landmarks;
+};
+
+struct Resolution {
+  const char* name;
+  int width;
+  int height;
+};
+
+constexpr Resolution kResolutions[] = {{"720p", 1280, 720}, {"1080p", 1920, 1080}, {"4k", 3840, 2160}};
+const char* const kPresetNames[] = {"default", "natural", "studio", "glam", "meeting"};
+const char* const kBgModeNames[] = {"none", "blur", "image", "solid", "video"};
+
+// Selfie segmentation (landscape) output size
+const cv::Size kSyntheticMaskSize(256, 144);
+constexpr int kNumLandmarks = 478;
+
+struct LatencyStats {
+  size_t count = 0;
+  double mean = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+struct RunResult {
+  const Resolution* resolution = nullptr;
+  int preset = 0;
+  int bg_mode = 0;
+  double fps = 0.0;
+  LatencyStats frame_ms;
+  uint64_t pool_allocations = 0;
+  std::map<std::string, LatencyStats> stages;
+};
+
+std::vector<std::string> SplitList(const std::string& s) {
+  std::vector<std::string> out;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) out.push_back(item);
+  }
+  return out;
+}
+
+std::vector<int> ParseIntList(const std::string& s, int lo, int hi) {
+  std::vector<int> out;
+  for (const std::string& item : SplitList(s)) {
+    int v = std::atoi(item.c_str());
+    if (v >= lo && v <= hi) out.push_back(v);
+    else std::cerr << "⚠️  Ignoring out-of-range value " << item << std::endl;
+  }
+  return out;
+}
+
+std::string IndexedPath(const std::string& dir, const char* prefix, int i, const char* ext) {
+  std::ostringstream os;
+  os << dir << "/" << prefix << std::setw(6) << std::setfill('0') << i << ext;
+  return os.str();
+}
+
+bool LoadLandmarks(const std::string& path, mediapipe::NormalizedLandmarkList& out) {
+  std::ifstream in(path);
+  if (!in) return false;
+  float x, y, z;
+  while (in >> x >> y >> z) {
+    auto* lm = out.add_landmark();
+    lm->set_x(x); lm->set_y(y); lm->set_z(z);
+  }
+  return out.landmark_size() > 0;
+}
+
+bool LoadSequenceDir(const std::string& dir, std::vector<ReplayFrame>& seq) {
+  for (int i = 0;; ++i) {
+    ReplayFrame f;
+    f.frame_bgr = cv::imread(IndexedPath(dir, "frame_", i, ".png"), cv::IMREAD_COLOR);
+    if (f.frame_bgr.empty()) break;
+    f.mask_u8 = cv::imread(IndexedPath(dir, "mask_", i, ".png"), cv::IMREAD_GRAYSCALE);
+    if (f.mask_u8.empty()) {
+      std::cerr << "❌ Missing mask for frame " << i << " in " << dir << std::endl;
+      return false;
+    }
+    f.has_landmarks = LoadLandmarks(IndexedPath(dir, "landmarks_", i, ".txt"), f.landmarks);
+    seq.push_back(std::move(f));
+  }
+  return !seq.empty();
+}
+
+// Frames and masks stay views into the mapping; reader must outlive seq.
+// Frames without a recorded mask (graph dropped them) are skipped.
+bool LoadSession(const SessionReader& reader, std::vector<ReplayFrame>& seq) {
+  for (size_t i = 0; i < reader.FrameCount(); ++i) {
+    SessionReader::FrameRecord rec = reader.Frame(i);
+    ReplayFrame f;
+    if (!reader.FindMask(rec.timestamp, f.mask_u8)) continue;
+    f.frame_bgr = rec.frame_bgr;
+    f.has_landmarks = reader.FindLandmarks(rec.timestamp, f.landmarks);
+    seq.push_back(std::move(f));
+  }
+  return !seq.empty();
+}
+
+// Synthetic face mesh: the region contours EffectsManager uses (same landmark
+// indices as segmecam_face_effects.cc) on plausible ellipses, every other
+// landmark spread over the face so no geometry is degenerate.
+void PlaceArc(mediapipe::NormalizedLandmarkList& lms, const std::vector<int>& idx,
+              float cx, float cy, float rx, float ry, float a0, float a1) {
+  for (size_t k = 0; k < idx.size(); ++k) {
+    float t = idx.size() > 1 ? (float)k / (float)(idx.size() - 1) : 0.0f;
+    float a = a0 + (a1 - a0) * t;
+    auto* lm = lms.mutable_landmark(idx[k]);
+    lm->set_x(cx + rx * std::cos(a));
+    lm->set_y(cy + ry * std::sin(a));
+  }
+}
+
+mediapipe::NormalizedLandmarkList MakeSyntheticFace(float cx, float cy, float rx, float ry) {
+  const float kPi = 3.14159265f;
+  mediapipe::NormalizedLandmarkList lms;
+  for (int i = 0; i < kNumLandmarks; ++i) {
+    // Golden-angle spiral inside the face oval
+    float r = 0.85f * std::sqrt((i + 0.5f) / kNumLandmarks);
+    float a = i * 2.39996323f;
+    auto* lm = lms.add_landmark();
+    lm->set_x(cx + rx * r * std::cos(a));
+    lm->set_y(cy + ry * r * std::sin(a));
+    lm->set_z(0.0f);
+  }
+  PlaceArc(lms, {10,338,297,332,284,251,389,356,454,323,361,288,397,365,379,378,400,377,
+                 152,148,176,149,150,136,172,58,132,93,234,127,162,21,54,103,67,109},
+           cx, cy, rx, ry, -kPi / 2, 1.5f * kPi);
+  float my = cy + 0.55f * ry, mrx = 0.35f * rx, mry = 0.13f * ry;
+  PlaceArc(lms, {61,146,91,181,84,17,314,405,321,375,291}, cx, my, mrx, mry, kPi, 0.0f);           // lower outer
+  PlaceArc(lms, {61,185,40,39,37,0,267,269,270,409,291}, cx, my, mrx, mry, kPi, 2 * kPi);          // upper outer
+  PlaceArc(lms, {78,95,88,178,87,14,317,402,318,324,308}, cx, my, 0.8f * mrx, 0.5f * mry, kPi, 0.0f);
+  PlaceArc(lms, {78,191,80,81,82,13,312,311,310,415,308}, cx, my, 0.8f * mrx, 0.5f * mry, kPi, 2 * kPi);
+  float ey = cy - 0.2f * ry, erx = 0.18f * rx, ery = 0.07f * ry;
+  PlaceArc(lms, {33,7,163,144,145,153,154,155,133,173,157,158,159,160,161,246},
+           cx - 0.42f * rx, ey, erx, ery, kPi, 3 * kPi);
+  PlaceArc(lms, {263,249,390,373,374,380,381,382,362,398,384,385,386,387,388,466},
+           cx + 0.42f * rx, ey, erx, ery, 0.0f, 2 * kPi);
+  return lms;
+}
+
+std::vector<ReplayFrame> MakeSyntheticSequence(int count) {
+  std::vector<ReplayFrame> seq;
+  const cv::Size size(1920, 1080);
+  cv::RNG rng(12345);
+  cv::Mat texture(size, CV_8UC3);
+  rng.fill(texture, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(48));
+  for (int i = 0; i < count; ++i) {
+    ReplayFrame f;
+    float t = (float)i / (float)std::max(1, count);
+    float sway = 0.03f * std::sin(t * 6.2831853f);
+
+    f.frame_bgr.create(size, CV_8UC3);
+    for (int y = 0; y < size.height; ++y) {
+      cv::Vec3b* row = f.frame_bgr.ptr<cv::Vec3b>(y);
+      for (int x = 0; x < size.width; ++x) {
+        row[x] = cv::Vec3b((uchar)(60 + x * 100 / size.width), (uchar)(80 + y * 90 / size.height), (uchar)(120 + i % 60));
+      }
+    }
+    f.frame_bgr += texture;
+
+    // Person: head + shoulders, drawn at full res then reduced to mask size
+    float cx = 0.5f + sway, cy = 0.42f, rx = 0.11f, ry = 0.26f;
+    cv::Mat person(size, CV_8UC1, cv::Scalar(0));
+    cv::Point head((int)(cx * size.width), (int)(cy * size.height));
+    cv::ellipse(person, head, cv::Size((int)(rx * size.width), (int)(ry * size.height)), 0, 0, 360, cv::Scalar(255), -1);
+    cv::ellipse(person, cv::Point(head.x, size.height), cv::Size(size.width / 4, size.height / 3), 0, 180, 360, cv::Scalar(255), -1);
+    cv::ellipse(f.frame_bgr, head, cv::Size((int)(rx * size.width), (int)(ry * size.height)), 0, 0, 360, cv::Scalar(140, 170, 215), -1);
+    cv::resize(person, f.mask_u8, kSyntheticMaskSize, 0, 0, cv::INTER_AREA);
+    cv::GaussianBlur(f.mask_u8, f.mask_u8, cv::Size(5, 5), 0);
+
+    f.landmarks = MakeSyntheticFace(cx, cy, rx, ry);
+    f.has_landmarks = true;
+    seq.push_back(std::move(f));
+  }
+  return seq;
+}
+
+// Frames are rescaled; masks stay at model resolution (EffectsManager resizes
+// them as in the live pipeline) and landmarks are normalized already.
+std::vector<ReplayFrame> ScaleSequence(const std::vector<ReplayFrame>& src, const cv::Size& size) {
+  std::vector<ReplayFrame> out(src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    if (src[i].frame_bgr.size() == size) {
+      out[i].frame_bgr = src[i].frame_bgr;  // Shared, ProcessFrame does not write its input
+    } else {
+      int interp = size.area() < src[i].frame_bgr.size().area() ? cv::INTER_AREA : cv::INTER_LINEAR;
+      cv::resize(src[i].frame_bgr, out[i].frame_bgr, size, 0, 0, interp);
+    }
+    out[i].mask_u8 = src[i].mask_u8;
+    out[i].has_landmarks = src[i].has_landmarks;
+    out[i].landmarks = src[i].landmarks;
+  }
+  return out;
+}
+
+cv::Mat MakeBackgroundImage(const std::string& path) {
+  if (!path.empty()) {
+    cv::Mat img = cv::imread(path, cv::IMREAD_COLOR);
+    if (!img.empty()) return img;
+    std::cerr << "⚠️  Could not load background image " << path << ", using synthetic" << std::endl;
+  }
+  cv::Mat img(1080, 1920, CV_8UC3);
+  for (int y = 0; y < img.rows; ++y) {
+    img.row(y).setTo(cv::Scalar(200 - y * 120 / img.rows, 120, 40 + y * 150 / img.rows));
+  }
+  return img;
+}
+
+LatencyStats Summarize(std::vector<double> ms) {
+  LatencyStats s;
+  s.count = ms.size();
+  if (ms.empty()) return s;
+  std::sort(ms.begin(), ms.end());
+  // Nearest-rank percentile
+  auto rank = [&](double q) {
+    size_t idx = (size_t)std::ceil(q * ms.size());
+    return ms[std::min(ms.size(), std::max<size_t>(idx, 1)) - 1];
+  };
+  double sum = 0.0;
+  for (double v : ms) sum += v;
+  s.mean = sum / ms.size();
+  s.p50 = rank(0.50);
+  s.p95 = rank(0.95);
+  s.p99 = rank(0.99);
+  s.max = ms.back();
+  return s;
+}
+
+RunResult RunConfiguration(EffectsManager& effects, const std::vector<ReplayFrame>& seq,
+                           const Resolution& res, int preset, int bg_mode,
+                           const std::shared_ptr<const cv::Mat>& bg_image, int frames, int warmup) {
+  // Fixed settings: auto processing scale would make runs time-dependent
+  auto settings = std::make_shared<EffectsSettings>();
+  ApplyPreset(preset, settings->beauty);
+  settings->beauty.bg_mode = bg_mode;
+  settings->beauty.blur_backend = absl::GetFlag(FLAGS_blur_backend);
+  settings->beauty.mask_upsampler = absl::GetFlag(FLAGS_mask_upsampler);
+  settings->beauty.show_mask = false;
+  settings->beauty.auto_processing_scale = false;
+  settings->background_image = bg_image;
+  settings->background_generation = 1;
+  settings->background_video_path = absl::GetFlag(FLAGS_bg_video);
+  settings->background_video_preload = absl::GetFlag(FLAGS_bg_video_preload);
+  auto last = effects.GetPublishedSettings();
+  settings->version = (last ? last->version : 0) + 1;
+  effects.PublishSettings(settings);
+
+  Tracer& tracer = Tracer::Instance();
+  size_t n = seq.size();
+  for (int i = 0; i < warmup; ++i) {
+    const ReplayFrame& f = seq[i % n];
+    effects.ProcessFrame(f.frame_bgr, f.mask_u8, f.has_landmarks ? &f.landmarks : nullptr);
+  }
+  tracer.Clear();
+
+  RunResult r;
+  r.resolution = &res;
+  r.preset = preset;
+  r.bg_mode = bg_mode;
+  std::vector<double> frame_ms;
+  frame_ms.reserve(frames);
+  auto t_begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; ++i) {
+    const ReplayFrame& f = seq[(warmup + i) % n];
+    auto t0 = std::chrono::steady_clock::now();
+    cv::Mat out = effects.ProcessFrame(f.frame_bgr, f.mask_u8, f.has_landmarks ? &f.landmarks : nullptr);
+    auto t1 = std::chrono::steady_clock::now();
+    frame_ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    r.pool_allocations += effects.GetState().last_frame_pool_allocations;
+  }
+  double total_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_begin).count();
+  r.fps = total_s > 0.0 ? frames / total_s : 0.0;
+  r.frame_ms = Summarize(std::move(frame_ms));
+
+  std::map<std::string, std::vector<double>> by_stage;
+  for (const TraceEvent& ev : tracer.CollectEvents()) {
+    by_stage[ev.name].push_back((double)ev.dur_ns / 1e6);
+  }
+  for (auto& kv : by_stage) {
+    r.stages[kv.first] = Summarize(std::move(kv.second));
+  }
+  return r;
+}
+
+// s as a quoted JSON string: ", \ and control characters escaped
+std::string JsonString(const std::string& s) {
+  std::ostringstream os;
+  os << '"';
+  for (unsigned char c : s) {
+    switch (c) {
+      case '"': os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\r': os << "\\r"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        if (c < 0x20) {
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec;
+        } else {
+          os << c;
+        }
+    }
+  }
+  os << '"';
+  return os.str();
+}
+
+void WriteStats(std::ostream& os, const LatencyStats& s) {
+  os << "{\"count\":" << s.count << ",\"mean_ms\":" << s.mean << ",\"p50_ms\":" << s.p50
+     << ",\"p95_ms\":" << s.p95 << ",\"p99_ms\":" << s.p99 << ",\"max_ms\":" << s.max << "}";
+}
+
+bool WriteJson(const std::string& path, const std::string& input, int frames, bool opencl,
+               const std::vector<RunResult>& results) {
+  std::ofstream os(path);
+  if (!os) {
+    std::cerr << "❌ Failed to open " << path << std::endl;
+    return false;
+  }
+  os << std::fixed << std::setprecision(3);
+  os << "{\"benchmark\":\"segmecam_bench\",\"input\":" << JsonString(input) << ",\"frames\":" << frames
+     << ",\"opencl\":" << (opencl ? "true" : "false") << ",\"results\":[";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const RunResult& r = results[i];
+    os << (i ? ",\n" : "\n") << "{\"resolution\":" << JsonString(r.resolution->name) << ",\"width\":" << r.resolution->width
+       << ",\"height\":" << r.resolution->height << ",\"preset\":" << JsonString(kPresetNames[r.preset])
+       << ",\"bg_mode\":" << JsonString(kBgModeNames[r.bg_mode]) << ",\"fps\":" << r.fps
+       << ",\"pool_allocations\":" << r.pool_allocations << ",\"frame\":";
+    WriteStats(os, r.frame_ms);
+    os << ",\"stages\":{";
+    bool first = true;
+    for (const auto& kv : r.stages) {
+      os << (first ? "" : ",") << JsonString(kv.first) << ":";
+      WriteStats(os, kv.second);
+      first = false;
+    }
+    os << "}}";
+  }
+  os << "\n]}\n";
+  return (bool)os;
+}
+
+int RunBenchmark() {
+  const std::string session = absl::GetFlag(FLAGS_session);
+  const std::string input_dir = absl::GetFlag(FLAGS_input_dir);
+  const std::string source_name = !session.empty() ? session : (input_dir.empty() ? "synthetic" : input_dir);
+  const int frames = std::max(1, absl::GetFlag(FLAGS_frames));
+  const int warmup = std::max(0, absl::GetFlag(FLAGS_warmup));
+  const bool use_opencl = absl::GetFlag(FLAGS_use_opencl);
+
+  SessionReader reader;  // Backs the session frames for the whole run
+  std::vector<ReplayFrame> source;
+  if (!session.empty()) {
+    if (!reader.Open(session) || !LoadSession(reader, source)) {
+      std::cerr << "❌ No replayable frames in " << session << std::endl;
+      return 1;
+    }
+  } else if (!input_dir.empty()) {
+    if (!LoadSequenceDir(input_dir, source)) {
+      std::cerr << "❌ No replayable frames in " << input_dir << std::endl;
+      return 1;
+    }
+  } else {
+    source = MakeSyntheticSequence(std::max(1, absl::GetFlag(FLAGS_synthetic_frames)));
+  }
+  std::cerr << "📊 Replaying " << source.size() << " frames from " << source_name << std::endl;
+
+  std::vector<int> presets = ParseIntList(absl::GetFlag(FLAGS_presets), 0, 4);
+  std::vector<int> bg_modes = ParseIntList(absl::GetFlag(FLAGS_bg_modes), 0, 4);
+  std::vector<const Resolution*> resolutions;
+  for (const std::string& name : SplitList(absl::GetFlag(FLAGS_resolutions))) {
+    auto it = std::find_if(std::begin(kResolutions), std::end(kResolutions),
+                           [&](const Resolution& r) { return name == r.name; });
+    if (it != std::end(kResolutions)) resolutions.push_back(&*it);
+    else std::cerr << "⚠️  Unknown resolution " << name << std::endl;
+  }
+  auto bg_image = std::make_shared<const cv::Mat>(MakeBackgroundImage(absl::GetFlag(FLAGS_bg_image)));
+
+  Tracer::Instance().SetEnabled(true);
+  std::vector<RunResult> results;
+  for (const Resolution* res : resolutions) {
+    std::vector<ReplayFrame> seq = ScaleSequence(source, cv::Size(res->width, res->height));
+
+    // Fresh manager per resolution so pooled buffers match the frame size
+    EffectsManager effects;
+    EffectsConfig config;
+    config.enable_opencl = use_opencl;
+    config.enable_performance_logging = false;
+    config.enable_background_blur_cache = absl::GetFlag(FLAGS_blur_cache);
+    if (effects.Initialize(config) != 0) {
+      std::cerr << "❌ EffectsManager initialization failed" << std::endl;
+      return 1;
+    }
+    for (int preset : presets) {
+      for (int bg_mode : bg_modes) {
+        RunResult r = RunConfiguration(effects, seq, *res, preset, bg_mode, bg_image, frames, warmup);
+        std::cerr << "  " << res->name << " " << kPresetNames[preset] << "/" << kBgModeNames[bg_mode]
+                  << ": " << std::fixed << std::setprecision(1) << r.fps << " fps, p50 "
+                  << std::setprecision(2) << r.frame_ms.p50 << " ms, p99 " << r.frame_ms.p99 << " ms"
+                  << std::defaultfloat << std::endl;
+        results.push_back(std::move(r));
+      }
+    }
+  }
+  Tracer::Instance().SetEnabled(false);
+
+  const std::string output = absl::GetFlag(FLAGS_output);
+  if (!WriteJson(output, source_name, frames, use_opencl, results)) {
+    return 1;
+  }
+  std::cerr << "✅ Results written to " << output << std::endl;
+  return 0;
+}
+
+} // namespace
+} // namespace segmecam
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  return segmecam::RunBenchmark();
+}
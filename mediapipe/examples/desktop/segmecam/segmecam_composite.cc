@@ -1,99 +1,378 @@
 #include "segmecam_composite.h"
+#include "composite_kernels.h"
+#include "strip_compositor.h"
+#include "include/pipeline/frame_pool.h"
+#include "include/pipeline/trace.h"
 
-// Persistently remembered preferred channel when mask comes as 4xU8 (SRGBA).
-// This avoids per-frame channel switches that can look like flicker.
-static int g_rgba_mask_channel = -1; // 0=B,1=G,2=R,3=A
-
-cv::Mat DecodeMaskToU8(const mediapipe::ImageFrame& mask, bool* logged_once) {
-  const int ch = mask.NumberOfChannels();
-  const int bd = mask.ByteDepth();
-  cv::Mat out;
-  if (ch == 1 && bd == 1) {
-    cv::Mat m(mask.Height(), mask.Width(), CV_8UC1,
-              const_cast<uint8_t*>(mask.PixelData()), mask.WidthStep());
-    out = m.clone();
-  } else if (ch == 1 && bd == 4) {
-    cv::Mat mf(mask.Height(), mask.Width(), CV_32FC1,
-               const_cast<uint8_t*>(mask.PixelData()), mask.WidthStep());
-    mf.convertTo(out, CV_8UC1, 255.0);
-  } else if (ch == 4 && bd == 1) {
-    cv::Mat rgba(mask.Height(), mask.Width(), CV_8UC4,
-                 const_cast<uint8_t*>(mask.PixelData()), mask.WidthStep());
-    std::vector<cv::Mat> chm; cv::split(rgba, chm);
-    cv::Scalar mb = cv::mean(chm[0]);
-    cv::Scalar mg = cv::mean(chm[1]);
-    cv::Scalar mr = cv::mean(chm[2]);
-    cv::Scalar ma = cv::mean(chm[3]);
-    int best = g_rgba_mask_channel;
-    if (best < 0) {
-      // Find the channel with the highest mean value (most likely to contain segmentation data)
-      // Prefer non-alpha channels over alpha channel to avoid blue tint issues
-      best = 0; double bestv = mb[0];
-      if (mg[0] > bestv) { best=1; bestv=mg[0]; }
-      if (mr[0] > bestv) { best=2; bestv=mr[0]; }
-      // Only use alpha if it's significantly better than color channels
-      if (ma[0] > bestv + 10.0) { best=3; bestv=ma[0]; }
-      g_rgba_mask_channel = best;
-    }
-    out = chm[best].clone();
-    if (logged_once && !*logged_once) {
-      std::cout << "Mask channels=4 byteDepth=1 means[B,G,R,A]="
-                << mb[0] << "," << mg[0] << "," << mr[0] << "," << ma[0]
-                << " chosen=" << (g_rgba_mask_channel==0?"B":g_rgba_mask_channel==1?"G":g_rgba_mask_channel==2?"R":"A")
-                << std::endl;
-      *logged_once = true;
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using segmecam::AcquireFrame;
+using segmecam::FramePool;
+
+cv::Mat ResizeMaskToFrame(const cv::Mat& mask_u8, const cv::Size& frame_size,
+                          FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("mask.resize");
+  if (mask_u8.empty()) return mask_u8;
+  if (mask_u8.size() == frame_size) return mask_u8;
+  cv::Mat r = AcquireFrame(pool, frame_size, CV_8UC1);
+  cv::resize(mask_u8, r, frame_size, 0, 0, cv::INTER_LINEAR);
+  return r;
+}
+
+// Guided filter window radius (mask pixels) and regularization (luma 0..1):
+// radius 2 at mask resolution spans ~25 px at 720p; eps sets how much luma
+// contrast counts as an edge to follow (sqrt(eps) ~ 8 gray levels)
+static constexpr int kGuidedRadius = 2;
+static constexpr float kGuidedEps = 1e-3f;
+
+cv::Mat GuidedUpsampleMask(const cv::Mat& mask_u8, const cv::Mat& frame_bgr, FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("mask.guided_upsample");
+  if (mask_u8.empty()) return mask_u8;
+  const cv::Size full = frame_bgr.size();
+  const cv::Size low = mask_u8.size();
+
+  // Guide at mask resolution
+  cv::Mat small_bgr = AcquireFrame(pool, low, CV_8UC3);
+  cv::resize(frame_bgr, small_bgr, low, 0, 0, cv::INTER_AREA);
+  cv::Mat small_gray = AcquireFrame(pool, low, CV_8UC1);
+  cv::cvtColor(small_bgr, small_gray, cv::COLOR_BGR2GRAY);
+  cv::Mat I = AcquireFrame(pool, low, CV_32FC1);
+  cv::Mat p = AcquireFrame(pool, low, CV_32FC1);
+  small_gray.convertTo(I, CV_32FC1, 1.0/255.0);
+  mask_u8.convertTo(p, CV_32FC1, 1.0/255.0);
+
+  // Window statistics: mean I, mean p, mean I*p, mean I*I
+  const cv::Size win(2 * kGuidedRadius + 1, 2 * kGuidedRadius + 1);
+  cv::Mat prod = AcquireFrame(pool, low, CV_32FC1);
+  cv::Mat mean_I = AcquireFrame(pool, low, CV_32FC1);
+  cv::Mat mean_p = AcquireFrame(pool, low, CV_32FC1);
+  cv::Mat mean_Ip = AcquireFrame(pool, low, CV_32FC1);
+  cv::Mat mean_II = AcquireFrame(pool, low, CV_32FC1);
+  cv::boxFilter(I, mean_I, CV_32F, win);
+  cv::boxFilter(p, mean_p, CV_32F, win);
+  cv::multiply(I, p, prod);
+  cv::boxFilter(prod, mean_Ip, CV_32F, win);
+  cv::multiply(I, I, prod);
+  cv::boxFilter(prod, mean_II, CV_32F, win);
+
+  // Per-window linear coefficients, then averaged over the windows covering each pixel
+  cv::Mat a = AcquireFrame(pool, low, CV_32FC1);
+  cv::Mat b = AcquireFrame(pool, low, CV_32FC1);
+  for (int y = 0; y < low.height; ++y) {
+    const float* mi = mean_I.ptr<float>(y);
+    const float* mp = mean_p.ptr<float>(y);
+    const float* mip = mean_Ip.ptr<float>(y);
+    const float* mii = mean_II.ptr<float>(y);
+    float* ar = a.ptr<float>(y);
+    float* br = b.ptr<float>(y);
+    for (int x = 0; x < low.width; ++x) {
+      const float cov = mip[x] - mi[x] * mp[x];
+      const float var = mii[x] - mi[x] * mi[x];
+      ar[x] = cov / (var + kGuidedEps);
+      br[x] = mp[x] - ar[x] * mi[x];
     }
-  } else {
-    // Fallback treat as float
-    cv::Mat mf(mask.Height(), mask.Width(), CV_32FC1,
-               const_cast<uint8_t*>(mask.PixelData()), mask.WidthStep());
-    mf.convertTo(out, CV_8UC1, 255.0);
   }
+  cv::boxFilter(a, mean_I, CV_32F, win);  // reuse: mean a
+  cv::boxFilter(b, mean_p, CV_32F, win);  // reuse: mean b
+
+  // Horizontal half of the bilinear upsample once at mask height; the
+  // vertical half, luma and a * I + b happen per full-resolution row
+  cv::Mat ah = AcquireFrame(pool, cv::Size(full.width, low.height), CV_32FC1);
+  cv::Mat bh = AcquireFrame(pool, cv::Size(full.width, low.height), CV_32FC1);
+  cv::resize(mean_I, ah, ah.size(), 0, 0, cv::INTER_LINEAR);
+  cv::resize(mean_p, bh, bh.size(), 0, 0, cv::INTER_LINEAR);
+
+  cv::Mat out = AcquireFrame(pool, full, CV_8UC1);
+  const float scale_y = (float)low.height / (float)full.height;
+  // BT.601 luma as in COLOR_BGR2GRAY, folded with the 0..1 normalization
+  const float kB = 0.114f / 255.0f, kG = 0.587f / 255.0f, kR = 0.299f / 255.0f;
+  segmecam::ForEachStrip(full.height, full.width * 4, [&](int y0, int y1) {
+    for (int y = y0; y < y1; ++y) {
+      float fy = (y + 0.5f) * scale_y - 0.5f;
+      int sy = (int)std::floor(fy);
+      fy -= (float)sy;
+      if (sy < 0) { sy = 0; fy = 0.0f; }
+      if (sy >= low.height - 1) { sy = low.height - 1; fy = 0.0f; }
+      const int sy1 = std::min(sy + 1, low.height - 1);
+      const float* a0 = ah.ptr<float>(sy);
+      const float* a1 = ah.ptr<float>(sy1);
+      const float* b0 = bh.ptr<float>(sy);
+      const float* b1 = bh.ptr<float>(sy1);
+      const uint8_t* f = frame_bgr.ptr<uint8_t>(y);
+      uint8_t* o = out.ptr<uint8_t>(y);
+      for (int x = 0; x < full.width; ++x, f += 3) {
+        const float av = a0[x] + fy * (a1[x] - a0[x]);
+        const float bv = b0[x] + fy * (b1[x] - b0[x]);
+        const float luma = f[0] * kB + f[1] * kG + f[2] * kR;
+        o[x] = cv::saturate_cast<uint8_t>((av * luma + bv) * 255.0f);
+      }
+    }
+  });
   return out;
 }
 
-cv::Mat ResizeMaskToFrame(const cv::Mat& mask_u8, const cv::Size& frame_size) {
-  if (mask_u8.empty()) return mask_u8;
-  if (mask_u8.size() == frame_size) return mask_u8;
-  cv::Mat r; cv::resize(mask_u8, r, frame_size, 0, 0, cv::INTER_LINEAR);
-  return r;
+cv::Mat VisualizeMaskRGB(const cv::Mat& mask_u8, FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("mask.visualize");
+  cv::Mat rgb = AcquireFrame(pool, mask_u8.size(), CV_8UC3);
+  segmecam::MaskToRGB(mask_u8, rgb);
+  return rgb;
+}
+
+// Size cv::resize produces for a uniform scale factor
+static cv::Size scaledSize(const cv::Size& s, float scale) {
+  return cv::Size(std::max(1, cvRound(s.width * scale)), std::max(1, cvRound(s.height * scale)));
+}
+
+cv::Size AccelWorkingSize(const cv::Size& frame_size, float scale) {
+  scale = std::clamp(scale, 0.4f, 1.0f);
+  if (std::abs(scale - 1.0f) < 1e-3f) return frame_size;
+  return scaledSize(frame_size, scale);
+}
+
+// Blend mask: the decoded mask, optionally feathered (stays 8-bit).
+static cv::Mat featherMask(const cv::Mat& mask_u8, float feather_px, FramePool* pool) {
+  if (feather_px <= 0.5f) return mask_u8;
+  int fks = (int)std::max(1.0f, feather_px) * 2 + 1;
+  cv::Mat feathered = AcquireFrame(pool, mask_u8.size(), CV_8UC1);
+  cv::GaussianBlur(mask_u8, feathered, cv::Size(fks,fks), 0);
+  return feathered;
 }
 
-cv::Mat VisualizeMaskRGB(const cv::Mat& mask_u8) {
-  cv::Mat rgb; cv::cvtColor(mask_u8, rgb, cv::COLOR_GRAY2RGB);
+// fg*m + bg*(1-m) straight from 8-bit BGR to 8-bit RGB, strip-parallel.
+// The mask may be smaller than fg (upsampled per strip) and is feathered
+// per strip when feather_px is set.
+static cv::Mat blendToRGB(const cv::Mat& fg_bgr, const cv::Mat& bg_bgr,
+                          const cv::Mat& mask_u8, FramePool* pool,
+                          float feather_px = 0.0f) {
+  cv::Mat rgb = AcquireFrame(pool, fg_bgr.size(), CV_8UC3);
+  segmecam::CompositeStripsToRGB(fg_bgr, mask_u8, bg_bgr, cv::Scalar(), feather_px, rgb, pool);
   return rgb;
 }
 
-static cv::Mat normalizedMaskedBlurChannel(const cv::Mat& ch, const cv::Mat& bg_mask, int k) {
-  const float eps = 1e-6f;
-  cv::Mat num = ch.mul(bg_mask);
+// Background-only blur: blur(frame*bg) / blur(bg) keeps the person from
+// bleeding into the blurred background. Returns 8UC3 BGR.
+static cv::Mat normalizedMaskedBlur(const cv::Mat& frame_bgr, const cv::Mat& bg_mask, int k,
+                                    FramePool* pool) {
+  const cv::Size sz = frame_bgr.size();
+  cv::Mat frame_f = AcquireFrame(pool, sz, CV_32FC3);
+  frame_bgr.convertTo(frame_f, CV_32FC3);
+  cv::Mat bg3 = AcquireFrame(pool, sz, CV_32FC3);
+  cv::Mat planes[] = {bg_mask, bg_mask, bg_mask};
+  cv::merge(planes, 3, bg3);
+  cv::Mat num = AcquireFrame(pool, sz, CV_32FC3);
+  cv::multiply(frame_f, bg3, num);
   cv::GaussianBlur(num, num, cv::Size(k,k), 0);
-  cv::Mat den; cv::GaussianBlur(bg_mask, den, cv::Size(k,k), 0);
-  den = den + eps;
-  return num / den;
+  cv::Mat den = AcquireFrame(pool, sz, CV_32FC1);
+  cv::GaussianBlur(bg_mask, den, cv::Size(k,k), 0);
+  cv::add(den, cv::Scalar::all(1e-6), den);
+  cv::Mat den_planes[] = {den, den, den};
+  cv::merge(den_planes, 3, bg3);  // reuse as 3-channel denominator
+  cv::divide(num, bg3, num);
+  cv::Mat out = AcquireFrame(pool, sz, CV_8UC3);
+  num.convertTo(out, CV_8UC3);
+  return out;
+}
+
+// Widths of three box filters whose convolution approximates a Gaussian of
+// this sigma (odd widths; the first `m` narrower, the rest wider by 2).
+static void boxesForGauss(double sigma, int widths[3]) {
+  const int n = 3;
+  double w_ideal = std::sqrt(12.0 * sigma * sigma / n + 1.0);
+  int wl = (int)std::floor(w_ideal);
+  if ((wl % 2) == 0) wl--;
+  wl = std::max(1, wl);
+  const int wu = wl + 2;
+  double m_ideal = (12.0 * sigma * sigma - n * wl * wl - 4.0 * n * wl - 3.0 * n) / (-4.0 * wl - 4.0);
+  int m = (int)std::lround(m_ideal);
+  for (int i = 0; i < n; ++i) widths[i] = (i < m) ? wl : wu;
+}
+
+// Sigma cv::GaussianBlur derives for ksize k, so all engines look alike
+static double gaussianSigmaForKernel(int k) {
+  return 0.3 * ((k - 1) * 0.5 - 1.0) + 0.8;
+}
+
+// Background-weighted frame as one 4-channel plane: (B*w, G*w, R*w, w) with
+// w = 1 - mask. The person contributes nothing (holes of weight 0).
+static cv::Mat premultipliedBackground(const cv::Mat& frame_bgr, const cv::Mat& mask_u8,
+                                       FramePool* pool) {
+  const cv::Size sz = frame_bgr.size();
+  cv::Mat acc = AcquireFrame(pool, sz, CV_32FC4);
+  segmecam::ForEachStrip(sz.height, sz.width * 20, [&](int y0, int y1) {
+    for (int y = y0; y < y1; ++y) {
+      const uint8_t* f = frame_bgr.ptr<uint8_t>(y);
+      const uint8_t* m = mask_u8.ptr<uint8_t>(y);
+      float* p = acc.ptr<float>(y);
+      for (int x = 0; x < sz.width; ++x, f += 3, p += 4) {
+        const float w = (255 - m[x]) * (1.0f / 255.0f);
+        p[0] = f[0] * w; p[1] = f[1] * w; p[2] = f[2] * w; p[3] = w;
+      }
+    }
+  });
+  return acc;
+}
+
+// normalizedMaskedBlur with stacked box filters. Numerator and denominator
+// travel as one premultiplied plane, so each pass is a single sweep;
+// cv::boxFilter keeps running sums, so a pass costs the same for any width.
+static cv::Mat normalizedMaskedBoxBlur(const cv::Mat& frame_bgr, const cv::Mat& mask_u8, int k,
+                                       FramePool* pool) {
+  const cv::Size sz = frame_bgr.size();
+  cv::Mat acc = premultipliedBackground(frame_bgr, mask_u8, pool);
+  const double sigma = gaussianSigmaForKernel(k);
+  int widths[3];
+  boxesForGauss(sigma, widths);
+  cv::Mat tmp = AcquireFrame(pool, sz, CV_32FC4);
+  cv::boxFilter(acc, tmp, -1, cv::Size(widths[0], widths[0]));
+  cv::boxFilter(tmp, acc, -1, cv::Size(widths[1], widths[1]));
+  cv::boxFilter(acc, tmp, -1, cv::Size(widths[2], widths[2]));
+
+  cv::Mat out = AcquireFrame(pool, sz, CV_8UC3);
+  segmecam::ForEachStrip(sz.height, sz.width * 19, [&](int y0, int y1) {
+    for (int y = y0; y < y1; ++y) {
+      const float* p = tmp.ptr<float>(y);
+      uint8_t* o = out.ptr<uint8_t>(y);
+      for (int x = 0; x < sz.width; ++x, p += 4, o += 3) {
+        const float inv = 1.0f / (p[3] + 1e-6f);
+        o[0] = cv::saturate_cast<uint8_t>(p[0] * inv);
+        o[1] = cv::saturate_cast<uint8_t>(p[1] * inv);
+        o[2] = cv::saturate_cast<uint8_t>(p[2] * inv);
+      }
+    }
+  });
+  return out;
+}
+
+// Push-pull pyramid blur of the background only.
+//
+// Push: pyrDown the premultiplied background (person = holes of weight 0)
+// to a few pixels. Pull: from the coarsest level up, fill each level's holes
+// with the upsampled coarser result ("over" on premultiplied colors), which
+// never brings the person back in. Stop at the level where the remaining
+// blur is small, blur there and pyrUp to full size: the Gaussian runs on
+// 1/4^level of the pixels, so a large radius stays cheap and halo-free.
+static cv::Mat pyramidMaskedBlur(const cv::Mat& frame_bgr, const cv::Mat& mask_u8, int k,
+                                 FramePool* pool) {
+  const double sigma = gaussianSigmaForKernel(k);
+  // Each octave down and back up is worth roughly 2^level px of blur
+  int blur_level = std::clamp((int)std::floor(std::log2(std::max(sigma, 1.0))) - 1, 1, 5);
+
+  std::vector<cv::Mat> levels;
+  levels.push_back(premultipliedBackground(frame_bgr, mask_u8, pool));
+  while (levels.back().cols > 4 && levels.back().rows > 4 && levels.size() < 12) {
+    cv::Size half((levels.back().cols + 1) / 2, (levels.back().rows + 1) / 2);
+    cv::Mat next = AcquireFrame(pool, half, CV_32FC4);
+    cv::pyrDown(levels.back(), next, half);
+    levels.push_back(next);
+  }
+  blur_level = std::min(blur_level, (int)levels.size() - 1);
+
+  // Coarsest level: plain normalization (only fully covered frames stay 0)
+  const cv::Mat& top = levels.back();
+  cv::Mat filled = AcquireFrame(pool, top.size(), CV_32FC3);
+  segmecam::ForEachStrip(top.rows, top.cols * 28, [&](int y0, int y1) {
+    for (int y = y0; y < y1; ++y) {
+      const float* p = top.ptr<float>(y);
+      float* c = filled.ptr<float>(y);
+      for (int x = 0; x < top.cols; ++x, p += 4, c += 3) {
+        const float inv = 1.0f / (p[3] + 1e-6f);
+        c[0] = p[0] * inv; c[1] = p[1] * inv; c[2] = p[2] * inv;
+      }
+    }
+  });
+  for (int l = (int)levels.size() - 2; l >= blur_level; --l) {
+    const cv::Mat& lvl = levels[l];
+    cv::Mat up = AcquireFrame(pool, lvl.size(), CV_32FC3);
+    cv::pyrUp(filled, up, lvl.size());
+    segmecam::ForEachStrip(lvl.rows, lvl.cols * 28, [&](int y0, int y1) {
+      for (int y = y0; y < y1; ++y) {
+        const float* p = lvl.ptr<float>(y);
+        float* u = up.ptr<float>(y);
+        for (int x = 0; x < lvl.cols; ++x, p += 4, u += 3) {
+          const float t = 1.0f - std::min(p[3], 1.0f);
+          u[0] = p[0] + t * u[0]; u[1] = p[1] + t * u[1]; u[2] = p[2] + t * u[2];
+        }
+      }
+    });
+    filled = up;
+  }
+
+  // Whatever the octaves did not cover, at the coarse level
+  const double covered = (double)(1 << blur_level);
+  const double residual = std::sqrt(std::max(0.0, sigma * sigma - covered * covered)) / covered;
+  if (residual > 0.5) {
+    cv::GaussianBlur(filled, filled, cv::Size(0, 0), residual);
+  }
+  cv::Mat img = AcquireFrame(pool, filled.size(), CV_8UC3);
+  filled.convertTo(img, CV_8UC3);
+  for (int l = blur_level - 1; l >= 0; --l) {
+    cv::Mat up = AcquireFrame(pool, levels[l].size(), CV_8UC3);
+    cv::pyrUp(img, up, levels[l].size());
+    img = up;
+  }
+  return img;
 }
 
 cv::Mat CompositeBlurBackgroundBGR(const cv::Mat& frame_bgr,
                                    const cv::Mat& mask_u8,
                                    int blur_strength,
-                                   float feather_px) {
-  cv::Mat frame_f; frame_bgr.convertTo(frame_f, CV_32FC3, 1.0/255.0);
-  cv::Mat mask_f; mask_u8.convertTo(mask_f, CV_32FC1, 1.0/255.0);
-  // Feather
-  int fks = (int)std::max(1.0f, feather_px) * 2 + 1;
-  if (feather_px > 0.5f) cv::GaussianBlur(mask_f, mask_f, cv::Size(fks,fks), 0);
-  cv::Mat bg_mask = 1.0f - mask_f;
+                                   float feather_px,
+                                   FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("composite.blur");
+  cv::Mat mask = featherMask(mask_u8, feather_px, pool);
+  cv::Mat inv_alpha = AcquireFrame(pool, mask.size(), CV_32FC1);
+  mask.convertTo(inv_alpha, CV_32FC1, -1.0/255.0, 1.0);
   int k = blur_strength | 1;
-  std::vector<cv::Mat> fch, out_ch(3);
-  cv::split(frame_f, fch);
-  for (int i=0;i<3;++i) {
-    cv::Mat bg_only = normalizedMaskedBlurChannel(fch[i], bg_mask, k);
-    out_ch[i] = fch[i].mul(mask_f) + bg_only.mul(1.0f - mask_f);
+  cv::Mat bg_only = normalizedMaskedBlur(frame_bgr, inv_alpha, k, pool);
+  return blendToRGB(frame_bgr, bg_only, mask, pool);
+}
+
+cv::Mat CompositeBlurBackgroundBGR_Box(const cv::Mat& frame_bgr,
+                                       const cv::Mat& mask_u8,
+                                       int blur_strength,
+                                       float feather_px,
+                                       FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("composite.blur_box");
+  cv::Mat mask = featherMask(mask_u8, feather_px, pool);
+  cv::Mat bg_only = normalizedMaskedBoxBlur(frame_bgr, mask, blur_strength | 1, pool);
+  return blendToRGB(frame_bgr, bg_only, mask, pool);
+}
+
+cv::Mat CompositeBlurBackgroundBGR_Pyramid(const cv::Mat& frame_bgr,
+                                           const cv::Mat& mask_u8,
+                                           int blur_strength,
+                                           float feather_px,
+                                           FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("composite.blur_pyramid");
+  cv::Mat mask = featherMask(mask_u8, feather_px, pool);
+  cv::Mat bg_only = pyramidMaskedBlur(frame_bgr, mask, blur_strength | 1, pool);
+  return blendToRGB(frame_bgr, bg_only, mask, pool);
+}
+
+cv::Mat FeatherMaskU8(const cv::Mat& mask_u8, float feather_px, FramePool* pool) {
+  return featherMask(mask_u8, feather_px, pool);
+}
+
+cv::Mat BlurredBackgroundPlateBGR(const cv::Mat& frame_bgr,
+                                  const cv::Mat& mask_u8,
+                                  int blur_strength,
+                                  int engine,
+                                  FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("composite.blur_plate");
+  const int k = blur_strength | 1;
+  switch (engine) {
+    case 1:
+      return normalizedMaskedBoxBlur(frame_bgr, mask_u8, k, pool);
+    case 2:
+      return pyramidMaskedBlur(frame_bgr, mask_u8, k, pool);
+    default: {
+      cv::Mat inv_alpha = AcquireFrame(pool, mask_u8.size(), CV_32FC1);
+      mask_u8.convertTo(inv_alpha, CV_32FC1, -1.0/255.0, 1.0);
+      return normalizedMaskedBlur(frame_bgr, inv_alpha, k, pool);
+    }
   }
-  cv::Mat comp_f; cv::merge(out_ch, comp_f);
-  cv::Mat comp_u8; comp_f.convertTo(comp_u8, CV_8UC3, 255.0);
-  cv::Mat rgb; cv::cvtColor(comp_u8, rgb, cv::COLOR_BGR2RGB);
-  return rgb;
 }
 
 cv::Mat CompositeBlurBackgroundBGR_Accel(const cv::Mat& frame_bgr,
@@ -101,112 +380,109 @@ cv::Mat CompositeBlurBackgroundBGR_Accel(const cv::Mat& frame_bgr,
                                          int blur_strength,
                                          float feather_px,
                                          bool use_ocl,
-                                         float scale) {
+                                         float scale,
+                                         FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("composite.blur_accel");
   scale = std::clamp(scale, 0.4f, 1.0f);
   if (!use_ocl && std::abs(scale - 1.0f) < 1e-3f) {
-    return CompositeBlurBackgroundBGR(frame_bgr, mask_u8, blur_strength, feather_px);
+    return CompositeBlurBackgroundBGR(frame_bgr, mask_u8, blur_strength, feather_px, pool);
   }
   int k = blur_strength | 1;
   // Optional downscale for speed
   cv::Mat small_src;
-  if (std::abs(scale - 1.0f) < 1e-3f) small_src = frame_bgr;
-  else cv::resize(frame_bgr, small_src, cv::Size(), scale, scale, (scale >= 0.85f)?cv::INTER_LINEAR:cv::INTER_AREA);
+  if (std::abs(scale - 1.0f) < 1e-3f) {
+    small_src = frame_bgr;
+  } else {
+    small_src = AcquireFrame(pool, scaledSize(frame_bgr.size(), scale), CV_8UC3);
+    cv::resize(frame_bgr, small_src, small_src.size(), 0, 0, (scale >= 0.85f)?cv::INTER_LINEAR:cv::INTER_AREA);
+  }
 
   if (!use_ocl) {
     // CPU path but with background computed at reduced res
-    cv::Mat small_blur; cv::GaussianBlur(small_src, small_blur, cv::Size(k,k), 0);
+    cv::Mat small_blur = AcquireFrame(pool, small_src.size(), CV_8UC3);
+    cv::GaussianBlur(small_src, small_blur, cv::Size(k,k), 0);
     cv::Mat blurred;
-    if (small_blur.size() != frame_bgr.size()) cv::resize(small_blur, blurred, frame_bgr.size(), 0,0, cv::INTER_LINEAR);
-    else blurred = small_blur;
-    // Normalized blend (same as baseline)
-    cv::Mat frame_f, blurred_f; frame_bgr.convertTo(frame_f, CV_32FC3, 1.0/255.0); blurred.convertTo(blurred_f, CV_32FC3, 1.0/255.0);
-    cv::Mat mask_f; mask_u8.convertTo(mask_f, CV_32FC1, 1.0/255.0);
-    int fks = (int)std::max(1.0f, feather_px) * 2 + 1; if (feather_px > 0.5f) cv::GaussianBlur(mask_f, mask_f, cv::Size(fks,fks), 0);
-    std::vector<cv::Mat> fch(3), bch(3), out(3); cv::split(frame_f, fch); cv::split(blurred_f, bch);
-    for (int i=0;i<3;++i) out[i] = fch[i].mul(mask_f) + bch[i].mul(1.0f - mask_f);
-    cv::Mat comp_f; cv::merge(out, comp_f); cv::Mat comp_u8; comp_f.convertTo(comp_u8, CV_8UC3, 255.0);
-    cv::Mat rgb; cv::cvtColor(comp_u8, rgb, cv::COLOR_BGR2RGB);
+    if (small_blur.size() != frame_bgr.size()) {
+      blurred = AcquireFrame(pool, frame_bgr.size(), CV_8UC3);
+      cv::resize(small_blur, blurred, frame_bgr.size(), 0,0, cv::INTER_LINEAR);
+    } else {
+      blurred = small_blur;
+    }
+    // Feather, blend and RGB conversion in one strip-parallel pass
+    cv::Mat rgb = blendToRGB(frame_bgr, blurred, mask_u8, pool, feather_px);
     
     // Debug output for blur composite
     static int blur_debug_count = 0;
     blur_debug_count++;
-    if (blur_debug_count <= 2 && !comp_u8.empty() && !rgb.empty()) {
-        cv::Vec3b bgr_pixel = comp_u8.at<cv::Vec3b>(comp_u8.rows/2, comp_u8.cols/2);
+    if (blur_debug_count <= 2 && !rgb.empty()) {
         cv::Vec3b rgb_pixel = rgb.at<cv::Vec3b>(rgb.rows/2, rgb.cols/2);
-        std::cout << "🔍 BLUR COMPOSITE " << blur_debug_count << " - BGR result: [" 
-                  << (int)bgr_pixel[0] << "," << (int)bgr_pixel[1] << "," << (int)bgr_pixel[2] 
-                  << "] -> RGB output: [" << (int)rgb_pixel[0] << "," << (int)rgb_pixel[1] << "," << (int)rgb_pixel[2] << "]" << std::endl;
+        std::cout << "🔍 BLUR COMPOSITE " << blur_debug_count << " - RGB output: ["
+                  << (int)rgb_pixel[0] << "," << (int)rgb_pixel[1] << "," << (int)rgb_pixel[2] << "]" << std::endl;
     }
     
     return rgb;
   }
-  // OpenCL path via UMat
+  // OpenCL path via UMat (device buffers are recycled by OpenCV's own buffer
+  // pool): blur and upscale on the device, then the same fused fixed-point
+  // feather/blend/RGB pass as the CPU path
   cv::UMat src_u; small_src.copyTo(src_u);
   cv::UMat blur_u; cv::GaussianBlur(src_u, blur_u, cv::Size(k,k), 0);
   cv::UMat blurred_u;
   if (blur_u.size() != frame_bgr.size()) cv::resize(blur_u, blurred_u, frame_bgr.size(), 0,0, cv::INTER_LINEAR);
   else blurred_u = blur_u;
-  cv::UMat frame_u; frame_bgr.copyTo(frame_u);
-  cv::UMat mask_u; mask_u8.copyTo(mask_u);
-  cv::UMat frame_f, blurred_f, mask_f; frame_u.convertTo(frame_f, CV_32FC3, 1.0/255.0); blurred_u.convertTo(blurred_f, CV_32FC3, 1.0/255.0);
-  mask_u.convertTo(mask_f, CV_32FC1, 1.0/255.0);
-  if (feather_px > 0.5f) {
-    int fks = (int)std::max(1.0f, feather_px) * 2 + 1; cv::GaussianBlur(mask_f, mask_f, cv::Size(fks,fks), 0);
-  }
-  std::vector<cv::UMat> ff(3), bf(3), out(3); cv::split(frame_f, ff); cv::split(blurred_f, bf);
-  cv::UMat one(mask_f.size(), mask_f.type()); one.setTo(1.0f);
-  cv::UMat inv; cv::subtract(one, mask_f, inv);
-  for (int i=0;i<3;++i) {
-    cv::UMat a,b; cv::multiply(ff[i], mask_f, a); cv::multiply(bf[i], inv, b); cv::add(a,b,out[i]);
-  }
-  cv::UMat comp_f; cv::merge(out, comp_f); cv::UMat comp_u8; comp_f.convertTo(comp_u8, CV_8UC3, 255.0);
-  cv::Mat comp_bgr; comp_u8.copyTo(comp_bgr);
-  cv::Mat rgb; cv::cvtColor(comp_bgr, rgb, cv::COLOR_BGR2RGB);
-  return rgb;
+  cv::Mat blurred = AcquireFrame(pool, frame_bgr.size(), CV_8UC3);
+  blurred_u.copyTo(blurred);
+  return blendToRGB(frame_bgr, blurred, mask_u8, pool, feather_px);
 }
 
 
 cv::Mat CompositeImageBackgroundBGR(const cv::Mat& frame_bgr,
                                     const cv::Mat& mask_u8,
-                                    const cv::Mat& bg_bgr) {
-  cv::Mat bg_resized; cv::resize(bg_bgr, bg_resized, frame_bgr.size(), 0, 0, cv::INTER_LINEAR);
-  cv::Mat frame_f, bg_f; frame_bgr.convertTo(frame_f, CV_32FC3, 1.0/255.0); bg_resized.convertTo(bg_f, CV_32FC3, 1.0/255.0);
-  cv::Mat mask_f; mask_u8.convertTo(mask_f, CV_32FC1, 1.0/255.0);
-  std::vector<cv::Mat> fch, bch, cch; cv::split(frame_f, fch); cv::split(bg_f, bch);
-  cch.resize(3);
-  for (int i=0;i<3;++i) cch[i] = fch[i].mul(mask_f) + bch[i].mul(1.0 - mask_f);
-  cv::Mat comp_f; cv::merge(cch, comp_f);
-  cv::Mat comp_u8; comp_f.convertTo(comp_u8, CV_8UC3, 255.0);
-  cv::Mat rgb; cv::cvtColor(comp_u8, rgb, cv::COLOR_BGR2RGB);
-  return rgb;
+                                    const cv::Mat& bg_bgr,
+                                    FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("composite.image");
+  cv::Mat bg_resized = bg_bgr;
+  if (bg_bgr.size() != frame_bgr.size()) {
+    bg_resized = AcquireFrame(pool, frame_bgr.size(), CV_8UC3);
+    cv::resize(bg_bgr, bg_resized, frame_bgr.size(), 0, 0, cv::INTER_LINEAR);
+  }
+  return blendToRGB(frame_bgr, bg_resized, mask_u8, pool);
 }
 
 cv::Mat CompositeSolidBackgroundBGR(const cv::Mat& frame_bgr,
                                     const cv::Mat& mask_u8,
-                                    const cv::Scalar& bgr) {
-  cv::Mat bg(frame_bgr.size(), CV_8UC3, bgr);
-  cv::Mat frame_f, bg_f; frame_bgr.convertTo(frame_f, CV_32FC3, 1.0/255.0); bg.convertTo(bg_f, CV_32FC3, 1.0/255.0);
-  cv::Mat mask_f; mask_u8.convertTo(mask_f, CV_32FC1, 1.0/255.0);
-  std::vector<cv::Mat> fch, bch, cch; cv::split(frame_f, fch); cv::split(bg_f, bch);
-  cch.resize(3);
-  for (int i=0;i<3;++i) cch[i] = fch[i].mul(mask_f) + bch[i].mul(1.0 - mask_f);
-  cv::Mat comp_f; cv::merge(cch, comp_f);
-  cv::Mat comp_u8; comp_f.convertTo(comp_u8, CV_8UC3, 255.0);
-  cv::Mat rgb; cv::cvtColor(comp_u8, rgb, cv::COLOR_BGR2RGB);
+                                    const cv::Scalar& bgr,
+                                    FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("composite.solid");
+  cv::Mat rgb = AcquireFrame(pool, frame_bgr.size(), CV_8UC3);
+  segmecam::CompositeStripsToRGB(frame_bgr, mask_u8, cv::Mat(), bgr, 0.0f, rgb, pool);
   return rgb;
 }
 
-// Optimized image background composite with scale optimization and caching
+// Reduced-resolution composite shared by the _Accel image/solid paths:
+// blend at small_frame size, then upsample the RGB result to full size.
+// An empty small_bg blends against color.
+static cv::Mat compositeScaledToRGB(const cv::Mat& small_frame, const cv::Mat& small_mask,
+                                    const cv::Mat& small_bg, const cv::Size& full_size,
+                                    FramePool* pool, const cv::Scalar& color = cv::Scalar()) {
+  cv::Mat rgb = AcquireFrame(pool, small_frame.size(), CV_8UC3);
+  segmecam::CompositeStripsToRGB(small_frame, small_mask, small_bg, color, 0.0f, rgb, pool);
+  if (rgb.size() == full_size) return rgb;
+  cv::Mat up = AcquireFrame(pool, full_size, CV_8UC3);
+  cv::resize(rgb, up, full_size, 0, 0, cv::INTER_LINEAR);
+  return up;
+}
+
+// Optimized image background composite with scale optimization. No caching
+// here: pass a plate already at the working size (AccelWorkingSize), e.g.
+// from EffectsManager's background asset cache, and no resize happens.
 cv::Mat CompositeImageBackgroundBGR_Accel(const cv::Mat& frame_bgr,
                                           const cv::Mat& mask_u8,
                                           const cv::Mat& bg_bgr,
                                           bool use_ocl,
-                                          float scale) {
-  // Static cache for resized background images
-  static cv::Mat cached_bg_resized;
-  static cv::Size cached_frame_size;
-  static cv::Mat cached_bg_original;
-  static bool cache_valid = false;
+                                          float scale,
+                                          FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("composite.image_accel");
   static int debug_call_count = 0;
   
   debug_call_count++;
@@ -216,94 +492,47 @@ cv::Mat CompositeImageBackgroundBGR_Accel(const cv::Mat& frame_bgr,
   // Debug first few calls to show optimization status
   if (debug_call_count <= 3) {
     std::cout << "🚀 IMAGE BG ACCEL " << debug_call_count << " - scale=" << scale 
-              << " opencl=" << use_ocl << " frame=" << frame_bgr.cols << "x" << frame_bgr.rows << std::endl;
-  }
-  
-  // Check if we can use cached background
-  bool need_resize = false;
-  if (!cache_valid || 
-      cached_frame_size != frame_bgr.size() ||
-      cached_bg_original.data != bg_bgr.data ||
-      cached_bg_original.size() != bg_bgr.size()) {
-    need_resize = true;
-    cache_valid = true;
-    cached_frame_size = frame_bgr.size();
-    cached_bg_original = bg_bgr.clone(); // Store copy for comparison
-    if (debug_call_count <= 3) {
-      std::cout << "🔄 IMAGE BG CACHE MISS - resizing background" << std::endl;
-    }
-  } else if (debug_call_count <= 3) {
-    std::cout << "✅ IMAGE BG CACHE HIT - using cached background" << std::endl;
-  }
-  
-  // Resize background if needed
-  if (need_resize) {
-    cv::resize(bg_bgr, cached_bg_resized, frame_bgr.size(), 0, 0, cv::INTER_LINEAR);
+              << " opencl=" << use_ocl << " frame=" << frame_bgr.cols << "x" << frame_bgr.rows
+              << " bg=" << bg_bgr.cols << "x" << bg_bgr.rows << std::endl;
   }
   
   // If scale optimization is disabled or OpenCL not available, use standard path
   if (!use_ocl && std::abs(scale - 1.0f) < 1e-3f) {
-    return CompositeImageBackgroundBGR(frame_bgr, mask_u8, cached_bg_resized);
+    return CompositeImageBackgroundBGR(frame_bgr, mask_u8, bg_bgr, pool);
   }
   
   // Scale optimization: work at reduced resolution for compositing
+  const cv::Size small_size = AccelWorkingSize(frame_bgr.size(), scale);
   cv::Mat small_frame, small_mask, small_bg;
-  if (std::abs(scale - 1.0f) < 1e-3f) {
+  if (small_size == frame_bgr.size()) {
     small_frame = frame_bgr;
     small_mask = mask_u8;
-    small_bg = cached_bg_resized;
   } else {
-    cv::resize(frame_bgr, small_frame, cv::Size(), scale, scale, 
+    small_frame = AcquireFrame(pool, small_size, CV_8UC3);
+    small_mask = AcquireFrame(pool, small_size, CV_8UC1);
+    cv::resize(frame_bgr, small_frame, small_size, 0, 0,
                (scale >= 0.85f) ? cv::INTER_LINEAR : cv::INTER_AREA);
-    cv::resize(mask_u8, small_mask, small_frame.size(), 0, 0, cv::INTER_LINEAR);
-    cv::resize(cached_bg_resized, small_bg, small_frame.size(), 0, 0, cv::INTER_LINEAR);
-  }
-  
-  // Perform compositing at reduced scale
-  cv::Mat frame_f, bg_f;
-  small_frame.convertTo(frame_f, CV_32FC3, 1.0/255.0);
-  small_bg.convertTo(bg_f, CV_32FC3, 1.0/255.0);
-  cv::Mat mask_f;
-  small_mask.convertTo(mask_f, CV_32FC1, 1.0/255.0);
-  
-  std::vector<cv::Mat> fch, bch, cch;
-  cv::split(frame_f, fch);
-  cv::split(bg_f, bch);
-  cch.resize(3);
-  
-  for (int i = 0; i < 3; ++i) {
-    cch[i] = fch[i].mul(mask_f) + bch[i].mul(1.0 - mask_f);
+    cv::resize(mask_u8, small_mask, small_size, 0, 0, cv::INTER_LINEAR);
   }
-  
-  cv::Mat comp_f;
-  cv::merge(cch, comp_f);
-  cv::Mat comp_u8;
-  comp_f.convertTo(comp_u8, CV_8UC3, 255.0);
-  
-  // Upscale result if needed
-  cv::Mat final_comp;
-  if (comp_u8.size() != frame_bgr.size()) {
-    cv::resize(comp_u8, final_comp, frame_bgr.size(), 0, 0, cv::INTER_LINEAR);
+  if (bg_bgr.size() == small_size) {
+    small_bg = bg_bgr;
   } else {
-    final_comp = comp_u8;
+    small_bg = AcquireFrame(pool, small_size, CV_8UC3);
+    cv::resize(bg_bgr, small_bg, small_size, 0, 0, cv::INTER_LINEAR);
   }
   
-  cv::Mat rgb;
-  cv::cvtColor(final_comp, rgb, cv::COLOR_BGR2RGB);
-  return rgb;
+  return compositeScaledToRGB(small_frame, small_mask, small_bg, frame_bgr.size(), pool);
 }
 
-// Optimized solid color background composite with scale optimization and caching
+// Optimized solid color background composite with scale optimization. The
+// color is blended directly, so no background plate is ever built.
 cv::Mat CompositeSolidBackgroundBGR_Accel(const cv::Mat& frame_bgr,
                                           const cv::Mat& mask_u8,
                                           const cv::Scalar& bgr,
                                           bool use_ocl,
-                                          float scale) {
-  // Static cache for solid color matrices
-  static cv::Mat cached_solid_bg;
-  static cv::Size cached_size;
-  static cv::Scalar cached_color;
-  static bool cache_valid = false;
+                                          float scale,
+                                          FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("composite.solid_accel");
   static int debug_call_count = 0;
   
   debug_call_count++;
@@ -316,75 +545,18 @@ cv::Mat CompositeSolidBackgroundBGR_Accel(const cv::Mat& frame_bgr,
               << " opencl=" << use_ocl << " frame=" << frame_bgr.cols << "x" << frame_bgr.rows << std::endl;
   }
   
-  // Check if we can use cached solid background
-  bool need_create = false;
-  if (!cache_valid || 
-      cached_size != frame_bgr.size() ||
-      cached_color != bgr) {
-    need_create = true;
-    cache_valid = true;
-    cached_size = frame_bgr.size();
-    cached_color = bgr;
-    if (debug_call_count <= 3) {
-      std::cout << "🔄 SOLID BG CACHE MISS - creating solid matrix" << std::endl;
-    }
-  } else if (debug_call_count <= 3) {
-    std::cout << "✅ SOLID BG CACHE HIT - using cached matrix" << std::endl;
-  }
-  
-  // Create solid background if needed
-  if (need_create) {
-    cached_solid_bg = cv::Mat(frame_bgr.size(), CV_8UC3, bgr);
-  }
-  
-  // If scale optimization is disabled or OpenCL not available, use standard path
-  if (!use_ocl && std::abs(scale - 1.0f) < 1e-3f) {
-    return CompositeSolidBackgroundBGR(frame_bgr, mask_u8, bgr);
-  }
-  
-  // Scale optimization: work at reduced resolution for compositing
-  cv::Mat small_frame, small_mask, small_bg;
+  // Full resolution: the fused CPU blend against the color beats an upload
   if (std::abs(scale - 1.0f) < 1e-3f) {
-    small_frame = frame_bgr;
-    small_mask = mask_u8;
-    small_bg = cached_solid_bg;
-  } else {
-    cv::resize(frame_bgr, small_frame, cv::Size(), scale, scale, 
-               (scale >= 0.85f) ? cv::INTER_LINEAR : cv::INTER_AREA);
-    cv::resize(mask_u8, small_mask, small_frame.size(), 0, 0, cv::INTER_LINEAR);
-    small_bg = cv::Mat(small_frame.size(), CV_8UC3, bgr);
-  }
-  
-  // Perform compositing at reduced scale
-  cv::Mat frame_f, bg_f;
-  small_frame.convertTo(frame_f, CV_32FC3, 1.0/255.0);
-  small_bg.convertTo(bg_f, CV_32FC3, 1.0/255.0);
-  cv::Mat mask_f;
-  small_mask.convertTo(mask_f, CV_32FC1, 1.0/255.0);
-  
-  std::vector<cv::Mat> fch, bch, cch;
-  cv::split(frame_f, fch);
-  cv::split(bg_f, bch);
-  cch.resize(3);
-  
-  for (int i = 0; i < 3; ++i) {
-    cch[i] = fch[i].mul(mask_f) + bch[i].mul(1.0 - mask_f);
+    return CompositeSolidBackgroundBGR(frame_bgr, mask_u8, bgr, pool);
   }
   
-  cv::Mat comp_f;
-  cv::merge(cch, comp_f);
-  cv::Mat comp_u8;
-  comp_f.convertTo(comp_u8, CV_8UC3, 255.0);
-  
-  // Upscale result if needed
-  cv::Mat final_comp;
-  if (comp_u8.size() != frame_bgr.size()) {
-    cv::resize(comp_u8, final_comp, frame_bgr.size(), 0, 0, cv::INTER_LINEAR);
-  } else {
-    final_comp = comp_u8;
-  }
+  // Scale optimization: work at reduced resolution for compositing
+  const cv::Size small_size = scaledSize(frame_bgr.size(), scale);
+  cv::Mat small_frame = AcquireFrame(pool, small_size, CV_8UC3);
+  cv::Mat small_mask = AcquireFrame(pool, small_size, CV_8UC1);
+  cv::resize(frame_bgr, small_frame, small_size, 0, 0,
+             (scale >= 0.85f) ? cv::INTER_LINEAR : cv::INTER_AREA);
+  cv::resize(mask_u8, small_mask, small_size, 0, 0, cv::INTER_LINEAR);
   
-  cv::Mat rgb;
-  cv::cvtColor(final_comp, rgb, cv::COLOR_BGR2RGB);
-  return rgb;
+  return compositeScaledToRGB(small_frame, small_mask, cv::Mat(), frame_bgr.size(), pool, bgr);
 }
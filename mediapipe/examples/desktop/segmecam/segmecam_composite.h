@@ -4,23 +4,68 @@
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/formats/image_frame.h"
 
-// Decode a MediaPipe mask (ImageFrame) into 8‑bit single‑channel mask in 0..255.
-// Logs channel selection for 4xU8 (e.g., SRGBA) once when log_once is provided.
-cv::Mat DecodeMaskToU8(const mediapipe::ImageFrame& mask,
-                       bool* logged_once = nullptr);
+namespace segmecam { class FramePool; }
+
+// All functions below take an optional FramePool: outputs and intermediates
+// are leased from it instead of freshly allocated (nullptr = plain cv::Mat).
+
+// Masks are decoded from the graph's ImageFrames by segmecam::MaskDecoder
+// (include/pipeline/mask_decoder.h); everything below takes 8-bit masks.
 
 // Resize mask to match a given frame size (linear).
-cv::Mat ResizeMaskToFrame(const cv::Mat& mask_u8, const cv::Size& frame_size);
+cv::Mat ResizeMaskToFrame(const cv::Mat& mask_u8, const cv::Size& frame_size,
+                          segmecam::FramePool* pool = nullptr);
+
+// Edge-aware alternative to ResizeMaskToFrame: fast guided filter with the
+// camera frame as guide. The linear model alpha = a * luma + b is fitted at
+// mask resolution against the downscaled frame, and a, b are upsampled and
+// applied to the full-resolution luma in one strip-parallel pass, so the
+// mask edge follows hair and other fine detail in the image instead of the
+// mask's own blocky outline. Returns an 8-bit mask of frame size.
+cv::Mat GuidedUpsampleMask(const cv::Mat& mask_u8, const cv::Mat& frame_bgr,
+                           segmecam::FramePool* pool = nullptr);
 
 // Visualize mask as RGB image for UI.
-cv::Mat VisualizeMaskRGB(const cv::Mat& mask_u8);
+cv::Mat VisualizeMaskRGB(const cv::Mat& mask_u8, segmecam::FramePool* pool = nullptr);
 
 // Background blur compositing without foreground bleed (normalized masked blur).
 // Returns RGB (8UC3).
 cv::Mat CompositeBlurBackgroundBGR(const cv::Mat& frame_bgr,
                                    const cv::Mat& mask_u8,
                                    int blur_strength,
-                                   float feather_px);
+                                   float feather_px,
+                                   segmecam::FramePool* pool = nullptr);
+
+// Same normalized masked blur with a constant-time engine: three stacked box
+// filters (running sums) approximating the Gaussian of kernel blur_strength,
+// so the cost per pixel does not grow with blur_strength. Returns RGB (8UC3).
+cv::Mat CompositeBlurBackgroundBGR_Box(const cv::Mat& frame_bgr,
+                                       const cv::Mat& mask_u8,
+                                       int blur_strength,
+                                       float feather_px,
+                                       segmecam::FramePool* pool = nullptr);
+
+// Same result via a mask-aware push-pull pyramid: the background is reduced
+// a few octaves with the person treated as holes, blurred at the coarse level
+// and brought back up. Large radius, no halo, a fraction of the pixel work.
+cv::Mat CompositeBlurBackgroundBGR_Pyramid(const cv::Mat& frame_bgr,
+                                           const cv::Mat& mask_u8,
+                                           int blur_strength,
+                                           float feather_px,
+                                           segmecam::FramePool* pool = nullptr);
+
+// Building blocks of the blur composites, for callers that keep the blurred
+// background across frames (see BackgroundBlurCache).
+// Feathered blend mask exactly as the blur composites use it.
+cv::Mat FeatherMaskU8(const cv::Mat& mask_u8, float feather_px, segmecam::FramePool* pool = nullptr);
+// Background-only blurred plate (BGR 8UC3) for an already feathered mask.
+// engine: 0=Gaussian, 1=Box, 2=Pyramid (as the composites above). Blend the
+// frame over it with CompositeImageBackgroundBGR.
+cv::Mat BlurredBackgroundPlateBGR(const cv::Mat& frame_bgr,
+                                  const cv::Mat& mask_u8,
+                                  int blur_strength,
+                                  int engine,
+                                  segmecam::FramePool* pool = nullptr);
 
 // Optional accelerated/background-scaled path. If use_ocl=true and OpenCV has OpenCL,
 // uses UMat for heavy ops. If scale < 1.0, computes blurred background at reduced res
@@ -30,28 +75,40 @@ cv::Mat CompositeBlurBackgroundBGR_Accel(const cv::Mat& frame_bgr,
                                          int blur_strength,
                                          float feather_px,
                                          bool use_ocl,
-                                         float scale);
+                                         float scale,
+                                         segmecam::FramePool* pool = nullptr);
 
 // Image background composite. bg_bgr must be same size or will be resized.
+// The image and solid composites (and their _Accel variants) accept mask_u8
+// at model resolution: it is upsampled strip by strip inside the blend.
 cv::Mat CompositeImageBackgroundBGR(const cv::Mat& frame_bgr,
                                     const cv::Mat& mask_u8,
-                                    const cv::Mat& bg_bgr);
+                                    const cv::Mat& bg_bgr,
+                                    segmecam::FramePool* pool = nullptr);
+
+// Size the _Accel composites work at for a processing scale (clamped to
+// 0.4..1 as they do): frame_size itself at scale 1.
+cv::Size AccelWorkingSize(const cv::Size& frame_size, float scale);
 
-// Optimized image background composite with scale optimization and caching.
+// Optimized image background composite with scale optimization. bg_bgr of
+// any size; one already at AccelWorkingSize is used without resizing.
 cv::Mat CompositeImageBackgroundBGR_Accel(const cv::Mat& frame_bgr,
                                           const cv::Mat& mask_u8,
                                           const cv::Mat& bg_bgr,
                                           bool use_ocl,
-                                          float scale);
+                                          float scale,
+                                         segmecam::FramePool* pool = nullptr);
 
 // Solid color background composite.
 cv::Mat CompositeSolidBackgroundBGR(const cv::Mat& frame_bgr,
                                     const cv::Mat& mask_u8,
-                                    const cv::Scalar& bgr);
+                                    const cv::Scalar& bgr,
+                                    segmecam::FramePool* pool = nullptr);
 
 // Optimized solid color background composite with scale optimization and caching.
 cv::Mat CompositeSolidBackgroundBGR_Accel(const cv::Mat& frame_bgr,
                                           const cv::Mat& mask_u8,
                                           const cv::Scalar& bgr,
                                           bool use_ocl,
-                                          float scale);
+                                          float scale,
+                                         segmecam::FramePool* pool = nullptr);
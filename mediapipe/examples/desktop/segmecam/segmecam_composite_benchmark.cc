@@ -0,0 +1,412 @@
+// Microbenchmarks for the per-pixel kernels in segmecam_composite and the
+// virtual camera's BGR->YUYV conversion.
+//
+// Every benchmark reports ns/px (wall time per output pixel) next to the
+// usual per-iteration time, so numbers are comparable across resolutions
+// and can be tracked between releases. Inputs are synthetic but shaped like
+// the live pipeline: a noisy camera frame and a soft person mask. Buffers
+// come from a FramePool, as in EffectsManager, so the steady state is timed
+// rather than allocation.
+//
+//   bazel run -c opt //mediapipe/examples/desktop/segmecam:segmecam_composite_benchmark -- \
+//     --benchmark_filter=Blur --benchmark_format=json
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "composite_kernels.h"
+#include "include/pipeline/frame_pool.h"
+#include "include/pipeline/mask_decoder.h"
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "segmecam_composite.h"
+#include "strip_compositor.h"
+#include "vcam.h"
+
+namespace segmecam {
+namespace {
+
+// Selfie segmentation (landscape) output size
+const cv::Size kMaskModelSize(256, 144);
+constexpr float kFeatherPx = 2.0f;
+
+// Benchmark args: resolution index into this table
+const cv::Size kResolutions[] = {{1280, 720}, {1920, 1080}, {3840, 2160}};
+
+void SetResolutionLabel(benchmark::State& state, const cv::Size& size) {
+  state.SetLabel(std::to_string(size.width) + "x" + std::to_string(size.height));
+}
+
+// Items/s plus ns per pixel. The counter is an inverted rate, i.e.
+// time / (value * iterations); scaling value by 1e-9 turns seconds into ns.
+void ReportPerPixel(benchmark::State& state, const cv::Size& size) {
+  const double pixels = (double)size.area();
+  state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)size.area());
+  state.counters["ns/px"] = benchmark::Counter(
+      pixels * 1e-9, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+struct Inputs {
+  cv::Mat frame_bgr;    // Camera frame
+  cv::Mat mask_u8;      // Person mask at frame size (after ResizeMaskToFrame)
+  cv::Mat model_mask;   // Person mask at model size (before ResizeMaskToFrame)
+  cv::Mat bg_bgr;       // Background image, deliberately not frame-sized
+};
+
+// Built once per size and shared by all benchmarks
+const Inputs& GetInputs(const cv::Size& size) {
+  static std::map<std::pair<int, int>, std::unique_ptr<Inputs>> cache;
+  auto& slot = cache[{size.width, size.height}];
+  if (slot) return *slot;
+
+  slot = std::make_unique<Inputs>();
+  Inputs& in = *slot;
+  cv::RNG rng(0x5e9e);
+  in.frame_bgr.create(size, CV_8UC3);
+  rng.fill(in.frame_bgr, cv::RNG::UNIFORM, 0, 256);
+  cv::GaussianBlur(in.frame_bgr, in.frame_bgr, cv::Size(5, 5), 0);
+
+  in.model_mask = cv::Mat::zeros(kMaskModelSize, CV_8UC1);
+  cv::ellipse(in.model_mask, cv::Point(kMaskModelSize.width / 2, kMaskModelSize.height),
+              cv::Size(kMaskModelSize.width / 4, kMaskModelSize.height * 3 / 4), 0, 180, 360,
+              cv::Scalar(255), cv::FILLED);
+  cv::GaussianBlur(in.model_mask, in.model_mask, cv::Size(9, 9), 0);
+  cv::resize(in.model_mask, in.mask_u8, size, 0, 0, cv::INTER_LINEAR);
+
+  in.bg_bgr.create(cv::Size(1600, 900), CV_8UC3);
+  for (int y = 0; y < in.bg_bgr.rows; ++y) {
+    in.bg_bgr.row(y).setTo(cv::Scalar(y * 255 / in.bg_bgr.rows, 96, 255 - y * 255 / in.bg_bgr.rows));
+  }
+  return in;
+}
+
+// ---------------------------------------------------------------------------
+// Mask decode / resize
+// ---------------------------------------------------------------------------
+
+// Args: mask format; each exercises one MaskDecoder::Decode branch
+void BM_MaskDecoder(benchmark::State& state) {
+  const auto format = static_cast<mediapipe::ImageFormat::Format>(state.range(0));
+  const cv::Size size = kMaskModelSize;
+  mediapipe::ImageFrame mask(format, size.width, size.height,
+                             mediapipe::ImageFrame::kDefaultAlignmentBoundary);
+  const cv::Mat& src = GetInputs(kResolutions[0]).model_mask;
+  for (int y = 0; y < size.height; ++y) {
+    uint8_t* row = mask.MutablePixelData() + (size_t)y * mask.WidthStep();
+    for (int x = 0; x < size.width; ++x) {
+      uint8_t v = src.at<uint8_t>(y, x);
+      switch (mask.NumberOfChannels() * 10 + mask.ByteDepth()) {
+        case 11: row[x] = v; break;
+        case 14: reinterpret_cast<float*>(row)[x] = v / 255.0f; break;
+        case 41: for (int c = 0; c < 4; ++c) row[x * 4 + c] = v; break;
+        default: for (int c = 0; c < mask.NumberOfChannels(); ++c)
+                   reinterpret_cast<float*>(row)[x * mask.NumberOfChannels() + c] = v / 255.0f;
+      }
+    }
+  }
+
+  FramePool pool;
+  MaskDecoder decoder;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out = decoder.Decode(mask, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  state.SetLabel(mediapipe::ImageFormat::Format_Name(format));
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_MaskDecoder)
+    ->Arg(mediapipe::ImageFormat::GRAY8)     // 1 x U8: copy
+    ->Arg(mediapipe::ImageFormat::VEC32F1)   // 1 x F32: scale + convert
+    ->Arg(mediapipe::ImageFormat::SRGBA)     // 4 x U8: channel pick
+    ->Arg(mediapipe::ImageFormat::VEC32F2);  // N x F32: strided first channel
+
+// 1 x U8 mask packet decoded as a view: no pixel pass at all
+void BM_MaskDecoderView(benchmark::State& state) {
+  const cv::Size size = kMaskModelSize;
+  auto frame = std::make_unique<mediapipe::ImageFrame>(
+      mediapipe::ImageFormat::GRAY8, size.width, size.height,
+      mediapipe::ImageFrame::kDefaultAlignmentBoundary);
+  const cv::Mat& src = GetInputs(kResolutions[0]).model_mask;
+  for (int y = 0; y < size.height; ++y) {
+    std::memcpy(frame->MutablePixelData() + (size_t)y * frame->WidthStep(), src.ptr<uint8_t>(y), size.width);
+  }
+  const mediapipe::Packet packet = mediapipe::Adopt(frame.release());
+  FramePool pool;
+  MaskDecoder decoder;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out = decoder.DecodeView(packet, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_MaskDecoderView);
+
+// Args: resolution
+void BM_ResizeMaskToFrame(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const Inputs& in = GetInputs(size);
+  FramePool pool;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out = ResizeMaskToFrame(in.model_mask, size, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_ResizeMaskToFrame)->DenseRange(0, 2);
+
+// ---------------------------------------------------------------------------
+// Background composites
+// ---------------------------------------------------------------------------
+
+// Args: resolution, blur kernel (blur_strength)
+void BM_CompositeBlur(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const int kernel = (int)state.range(1);
+  const Inputs& in = GetInputs(size);
+  FramePool pool;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out = CompositeBlurBackgroundBGR(in.frame_bgr, in.mask_u8, kernel, kFeatherPx, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_CompositeBlur)
+    ->ArgsProduct({{0, 1, 2}, {15, 31, 63}})
+    ->ArgNames({"res", "k"})
+    ->Unit(benchmark::kMillisecond);
+
+// Args: resolution, blur kernel; constant-time engine, so k should not matter
+void BM_CompositeBlur_Box(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const int kernel = (int)state.range(1);
+  const Inputs& in = GetInputs(size);
+  FramePool pool;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out = CompositeBlurBackgroundBGR_Box(in.frame_bgr, in.mask_u8, kernel, kFeatherPx, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_CompositeBlur_Box)
+    ->ArgsProduct({{0, 1, 2}, {15, 31, 63, 99}})
+    ->ArgNames({"res", "k"})
+    ->Unit(benchmark::kMillisecond);
+
+// Args: resolution, blur kernel
+void BM_CompositeBlur_Pyramid(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const int kernel = (int)state.range(1);
+  const Inputs& in = GetInputs(size);
+  FramePool pool;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out = CompositeBlurBackgroundBGR_Pyramid(in.frame_bgr, in.mask_u8, kernel, kFeatherPx, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_CompositeBlur_Pyramid)
+    ->ArgsProduct({{0, 1, 2}, {15, 31, 63, 99}})
+    ->ArgNames({"res", "k"})
+    ->Unit(benchmark::kMillisecond);
+
+// Args: resolution, blur kernel, processing scale in tenths (CPU path)
+void BM_CompositeBlur_Accel(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const int kernel = (int)state.range(1);
+  const float scale = (float)state.range(2) / 10.0f;
+  const Inputs& in = GetInputs(size);
+  FramePool pool;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out = CompositeBlurBackgroundBGR_Accel(in.frame_bgr, in.mask_u8, kernel, kFeatherPx,
+                                                   /*use_ocl=*/false, scale, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_CompositeBlur_Accel)
+    ->ArgsProduct({{0, 1, 2}, {15, 31, 63}, {4, 5, 6, 7, 8, 9, 10}})
+    ->ArgNames({"res", "k", "scale10"})
+    ->Unit(benchmark::kMillisecond);
+
+// Args: resolution, method (0 = bilinear resize + Gaussian feather as the
+// blur composites do it, 1 = guided upsampling, no feather)
+void BM_MaskUpsample(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const bool guided = state.range(1) != 0;
+  const Inputs& in = GetInputs(size);
+  FramePool pool;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out;
+    if (guided) {
+      out = GuidedUpsampleMask(in.model_mask, in.frame_bgr, &pool);
+    } else {
+      out = FeatherMaskU8(ResizeMaskToFrame(in.model_mask, size, &pool), kFeatherPx, &pool);
+    }
+    benchmark::DoNotOptimize(out.data);
+  }
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_MaskUpsample)
+    ->ArgsProduct({{0, 1, 2}, {0, 1}})
+    ->ArgNames({"res", "guided"});
+
+// Args: resolution; the fused blend alone (fg, bg, mask -> RGB)
+void BM_BlendMaskedToRGB(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const Inputs& in = GetInputs(size);
+  cv::Mat bg;
+  cv::resize(in.bg_bgr, bg, size, 0, 0, cv::INTER_LINEAR);
+  cv::Mat out;
+  for (auto _ : state) {
+    BlendMaskedToRGB(in.frame_bgr, bg, in.mask_u8, out);
+    benchmark::DoNotOptimize(out.data);
+  }
+  state.SetLabel(std::string(BlendKernelName()) + " " + std::to_string(size.width) + "x" +
+                 std::to_string(size.height));
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_BlendMaskedToRGB)->DenseRange(0, 2);
+
+// Args: resolution; the tile pre-pass the blends run first
+void BM_ClassifyMaskTiles(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const Inputs& in = GetInputs(size);
+  MaskTileMap map;
+  for (auto _ : state) {
+    ClassifyMaskTiles(in.mask_u8, map);
+    benchmark::DoNotOptimize(map.tiles.data());
+  }
+  state.counters["edge_tiles"] = map.EdgeFraction();
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_ClassifyMaskTiles)->DenseRange(0, 2);
+
+// Args: resolution; mask preview (show_mask)
+void BM_VisualizeMaskRGB(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const Inputs& in = GetInputs(size);
+  FramePool pool;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out = VisualizeMaskRGB(in.mask_u8, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_VisualizeMaskRGB)->DenseRange(0, 2);
+
+// Args: resolution, processing scale in tenths
+void BM_CompositeImage_Accel(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const float scale = (float)state.range(1) / 10.0f;
+  const Inputs& in = GetInputs(size);
+  FramePool pool;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out = CompositeImageBackgroundBGR_Accel(in.frame_bgr, in.mask_u8, in.bg_bgr,
+                                                    /*use_ocl=*/false, scale, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_CompositeImage_Accel)
+    ->ArgsProduct({{0, 1, 2}, {5, 10}})
+    ->ArgNames({"res", "scale10"})
+    ->Unit(benchmark::kMillisecond);
+
+// Args: resolution, processing scale in tenths
+void BM_CompositeSolid_Accel(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const float scale = (float)state.range(1) / 10.0f;
+  const Inputs& in = GetInputs(size);
+  FramePool pool;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    cv::Mat out = CompositeSolidBackgroundBGR_Accel(in.frame_bgr, in.mask_u8, cv::Scalar(64, 177, 0),
+                                                    /*use_ocl=*/false, scale, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_CompositeSolid_Accel)
+    ->ArgsProduct({{0, 1, 2}, {5, 10}})
+    ->ArgNames({"res", "scale10"})
+    ->Unit(benchmark::kMillisecond);
+
+// Args: resolution, mask source (0 = frame-sized, 1 = model size, upsampled
+// per strip), threads (OpenCV pool size; 0 = OpenCV default)
+void BM_CompositeStrips(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const Inputs& in = GetInputs(size);
+  const cv::Mat& mask = state.range(1) ? in.model_mask : in.mask_u8;
+  cv::Mat bg;
+  cv::resize(in.bg_bgr, bg, size, 0, 0, cv::INTER_LINEAR);
+  const int threads_before = cv::getNumThreads();
+  cv::setNumThreads((int)state.range(2));
+  FramePool pool;
+  cv::Mat out;
+  for (auto _ : state) {
+    pool.BeginFrame();
+    CompositeStripsToRGB(in.frame_bgr, mask, bg, cv::Scalar(), kFeatherPx, out, &pool);
+    benchmark::DoNotOptimize(out.data);
+  }
+  cv::setNumThreads(threads_before);
+  state.counters["strip_rows"] = StripRows(size.width * 11);
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_CompositeStrips)
+    ->ArgsProduct({{0, 1, 2}, {0, 1}, {1, 0}})
+    ->ArgNames({"res", "model_mask", "threads"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// ---------------------------------------------------------------------------
+// Virtual camera conversion
+// ---------------------------------------------------------------------------
+
+// Args: resolution (conversion only, no device write)
+void BM_VCamPackYUYV(benchmark::State& state) {
+  const cv::Size size = kResolutions[state.range(0)];
+  const Inputs& in = GetInputs(size);
+  std::vector<uint8_t> yuyv((size_t)size.area() * 2u);
+  for (auto _ : state) {
+    VCam::PackYUYV(in.frame_bgr, /*r_off=*/2, /*b_off=*/0, yuyv.data());
+    benchmark::DoNotOptimize(yuyv.data());
+    benchmark::ClobberMemory();
+  }
+  SetResolutionLabel(state, size);
+  ReportPerPixel(state, size);
+}
+BENCHMARK(BM_VCamPackYUYV)->DenseRange(0, 2);
+
+}  // namespace
+}  // namespace segmecam
+
+BENCHMARK_MAIN();
@@ -1,4 +1,5 @@
 #include "segmecam_face_effects.h"
+#include "composite_kernels.h"
 #include <cmath>
 
 namespace {
@@ -49,6 +50,71 @@ static void featherMask(cv::Mat& mask, int ksize) {
   int k = (ksize | 1);
   cv::GaussianBlur(mask, mask, cv::Size(k, k), 0);
 }
+
+// Bounding box of pts grown by pad on every side, clipped to bounds. The
+// effects below only touch this box; pad covers their filter support so the
+// result inside the box matches a full-frame run.
+static cv::Rect paddedBounds(const std::vector<cv::Point>& pts, int pad, const cv::Size& bounds) {
+  if (pts.empty()) return cv::Rect();
+  cv::Rect r = cv::boundingRect(pts);
+  r = cv::Rect(r.x - pad, r.y - pad, r.width + 2 * pad, r.height + 2 * pad);
+  return r & cv::Rect(0, 0, bounds.width, bounds.height);
+}
+
+// Fill a frame-coordinate polygon into a box-sized mask (offset = -box origin)
+static void fillRegion(cv::Mat& mask, const std::vector<cv::Point>& poly, double value, const cv::Point& offset) {
+  if (poly.empty()) return;
+  cv::fillPoly(mask, std::vector<std::vector<cv::Point>>{poly}, cv::Scalar(value), cv::LINE_8, 0, offset);
+}
+
+// Face oval minus lips and eyes, set to value, over roi
+static cv::Mat skinRegionMask(const FaceRegions& fr, const cv::Rect& roi, double value) {
+  cv::Mat mask(roi.size(), CV_8UC1, cv::Scalar(0));
+  const cv::Point offset = -roi.tl();
+  fillRegion(mask, fr.face_oval, value, offset);
+  fillRegion(mask, fr.lips_outer, 0, offset);
+  fillRegion(mask, fr.left_eye, 0, offset);
+  fillRegion(mask, fr.right_eye, 0, offset);
+  return mask;
+}
+
+// Support of BuildSkinWeightMap's gradient term (Sobel + sigma-1 blur)
+constexpr int kSkinMapPad = 8;
+
+// Support of BuildWrinkleLineMask: black-hat closes over twice the largest
+// line width, the gates and final blurs add a few pixels
+int wrinkleMaskPad(float max_scale_px) {
+  return 2 * (int)std::ceil(max_scale_px) + 12;
+}
+
+// Teeth whitening curves on 8-bit Lab (b: 128 is neutral): b moves toward
+// 128, L brightens. Rebuilt only when strength changes.
+struct TeethLuts {
+  float strength = -1.0f;
+  uint8_t b[256];
+  uint8_t L[256];
+};
+
+static const TeethLuts& teethLuts(float strength) {
+  thread_local TeethLuts luts;
+  if (luts.strength != strength) {
+    const float k = 0.35f * strength;
+    const float kL = 0.15f * strength;
+    for (int v = 0; v < 256; ++v) {
+      luts.b[v] = (uint8_t)std::clamp(128.0f + (v - 128.0f) * (1.0f - k), 0.0f, 255.0f);
+      luts.L[v] = (uint8_t)std::clamp(v * (1.0f + kL), 0.0f, 255.0f);
+    }
+    luts.strength = strength;
+  }
+  return luts;
+}
+
+// Line widths the advanced smoothing looks for (defaults follow radius_px)
+static void wrinkleScales(float radius_px, float line_min_px, float line_max_px, float* s_min, float* s_max) {
+  *s_min = (line_min_px > 0.0f) ? line_min_px : std::max(1.5f, radius_px * 0.5f);
+  *s_max = (line_max_px > 0.0f) ? line_max_px : std::max(3.0f, radius_px * 1.25f);
+  if (*s_max < *s_min) std::swap(*s_min, *s_max);
+}
 } // namespace
 
 bool ExtractFaceRegions(const mediapipe::NormalizedLandmarkList& lms,
@@ -69,6 +135,156 @@ bool ExtractFaceRegions(const mediapipe::NormalizedLandmarkList& lms,
   return !(out->face_oval.empty() || out->lips_outer.empty());
 }
 
+int SkinSmoothingPad() {
+  // Feather (7 px) and bilateral (4 px) reach
+  return 12;
+}
+
+int SkinSmoothingAdvPad(float radius_px,
+                        float edge_feather_px,
+                        float line_min_px,
+                        float line_max_px,
+                        bool with_landmarks) {
+  // Same padding as the scaled path, widened for the wrinkle mask
+  int pad = std::max(8, (int)std::round(edge_feather_px + radius_px * 2.0f));
+  if (with_landmarks) {
+    float s_min, s_max;
+    wrinkleScales(radius_px, line_min_px, line_max_px, &s_min, &s_max);
+    pad = std::max(pad, wrinkleMaskPad(std::max(1.0f, s_max)));
+  }
+  return pad;
+}
+
+int LipRefinerPad(float feather_px, float band_grow_px) {
+  // Dilate and both feather passes
+  return (int)std::ceil(std::max(0.0f, band_grow_px) + 2.0f * std::max(0.0f, feather_px)) + 2;
+}
+
+int TeethWhitenPad() {
+  // The feather reaches 2 px
+  return 4;
+}
+
+FaceEffectsContext::FaceEffectsContext(cv::Mat& frame_bgr, const FaceRegions& fr, int pad)
+    : FaceEffectsContext(frame_bgr.size(), fr, pad) {
+  frame_ = frame_bgr;
+}
+
+FaceEffectsContext::FaceEffectsContext(const cv::Size& frame_size, const FaceRegions& fr, int pad)
+    : frame_size_(frame_size), fr_(fr) {
+  std::vector<cv::Point> pts = fr.face_oval;
+  pts.insert(pts.end(), fr.lips_outer.begin(), fr.lips_outer.end());
+  box_ = paddedBounds(pts, std::max(0, pad), frame_size);
+}
+
+cv::Mat& FaceEffectsContext::MutableFrame() {
+  Commit();
+  lab_.clear();
+  lab_valid_ = cv::Rect();
+  gray_.release();
+  grad_x_.release();
+  grad_y_.release();
+  grad_mag_.release();
+  return frame_;
+}
+
+std::vector<cv::Mat>& FaceEffectsContext::Lab(const cv::Rect& local) {
+  if (lab_.empty()) {
+    lab_.resize(3);
+    for (cv::Mat& plane : lab_) plane.create(box_.size(), CV_8UC1);
+  }
+  if ((local & lab_valid_) == local) return lab_;
+  // Growing: commit first so that re-converting the old part keeps its edits
+  Commit();
+  lab_valid_ = lab_valid_.empty() ? local : (lab_valid_ | local);
+  cv::Mat lab; cv::cvtColor(frame_(box_)(lab_valid_), lab, cv::COLOR_BGR2Lab);
+  cv::Mat planes[3] = {lab_[0](lab_valid_), lab_[1](lab_valid_), lab_[2](lab_valid_)};
+  const int from_to[] = {0, 0, 1, 1, 2, 2};
+  cv::mixChannels(&lab, 1, planes, 3, from_to, 3);
+  return lab_;
+}
+
+void FaceEffectsContext::MarkLabDirty(const cv::Rect& local) {
+  lab_dirty_ = lab_dirty_.empty() ? local : (lab_dirty_ | local);
+}
+
+const cv::Mat& FaceEffectsContext::Gray() {
+  if (gray_.empty() && !box_.empty() && !frame_.empty()) cv::cvtColor(frame_(box_), gray_, cv::COLOR_BGR2GRAY);
+  return gray_;
+}
+
+const cv::Mat& FaceEffectsContext::GradX() {
+  if (grad_x_.empty() && !Gray().empty()) cv::Sobel(gray_, grad_x_, CV_32F, 1, 0, 3);
+  return grad_x_;
+}
+
+const cv::Mat& FaceEffectsContext::GradY() {
+  if (grad_y_.empty() && !Gray().empty()) cv::Sobel(gray_, grad_y_, CV_32F, 0, 1, 3);
+  return grad_y_;
+}
+
+const cv::Mat& FaceEffectsContext::GradMag() {
+  if (grad_mag_.empty() && !Gray().empty()) cv::magnitude(GradX(), GradY(), grad_mag_);
+  return grad_mag_;
+}
+
+const cv::Mat& FaceEffectsContext::SkinMask() {
+  if (skin_mask_.empty()) skin_mask_ = skinRegionMask(fr_, box_, 255);
+  return skin_mask_;
+}
+
+const cv::Mat& FaceEffectsContext::SkinEdgeWeight(float edge_feather_px) {
+  if (skin_edge_.empty() || skin_edge_px_ != edge_feather_px) {
+    const cv::Mat& base = SkinMask();
+    // Inside distances, normalized by edge_feather_px; into a new buffer,
+    // skin_edge_ may be shared with a cache
+    cv::Mat dist;
+    cv::distanceTransform(base, dist, cv::DIST_L2, 3);
+    float ef = std::max(1.0f, edge_feather_px);
+    cv::Mat weight; dist.convertTo(weight, CV_32FC1, 1.0f / ef);
+    cv::threshold(weight, weight, 1.0, 1.0, cv::THRESH_TRUNC);
+    // Zero out weights where outside face
+    cv::Mat base_f; base.convertTo(base_f, CV_32FC1, 1.0/255.0);
+    skin_edge_ = weight.mul(base_f);
+    skin_edge_px_ = edge_feather_px;
+  }
+  return skin_edge_;
+}
+
+void FaceEffectsContext::SetSkinGeometry(const cv::Mat& skin_mask,
+                                         const cv::Mat& edge_weight,
+                                         float edge_feather_px) {
+  skin_mask_ = skin_mask;
+  skin_edge_ = edge_weight;
+  skin_edge_px_ = edge_feather_px;
+}
+
+const cv::Mat& FaceEffectsContext::FaceOvalMask() {
+  if (face_oval_mask_.empty()) {
+    face_oval_mask_ = cv::Mat(box_.size(), CV_8UC1, cv::Scalar(0));
+    fillRegion(face_oval_mask_, fr_.face_oval, 255, -box_.tl());
+  }
+  return face_oval_mask_;
+}
+
+const cv::Mat& FaceEffectsContext::LipsInnerMask() {
+  if (lips_inner_mask_.empty()) {
+    lips_inner_mask_ = cv::Mat(box_.size(), CV_8UC1, cv::Scalar(0));
+    fillRegion(lips_inner_mask_, fr_.lips_inner, 255, -box_.tl());
+  }
+  return lips_inner_mask_;
+}
+
+void FaceEffectsContext::Commit() {
+  if (lab_dirty_.empty()) return;
+  const cv::Rect r = lab_dirty_;
+  std::vector<cv::Mat> planes = {lab_[0](r), lab_[1](r), lab_[2](r)};
+  cv::Mat lab; cv::merge(planes, lab);
+  cv::Mat dst = frame_(box_)(r);
+  cv::cvtColor(lab, dst, cv::COLOR_Lab2BGR);
+  lab_dirty_ = cv::Rect();
+}
+
 void ApplyLipRefinerBGR(cv::Mat& frame_bgr,
                         const FaceRegions& fr,
                         const cv::Scalar& color_bgr,
@@ -78,6 +294,21 @@ void ApplyLipRefinerBGR(cv::Mat& frame_bgr,
                         float band_grow_px,
                         const mediapipe::NormalizedLandmarkList& lms,
                         const cv::Size& frame_size) {
+  (void)frame_size;  // Always frame_bgr's size
+  FaceEffectsContext ctx(frame_bgr, fr, LipRefinerPad(feather_px, band_grow_px));
+  ApplyLipRefinerBGR(ctx, color_bgr, strength, feather_px, lightness, band_grow_px, lms);
+  ctx.Commit();
+}
+
+void ApplyLipRefinerBGR(FaceEffectsContext& ctx,
+                        const cv::Scalar& color_bgr,
+                        float strength,
+                        float feather_px,
+                        float lightness,
+                        float band_grow_px,
+                        const mediapipe::NormalizedLandmarkList& lms) {
+  const FaceRegions& fr = ctx.Regions();
+  const cv::Size frame_size = ctx.FrameSize();
   strength = std::clamp(strength, 0.0f, 1.0f);
   if (strength <= 0.0f || fr.lips_outer.empty()) return;
 
@@ -106,15 +337,19 @@ void ApplyLipRefinerBGR(cv::Mat& frame_bgr,
   static const int INNER_LO[] = {78,191,80,81,82,13,312,311,310,415,308};
   std::vector<int> ou(OUTER_UP, OUTER_UP+11), ol(OUTER_LO, OUTER_LO+11), iu(INNER_UP, INNER_UP+11), il(INNER_LO, INNER_LO+11);
 
-  cv::Mat mask(frame_bgr.size(), CV_8UC1, cv::Scalar(0));
-  if (!ou.empty() && !iu.empty()) {
-    auto poly_top = make_poly(ou, iu);
-    cv::fillPoly(mask, std::vector<std::vector<cv::Point>>{poly_top}, cv::Scalar(255));
-  }
-  if (!ol.empty() && !il.empty()) {
-    auto poly_bot = make_poly(ol, il);
-    cv::fillPoly(mask, std::vector<std::vector<cv::Point>>{poly_bot}, cv::Scalar(255));
-  }
+  auto poly_top = make_poly(ou, iu);
+  auto poly_bot = make_poly(ol, il);
+
+  // Work in the mouth box only, grown by the dilate and both feather passes
+  std::vector<cv::Point> lips_pts = poly_top;
+  lips_pts.insert(lips_pts.end(), poly_bot.begin(), poly_bot.end());
+  cv::Rect box = paddedBounds(lips_pts, LipRefinerPad(feather_px, band_grow_px), frame_size) & ctx.Box();
+  if (box.empty()) return;
+  const cv::Rect r = ctx.Local(box);
+
+  cv::Mat mask(box.size(), CV_8UC1, cv::Scalar(0));
+  fillRegion(mask, poly_top, 255, -box.tl());
+  fillRegion(mask, poly_bot, 255, -box.tl());
   // Slight dilate to unify seam between halves
   if (band_grow_px > 0.5f) {
     int k = std::max(1, (int)std::round(band_grow_px));
@@ -124,45 +359,51 @@ void ApplyLipRefinerBGR(cv::Mat& frame_bgr,
   if (feather_px > 0.5f) featherMask(mask, (int)std::round(feather_px));
   if (feather_px > 0.5f) featherMask(mask, (int)std::round(feather_px));
 
-  // Convert to LAB for perceptual color shift
-  cv::Mat lab; cv::cvtColor(frame_bgr, lab, cv::COLOR_BGR2Lab);
-  std::vector<cv::Mat> ch; cv::split(lab, ch); // L(0..255), a(0..255), b(0..255)
-  cv::Mat mask_f; mask.convertTo(mask_f, CV_32FC1, (float)strength / 255.0f); // scaled by strength
+  // Blend weight 0..255: the feathered lip mask scaled by strength
+  cv::Mat weight; mask.convertTo(weight, CV_8U, strength);
 
-  // Convert target color to Lab
+  // Target color in Lab
   cv::Mat patch(1,1,CV_8UC3, color_bgr);
   cv::Mat patch_lab; cv::cvtColor(patch, patch_lab, cv::COLOR_BGR2Lab);
   cv::Vec3b labv = patch_lab.at<cv::Vec3b>(0,0);
-  float La = (float)labv[0];
-  float Aa = (float)labv[1];
-  float Ba = (float)labv[2];
-
-  // Prepare float channels
-  cv::Mat Lf, Af, Bf; ch[0].convertTo(Lf, CV_32F); ch[1].convertTo(Af, CV_32F); ch[2].convertTo(Bf, CV_32F);
-
-  // Blend a/b toward target using mask_f
-  Af = Af.mul(1.0f - mask_f) + (Aa * mask_f);
-  Bf = Bf.mul(1.0f - mask_f) + (Ba * mask_f);
 
-  // Optional lightness adjustment on L (in Lab units)
-  float dL = std::clamp(lightness, -1.0f, 1.0f) * 25.0f; // typical gentle range
-  if (std::abs(dL) > 1e-3f) Lf = Lf + dL * mask_f;
-
-  // Merge back
-  cv::Mat L8, A8, B8; Lf.convertTo(L8, CV_8U); Af.convertTo(A8, CV_8U); Bf.convertTo(B8, CV_8U);
-  std::vector<cv::Mat> merged = {L8, A8, B8};
-  cv::merge(merged, lab);
-  cv::cvtColor(lab, frame_bgr, cv::COLOR_Lab2BGR);
+  // a/b pulled toward the target, L shifted by lightness (Lab units, gentle
+  // range), each as a LUT blended in by weight in 16-bit fixed point
+  const int dL = (int)std::lround(std::clamp(lightness, -1.0f, 1.0f) * 25.0f);
+  uint8_t lut_l[256], lut_a[256], lut_b[256];
+  for (int v = 0; v < 256; ++v) {
+    lut_l[v] = cv::saturate_cast<uint8_t>(v + dL);
+    lut_a[v] = labv[1];
+    lut_b[v] = labv[2];
+  }
+  std::vector<cv::Mat>& lab = ctx.Lab(r);
+  cv::Mat L = lab[0](r), A = lab[1](r), B = lab[2](r); // L(0..255), a(0..255), b(0..255)
+  segmecam::BlendLutMasked(A, lut_a, weight);
+  segmecam::BlendLutMasked(B, lut_b, weight);
+  if (dL != 0) segmecam::BlendLutMasked(L, lut_l, weight);
+  ctx.MarkLabDirty(r);
 }
 
 void ApplyTeethWhitenBGR(cv::Mat& frame_bgr,
                          const FaceRegions& fr,
                          float strength,
                          float shrink_px) {
+  FaceEffectsContext ctx(frame_bgr, fr, TeethWhitenPad());
+  ApplyTeethWhitenBGR(ctx, strength, shrink_px);
+  ctx.Commit();
+}
+
+void ApplyTeethWhitenBGR(FaceEffectsContext& ctx,
+                         float strength,
+                         float shrink_px) {
+  const FaceRegions& fr = ctx.Regions();
   strength = std::clamp(strength, 0.0f, 1.0f);
   if (strength <= 0.0f || fr.lips_inner.empty()) return;
-  cv::Mat mask(frame_bgr.size(), CV_8UC1, cv::Scalar(0));
-  cv::fillPoly(mask, std::vector<std::vector<cv::Point>>{fr.lips_inner}, cv::Scalar(255));
+  // Inner-mouth box only
+  cv::Rect box = paddedBounds(fr.lips_inner, TeethWhitenPad(), ctx.FrameSize()) & ctx.Box();
+  if (box.empty()) return;
+  const cv::Rect r = ctx.Local(box);
+  cv::Mat mask = ctx.LipsInnerMask()(r).clone();
   // Erode to avoid lips bleed into whitening
   if (shrink_px > 0.5f) {
     int k = std::max(1, (int)std::round(shrink_px));
@@ -170,62 +411,47 @@ void ApplyTeethWhitenBGR(cv::Mat& frame_bgr,
     cv::erode(mask, mask, ker);
   }
   featherMask(mask, 5);
-  // Convert to LAB and nudge b* toward blue (reduce yellow), slight L* increase.
-  cv::Mat lab; cv::cvtColor(frame_bgr, lab, cv::COLOR_BGR2Lab);
-  std::vector<cv::Mat> ch; cv::split(lab, ch);
-  // ch[0]=L 0..255, ch[1]=a 0..255, ch[2]=b 0..255 (128 is neutral)
-  // Move b toward 128 by factor, and slightly increase L.
-  const float k = 0.35f * strength;
-  const float kL = 0.15f * strength;
-  ch[2].forEach<uchar>([&](uchar &pix, const int pos[]) {
-    int y = pos[0], x = pos[1];
-    if (mask.at<uchar>(y, x) == 0) return;
-    float b = pix;
-    b = 128.0f + (b - 128.0f) * (1.0f - k);
-    pix = (uchar)std::clamp(b, 0.0f, 255.0f);
-  });
-  ch[0].forEach<uchar>([&](uchar &pix, const int pos[]) {
-    int y = pos[0], x = pos[1];
-    if (mask.at<uchar>(y, x) == 0) return;
-    float L = pix * (1.0f + kL);
-    pix = (uchar)std::clamp(L, 0.0f, 255.0f);
-  });
-  cv::merge(ch, lab);
-  cv::cvtColor(lab, frame_bgr, cv::COLOR_Lab2BGR);
+  // Nudge b* toward blue (reduce yellow) in the shared LAB planes, slight L* increase,
+  // blended by the feathered mask
+  const TeethLuts& luts = teethLuts(strength);
+  std::vector<cv::Mat>& lab = ctx.Lab(r);
+  cv::Mat L = lab[0](r), B = lab[2](r);
+  segmecam::BlendLutMasked(B, luts.b, mask);
+  segmecam::BlendLutMasked(L, luts.L, mask);
+  ctx.MarkLabDirty(r);
 }
 
 void ApplySkinSmoothingBGR(cv::Mat& frame_bgr,
                            const FaceRegions& fr,
                            float strength,
                            bool use_ocl) {
+  FaceEffectsContext ctx(frame_bgr, fr, SkinSmoothingPad());
+  ApplySkinSmoothingBGR(ctx, strength, use_ocl);
+  ctx.Commit();
+}
+
+void ApplySkinSmoothingBGR(FaceEffectsContext& ctx,
+                           float strength,
+                           bool use_ocl) {
+  const FaceRegions& fr = ctx.Regions();
   strength = std::clamp(strength, 0.0f, 1.0f);
   if (strength <= 0.0f || fr.face_oval.empty()) return;
-  cv::Mat mask(frame_bgr.size(), CV_8UC1, cv::Scalar(0));
-  std::vector<std::vector<cv::Point>> face = {fr.face_oval};
-  cv::fillPoly(mask, face, cv::Scalar(220));
-  if (!fr.lips_outer.empty()) {
-    std::vector<std::vector<cv::Point>> lips = {fr.lips_outer};
-    cv::fillPoly(mask, lips, cv::Scalar(0));
-  }
-  if (!fr.left_eye.empty()) {
-    std::vector<std::vector<cv::Point>> e = {fr.left_eye};
-    cv::fillPoly(mask, e, cv::Scalar(0));
-  }
-  if (!fr.right_eye.empty()) {
-    std::vector<std::vector<cv::Point>> e = {fr.right_eye};
-    cv::fillPoly(mask, e, cv::Scalar(0));
-  }
+  cv::Rect box = paddedBounds(fr.face_oval, SkinSmoothingPad(), ctx.FrameSize()) & ctx.Box();
+  if (box.empty()) return;
+  cv::Mat mask; ctx.SkinMask()(ctx.Local(box)).convertTo(mask, CV_8U, 220.0 / 255.0);
+  // Bilateral works on BGR, so this one writes the frame directly
+  cv::Mat roi = ctx.MutableFrame()(box);
   featherMask(mask, 15);
   // Bilateral filter strength mapping
   int d = 9;
   double sigmaColor = 25.0 + 75.0 * strength;
   double sigmaSpace = 9.0 + 21.0 * strength;
   if (!use_ocl) {
-    cv::Mat smooth; cv::bilateralFilter(frame_bgr, smooth, d, sigmaColor, sigmaSpace);
+    cv::Mat smooth; cv::bilateralFilter(roi, smooth, d, sigmaColor, sigmaSpace);
     // Blend only where mask applies (do math in float)
     cv::Mat mask_f; mask.convertTo(mask_f, CV_32FC1, 1.0/255.0);
     std::vector<cv::Mat> fch(3), sch(3), of(3);
-    cv::split(frame_bgr, fch); cv::split(smooth, sch);
+    cv::split(roi, fch); cv::split(smooth, sch);
     for (int i = 0; i < 3; ++i) {
       cv::Mat f32, s32;
       fch[i].convertTo(f32, CV_32FC1, 1.0/255.0);
@@ -233,10 +459,10 @@ void ApplySkinSmoothingBGR(cv::Mat& frame_bgr,
       of[i] = f32.mul(1.0f - mask_f) + s32.mul(mask_f);
     }
     cv::Mat comp_f; cv::merge(of, comp_f);
-    comp_f.convertTo(frame_bgr, CV_8UC3, 255.0);
+    comp_f.convertTo(roi, CV_8UC3, 255.0);
   } else {
     // OpenCL path using Transparent API (UMat).
-    cv::UMat src; frame_bgr.copyTo(src);
+    cv::UMat src; roi.copyTo(src);
     cv::UMat smooth_u; cv::bilateralFilter(src, smooth_u, d, sigmaColor, sigmaSpace);
     cv::UMat mask_u; mask.copyTo(mask_u);
     cv::UMat mask_f; mask_u.convertTo(mask_f, CV_32FC1, 1.0/255.0);
@@ -257,93 +483,89 @@ void ApplySkinSmoothingBGR(cv::Mat& frame_bgr,
     }
     cv::UMat comp_f; cv::merge(of, comp_f);
     cv::UMat comp_u8; comp_f.convertTo(comp_u8, CV_8UC3, 255.0);
-    comp_u8.copyTo(frame_bgr);
+    comp_u8.copyTo(roi);
   }
 }
 
-cv::Mat BuildSkinWeightMap(const FaceRegions& fr,
-                           const cv::Size& frame_size,
-                           float edge_feather_px,
-                           float texture_thresh,
-                           const cv::Mat& hint_bgr) {
-  cv::Mat base(frame_size, CV_8UC1, cv::Scalar(0));
-  if (!fr.face_oval.empty()) {
-    cv::fillPoly(base, std::vector<std::vector<cv::Point>>{fr.face_oval}, cv::Scalar(255));
-  }
-  if (!fr.lips_outer.empty()) cv::fillPoly(base, std::vector<std::vector<cv::Point>>{fr.lips_outer}, cv::Scalar(0));
-  if (!fr.left_eye.empty())   cv::fillPoly(base, std::vector<std::vector<cv::Point>>{fr.left_eye},   cv::Scalar(0));
-  if (!fr.right_eye.empty())  cv::fillPoly(base, std::vector<std::vector<cv::Point>>{fr.right_eye},  cv::Scalar(0));
-
-  // Edge feather via distance transform: inside distances, normalized by edge_feather_px
-  cv::Mat dist;
-  cv::distanceTransform(base, dist, cv::DIST_L2, 3);
-  float ef = std::max(1.0f, edge_feather_px);
-  cv::Mat weight_edge; dist.convertTo(weight_edge, CV_32FC1, 1.0f / ef);
-  cv::threshold(weight_edge, weight_edge, 1.0, 1.0, cv::THRESH_TRUNC);
-  // Zero out weights where outside face
+// BuildSkinWeightMap over r (context coordinates) only, from the context's
+// skin mask and gradients (no texture term in a geometry-only context)
+static cv::Mat skinWeightMap(FaceEffectsContext& ctx,
+                             const cv::Rect& r,
+                             float edge_feather_px,
+                             float texture_thresh) {
+  const cv::Mat base = ctx.SkinMask()(r);
+
+  // Edge feather from the skin mask border
+  const cv::Mat weight_edge = ctx.SkinEdgeWeight(edge_feather_px)(r);
   cv::Mat base_f; base.convertTo(base_f, CV_32FC1, 1.0/255.0);
-  weight_edge = weight_edge.mul(base_f);
 
-  // Texture-aware suppression: compute gradient magnitude on hint or base image
-  cv::Mat gray;
-  if (!hint_bgr.empty()) {
-    cv::cvtColor(hint_bgr, gray, cv::COLOR_BGR2GRAY);
-  } else {
-    gray = cv::Mat(frame_size, CV_8UC1, cv::Scalar(0));
-  }
-  cv::Mat gx, gy; if (!gray.empty()) {
-    cv::Sobel(gray, gx, CV_32F, 1, 0, 3);
-    cv::Sobel(gray, gy, CV_32F, 0, 1, 3);
+  cv::Mat weight;
+  if (ctx.GradMag().empty()) {
+    weight = weight_edge.clone();
   } else {
-    gx = cv::Mat::zeros(frame_size, CV_32F);
-    gy = cv::Mat::zeros(frame_size, CV_32F);
+    // Texture-aware suppression from the gradient magnitude,
+    // smoothed to avoid salt-and-pepper
+    cv::Mat mag; cv::GaussianBlur(ctx.GradMag()(r), mag, cv::Size(0,0), 1.0);
+    // Robust normalization based on mean magnitude; if gradients are tiny,
+    // fall back to a gentle scale so weights don't collapse.
+    cv::Scalar meanMag = cv::mean(mag, base_f > 0.0f);
+    float scale = (float)std::max(8.0, meanMag[0] * 3.0 + 1e-3); // pixels-intensity heuristic
+    cv::Mat mag_n; mag.convertTo(mag_n, CV_32F, 1.0f / scale);
+    // Texture keep in 0..1: higher keeps more texture. Map to attenuation factor.
+    float t = std::clamp(texture_thresh, 0.01f, 1.0f);
+    // wtex decays smoothly with gradient; avoid zeroing out completely.
+    cv::Mat wtex = 1.0f / (1.0f + (mag_n / t));
+    wtex = cv::min(wtex, 1.0f);
+    weight = weight_edge.mul(wtex);
   }
-  cv::Mat mag; cv::magnitude(gx, gy, mag);
-  // Smooth gradients to avoid salt-and-pepper
-  cv::GaussianBlur(mag, mag, cv::Size(0,0), 1.0);
-  // Robust normalization based on mean magnitude; if gradients are tiny,
-  // fall back to a gentle scale so weights don't collapse.
-  cv::Scalar meanMag = cv::mean(mag, base_f > 0.0f);
-  float scale = (float)std::max(8.0, meanMag[0] * 3.0 + 1e-3); // pixels-intensity heuristic
-  cv::Mat mag_n; mag.convertTo(mag_n, CV_32F, 1.0f / scale);
-  // Texture keep in 0..1: higher keeps more texture. Map to attenuation factor.
-  float t = std::clamp(texture_thresh, 0.01f, 1.0f);
-  // wtex decays smoothly with gradient; avoid zeroing out completely.
-  cv::Mat wtex = 1.0f / (1.0f + (mag_n / t));
-  wtex = cv::min(wtex, 1.0f);
-
-  cv::Mat weight = weight_edge.mul(wtex);
   // Ensure a baseline weight inside the face so effect is visible
   weight = cv::max(weight, 0.15f * base_f);
-  // If still extremely low on average, drop texture suppression entirely
-  if (cv::mean(weight)[0] < 0.02) weight = weight_edge;
+  // If still extremely low on average over the whole frame, drop texture suppression entirely
+  double coverage = (double)r.area() / ctx.FrameSize().area();
+  if (cv::mean(weight)[0] * coverage < 0.02) weight = weight_edge.clone();
   return weight; // CV_32F in [0,1]
 }
 
-cv::Mat BuildWrinkleLineMask(const cv::Mat& frame_bgr,
-                             const FaceRegions& fr,
-                             float min_scale_px,
-                             float max_scale_px,
-                             bool suppress_lower_face,
-                             float lower_face_ratio,
-                             bool ignore_glasses,
-                             float glasses_margin_px,
-                             float keep_ratio,
-                             bool use_skin_gate,
-                             float mask_gain) {
-  cv::Size sz = frame_bgr.size();
+cv::Mat BuildSkinWeightMap(const FaceRegions& fr,
+                           const cv::Size& frame_size,
+                           float edge_feather_px,
+                           float texture_thresh,
+                           const cv::Mat& hint_bgr) {
+  cv::Mat weight(frame_size, CV_32FC1, cv::Scalar(0));
+  // Read only: nothing is committed. Without a hint there is no texture
+  // term, so the context only needs the geometry.
+  cv::Mat hint = hint_bgr;
+  FaceEffectsContext ctx = hint.empty() ? FaceEffectsContext(frame_size, fr, kSkinMapPad)
+                                        : FaceEffectsContext(hint, fr, kSkinMapPad);
+  if (ctx.Empty()) return weight;
+  skinWeightMap(ctx, ctx.Local(ctx.Box()), edge_feather_px, texture_thresh).copyTo(weight(ctx.Box()));
+  return weight;
+}
+
+// BuildWrinkleLineMask over r (context coordinates) only, from the context's
+// skin mask, L plane and gradients (read before any Lab edits)
+static cv::Mat wrinkleLineMask(FaceEffectsContext& ctx,
+                               const cv::Rect& r,
+                               float min_scale_px,
+                               float max_scale_px,
+                               bool suppress_lower_face,
+                               float lower_face_ratio,
+                               bool ignore_glasses,
+                               float glasses_margin_px,
+                               float keep_ratio,
+                               bool use_skin_gate,
+                               float mask_gain) {
+  const FaceRegions& fr = ctx.Regions();
+  const cv::Rect roi = r + ctx.Origin();  // frame coordinates
+  cv::Size sz = roi.size();
   min_scale_px = std::max(1.0f, min_scale_px);
   max_scale_px = std::max(min_scale_px, max_scale_px);
 
   // Base face region mask (uint8)
-  cv::Mat base(sz, CV_8U, cv::Scalar(0));
-  if (!fr.face_oval.empty()) cv::fillPoly(base, std::vector<std::vector<cv::Point>>{fr.face_oval}, cv::Scalar(255));
-  if (!fr.lips_outer.empty()) cv::fillPoly(base, std::vector<std::vector<cv::Point>>{fr.lips_outer}, cv::Scalar(0));
-  if (!fr.left_eye.empty())   cv::fillPoly(base, std::vector<std::vector<cv::Point>>{fr.left_eye},   cv::Scalar(0));
-  if (!fr.right_eye.empty())  cv::fillPoly(base, std::vector<std::vector<cv::Point>>{fr.right_eye},  cv::Scalar(0));
+  const cv::Mat base = ctx.SkinMask()(r);
 
   // Skin gating (suppress textiles, hair/stubble). Quick YCrCb thresholds.
-  cv::Mat ycrcb; cv::cvtColor(frame_bgr, ycrcb, cv::COLOR_BGR2YCrCb);
+  cv::Mat ycrcb; cv::cvtColor(ctx.Bgr()(r), ycrcb, cv::COLOR_BGR2YCrCb);
   std::vector<cv::Mat> yc; cv::split(ycrcb, yc);
   cv::Mat skin;
   {
@@ -356,10 +578,8 @@ cv::Mat BuildWrinkleLineMask(const cv::Mat& frame_bgr,
     cv::morphologyEx(skin, skin, cv::MORPH_CLOSE, ker);
   }
 
-  // Convert to LAB -> L channel (8U)
-  cv::Mat lab; cv::cvtColor(frame_bgr, lab, cv::COLOR_BGR2Lab);
-  std::vector<cv::Mat> ch; cv::split(lab, ch);
-  cv::Mat L8 = ch[0];
+  // LAB L channel (8U); a copy, so the black-hat below pads at the box edge
+  const cv::Mat L8 = ctx.Lab(r)[0](r).clone();
 
   // Multi-scale black-hat to emphasize dark narrow lines
   std::vector<float> scales;
@@ -380,8 +600,7 @@ cv::Mat BuildWrinkleLineMask(const cv::Mat& frame_bgr,
   }
 
   // Orientation coherence via structure tensor to prefer line-like over blotchy
-  cv::Mat gray; cv::cvtColor(frame_bgr, gray, cv::COLOR_BGR2GRAY);
-  cv::Mat gx, gy; cv::Sobel(gray, gx, CV_32F, 1, 0, 3); cv::Sobel(gray, gy, CV_32F, 0, 1, 3);
+  const cv::Mat gx = ctx.GradX()(r), gy = ctx.GradY()(r);
   cv::Mat Jxx, Jyy, Jxy; cv::GaussianBlur(gx.mul(gx), Jxx, cv::Size(0,0), 1.5);
   cv::GaussianBlur(gy.mul(gy), Jyy, cv::Size(0,0), 1.5);
   cv::GaussianBlur(gx.mul(gy), Jxy, cv::Size(0,0), 1.5);
@@ -398,7 +617,7 @@ cv::Mat BuildWrinkleLineMask(const cv::Mat& frame_bgr,
   if (suppress_lower_face && !fr.face_oval.empty() && !fr.lips_outer.empty()) {
     int mouth_y = 0; for (const auto& p : fr.lips_outer) mouth_y += p.y; mouth_y = (int)std::round((double)mouth_y / std::max(1,(int)fr.lips_outer.size()));
     int chin_y = 0; for (const auto& p : fr.face_oval) chin_y = std::max(chin_y, p.y);
-    int cut_y = mouth_y + (int)std::round(std::clamp(lower_face_ratio, 0.2f, 0.8f) * (chin_y - mouth_y));
+    int cut_y = mouth_y + (int)std::round(std::clamp(lower_face_ratio, 0.2f, 0.8f) * (chin_y - mouth_y)) - roi.y;
     extra_gate = cv::Mat::zeros(sz, CV_32F);
     cv::rectangle(extra_gate, cv::Rect(0,0,sz.width, std::max(0, cut_y)), cv::Scalar(1.0f), cv::FILLED);
   }
@@ -410,9 +629,8 @@ cv::Mat BuildWrinkleLineMask(const cv::Mat& frame_bgr,
     if (!fr.left_eye.empty()) er = rect_of(fr.left_eye);
     if (!fr.right_eye.empty()) er = er.area() ? (er | rect_of(fr.right_eye)) : rect_of(fr.right_eye);
     int m = (int)std::round(std::max(0.0f, glasses_margin_px));
-    er.x = std::max(0, er.x - m); er.y = std::max(0, er.y - m);
-    er.width = std::min(sz.width - er.x, er.width + 2*m);
-    er.height = std::min(sz.height - er.y, er.height + 2*m);
+    er = cv::Rect(er.x - m - roi.x, er.y - m - roi.y, er.width + 2*m, er.height + 2*m);
+    er &= cv::Rect(0, 0, sz.width, sz.height);
     // Zero inside the band
     cv::rectangle(extra_gate, er, cv::Scalar(0.0f), cv::FILLED);
     // Feather edges slightly for smooth transition
@@ -453,6 +671,27 @@ cv::Mat BuildWrinkleLineMask(const cv::Mat& frame_bgr,
   return wr; // CV_32F [0,1]
 }
 
+cv::Mat BuildWrinkleLineMask(const cv::Mat& frame_bgr,
+                             const FaceRegions& fr,
+                             float min_scale_px,
+                             float max_scale_px,
+                             bool suppress_lower_face,
+                             float lower_face_ratio,
+                             bool ignore_glasses,
+                             float glasses_margin_px,
+                             float keep_ratio,
+                             bool use_skin_gate,
+                             float mask_gain) {
+  cv::Mat wr(frame_bgr.size(), CV_32F, cv::Scalar(0));
+  cv::Mat frame = frame_bgr;  // Read only: nothing is committed
+  FaceEffectsContext ctx(frame, fr, wrinkleMaskPad(std::max(min_scale_px, max_scale_px)));
+  if (ctx.Empty()) return wr;
+  wrinkleLineMask(ctx, ctx.Local(ctx.Box()), min_scale_px, max_scale_px, suppress_lower_face,
+                  lower_face_ratio, ignore_glasses, glasses_margin_px, keep_ratio,
+                  use_skin_gate, mask_gain).copyTo(wr(ctx.Box()));
+  return wr;
+}
+
 void ApplySkinSmoothingAdvBGR(cv::Mat& frame_bgr,
                               const FaceRegions& fr,
                               float amount,
@@ -477,14 +716,58 @@ void ApplySkinSmoothingAdvBGR(cv::Mat& frame_bgr,
                               bool use_skin_gate,
                               float mask_gain,
                               float neg_atten_cap) {
+  FaceEffectsContext ctx(frame_bgr, fr, SkinSmoothingAdvPad(radius_px, edge_feather_px, line_min_px, line_max_px, lms != nullptr));
+  ApplySkinSmoothingAdvBGR(ctx, amount, radius_px, texture_thresh, edge_feather_px, lms,
+                           smile_boost, squint_boost, forehead_boost, boost_gain,
+                           suppress_lower_face, lower_face_ratio, ignore_glasses, glasses_margin_px,
+                           keep_ratio, line_min_px, line_max_px, forehead_margin_px, wrinkle_preview,
+                           baseline_boost, use_skin_gate, mask_gain, neg_atten_cap);
+  ctx.Commit();
+}
+
+void ApplySkinSmoothingAdvBGR(FaceEffectsContext& ctx,
+                              float amount,
+                              float radius_px,
+                              float texture_thresh,
+                              float edge_feather_px,
+                              const mediapipe::NormalizedLandmarkList* lms,
+                              float smile_boost,
+                              float squint_boost,
+                              float forehead_boost,
+                              float boost_gain,
+                              bool suppress_lower_face,
+                              float lower_face_ratio,
+                              bool ignore_glasses,
+                              float glasses_margin_px,
+                              float keep_ratio,
+                              float line_min_px,
+                              float line_max_px,
+                              float forehead_margin_px,
+                              bool wrinkle_preview,
+                              float baseline_boost,
+                              bool use_skin_gate,
+                              float mask_gain,
+                              float neg_atten_cap) {
+  const FaceRegions& fr = ctx.Regions();
   amount = std::clamp(amount, 0.0f, 1.0f);
   if (amount <= 0.0f || fr.face_oval.empty()) return;
 
-  cv::Mat weight = BuildSkinWeightMap(fr, frame_bgr.size(), edge_feather_px, texture_thresh, frame_bgr);
-  // Prepare LAB
-  cv::Mat lab; cv::cvtColor(frame_bgr, lab, cv::COLOR_BGR2Lab);
-  std::vector<cv::Mat> ch; cv::split(lab, ch);
-  cv::Mat Lf; ch[0].convertTo(Lf, CV_32F, 1.0/255.0);
+  float s_min, s_max;
+  wrinkleScales(radius_px, line_min_px, line_max_px, &s_min, &s_max);
+
+  // Everything below runs on the padded face box; the rest of the frame is untouched
+  const cv::Size frame_size = ctx.FrameSize();
+  cv::Rect box = paddedBounds(fr.face_oval,
+                              SkinSmoothingAdvPad(radius_px, edge_feather_px, line_min_px, line_max_px, lms != nullptr),
+                              frame_size) & ctx.Box();
+  if (box.empty()) return;
+  const cv::Rect r = ctx.Local(box);
+  const cv::Point origin = box.tl();
+
+  cv::Mat weight = skinWeightMap(ctx, r, edge_feather_px, texture_thresh);
+  // L from the shared LAB planes
+  cv::Mat L8 = ctx.Lab(r)[0](r);
+  cv::Mat Lf; L8.convertTo(Lf, CV_32F, 1.0/255.0);
 
   // Base (low-pass) via Gaussian with radius ~ sigma (or identity in preview)
   int k = std::max(1, (int)std::round(radius_px) * 2 + 1);
@@ -495,11 +778,11 @@ void ApplySkinSmoothingAdvBGR(cv::Mat& frame_bgr,
   cv::Mat atten = weight * amount; // CV_32F (base smoothing)
   // Build wrinkle-aware attenuation whenever landmarks are available (independent of smile/squint)
   if (lms) {
-    const int W = frame_bgr.cols, H = frame_bgr.rows;
+    const int W = frame_size.width, H = frame_size.height;
     auto pt = [&](int idx){
       idx = std::clamp(idx, 0, lms->landmark_size()-1);
       const auto& p = lms->landmark(idx);
-      return cv::Point(std::clamp((int)std::round(p.x()*W), 0, W-1), std::clamp((int)std::round(p.y()*H), 0, H-1));
+      return cv::Point(std::clamp((int)std::round(p.x()*W), 0, W-1), std::clamp((int)std::round(p.y()*H), 0, H-1)) - origin;
     };
     auto dist = [&](const cv::Point& a, const cv::Point& b){ return std::hypot((double)a.x-b.x, (double)a.y-b.y); };
     // Key points
@@ -520,12 +803,12 @@ void ApplySkinSmoothingAdvBGR(cv::Mat& frame_bgr,
     float squint_f = (float)std::clamp((0.22 - aperture) / 0.12, 0.0, 1.0);
 
     // Build boost maps for nasolabial (mouth corners) and crow's-feet (outer eye corners)
-    cv::Mat boost(frame_bgr.size(), CV_32F, cv::Scalar(0));
+    cv::Mat boost(r.size(), CV_32F, cv::Scalar(0));
     int r_naso = std::max(3, (int)std::round(0.08 * eyeSpan));
     // Slightly larger to make effect visible at eyes
     int r_crow = std::max(3, (int)std::round(0.08 * eyeSpan));
     if (smile_boost > 0.0f && smile_f > 0.0f) {
-      cv::Mat m(frame_bgr.size(), CV_8U, cv::Scalar(0));
+      cv::Mat m(r.size(), CV_8U, cv::Scalar(0));
       cv::circle(m, mouthL, r_naso, cv::Scalar(255), cv::FILLED, cv::LINE_AA);
       cv::circle(m, mouthR, r_naso, cv::Scalar(255), cv::FILLED, cv::LINE_AA);
       cv::GaussianBlur(m, m, cv::Size(0,0), r_naso*0.5);
@@ -535,7 +818,7 @@ void ApplySkinSmoothingAdvBGR(cv::Mat& frame_bgr,
     // Consider eye corner boost from squint AND a fraction of smile
     float eff_squint = std::max(squint_f, 0.5f * smile_f);
     if (squint_boost > 0.0f && eff_squint > 0.0f) {
-      cv::Mat m(frame_bgr.size(), CV_8U, cv::Scalar(0));
+      cv::Mat m(r.size(), CV_8U, cv::Scalar(0));
       cv::circle(m, eyeLO, r_crow, cv::Scalar(255), cv::FILLED, cv::LINE_AA);
       cv::circle(m, eyeRO, r_crow, cv::Scalar(255), cv::FILLED, cv::LINE_AA);
       cv::GaussianBlur(m, m, cv::Size(0,0), r_crow*0.5);
@@ -544,19 +827,15 @@ void ApplySkinSmoothingAdvBGR(cv::Mat& frame_bgr,
     }
     // Optional forehead boost focusing on horizontal wrinkles
     if (forehead_boost > 0.0f && !fr.face_oval.empty()) {
-      int topY = frame_bgr.rows, minEyeY = frame_bgr.rows;
+      int topY = H, minEyeY = H;
       for (const auto& p : fr.face_oval) topY = std::min(topY, p.y);
       if (!fr.left_eye.empty()) for (const auto& p : fr.left_eye) minEyeY = std::min(minEyeY, p.y);
       if (!fr.right_eye.empty()) for (const auto& p : fr.right_eye) minEyeY = std::min(minEyeY, p.y);
-      int cut = std::max(0, std::min(frame_bgr.rows-1, minEyeY - (int)std::round(std::max(0.0f, forehead_margin_px))));
-      cv::Mat band(frame_bgr.size(), CV_8U, cv::Scalar(0));
-      std::vector<std::vector<cv::Point>> polys = {fr.face_oval};
-      cv::fillPoly(band, polys, cv::Scalar(255));
-      cv::rectangle(band, cv::Rect(0, cut, frame_bgr.cols, frame_bgr.rows-cut), cv::Scalar(0), cv::FILLED);
+      int cut = std::max(0, std::min(H-1, minEyeY - (int)std::round(std::max(0.0f, forehead_margin_px)))) - origin.y;
+      cv::Mat band = ctx.FaceOvalMask()(r).clone();
+      cv::rectangle(band, cv::Rect(0, cut, r.width, r.height-cut), cv::Scalar(0), cv::FILLED);
       // Prefer horizontal lines: use vertical gradient magnitude on grayscale
-      cv::Mat gray_fh; cv::cvtColor(frame_bgr, gray_fh, cv::COLOR_BGR2GRAY);
-      cv::Mat gy; cv::Sobel(gray_fh, gy, CV_32F, 0, 1, 3);
-      cv::GaussianBlur(gy, gy, cv::Size(0,0), 1.0);
+      cv::Mat gy; cv::GaussianBlur(ctx.GradY()(r), gy, cv::Size(0,0), 1.0);
       cv::Mat gy_abs = cv::abs(gy);
       double meanGy = cv::mean(gy_abs, band)[0];
       float gy_scale = (float)std::max(8.0, meanGy * 3.0 + 1e-3);
@@ -572,29 +851,23 @@ void ApplySkinSmoothingAdvBGR(cv::Mat& frame_bgr,
     boost = cv::min(boost, 1.0f);
     // Wrinkle awareness: emphasize dark, narrow, linear structures.
     // 1) Negative detail + gradient gate (local, fast)
-    cv::Mat gray_hint; cv::cvtColor(frame_bgr, gray_hint, cv::COLOR_BGR2GRAY);
-    cv::Mat gx2, gy2; cv::Sobel(gray_hint, gx2, CV_32F, 1, 0, 3); cv::Sobel(gray_hint, gy2, CV_32F, 0, 1, 3);
-    cv::Mat grad_mag; cv::magnitude(gx2, gy2, grad_mag);
-    cv::GaussianBlur(grad_mag, grad_mag, cv::Size(0,0), std::max(1.0f, radius_px*0.5f));
+    cv::Mat grad_mag; cv::GaussianBlur(ctx.GradMag()(r), grad_mag, cv::Size(0,0), std::max(1.0f, radius_px*0.5f));
     cv::Mat dark = cv::max(0.0f, -detail);
     cv::GaussianBlur(dark, dark, cv::Size(0,0), std::max(1.0f, radius_px*0.5f));
     cv::Mat dark_n; dark.convertTo(dark_n, CV_32F, 1.0f/0.12f); dark_n = cv::min(dark_n, 1.0f);
-    double gm_mean = cv::mean(grad_mag)[0];
+    double gm_mean = cv::mean(grad_mag)[0]; // Over the face box: background clutter no longer counts
     float gm_scale = (float)std::max(8.0, gm_mean * 3.0 + 1e-3);
     cv::Mat grad_n; grad_mag.convertTo(grad_n, CV_32F, 1.0f / gm_scale); grad_n = cv::min(grad_n, 1.0f);
     cv::Mat wrinkle_local = cv::min(dark_n, grad_n);
     // 2) Line-sensitive mask (multi-scale black-hat + coherence)
-    float s_min = (line_min_px > 0.0f) ? line_min_px : std::max(1.5f, radius_px * 0.5f);
-    float s_max = (line_max_px > 0.0f) ? line_max_px : std::max(3.0f, radius_px * 1.25f);
-    if (s_max < s_min) std::swap(s_min, s_max);
-    cv::Mat wrinkle_line = BuildWrinkleLineMask(frame_bgr, fr, s_min, s_max,
-                                                /*suppress_lower_face=*/suppress_lower_face,
-                                                /*lower_face_ratio=*/lower_face_ratio,
-                                                /*ignore_glasses=*/ignore_glasses,
-                                                /*glasses_margin_px=*/glasses_margin_px,
-                                                /*keep_ratio=*/keep_ratio,
-                                                /*use_skin_gate=*/use_skin_gate,
-                                                /*mask_gain=*/mask_gain);
+    cv::Mat wrinkle_line = wrinkleLineMask(ctx, r, s_min, s_max,
+                                           /*suppress_lower_face=*/suppress_lower_face,
+                                           /*lower_face_ratio=*/lower_face_ratio,
+                                           /*ignore_glasses=*/ignore_glasses,
+                                           /*glasses_margin_px=*/glasses_margin_px,
+                                           /*keep_ratio=*/keep_ratio,
+                                           /*use_skin_gate=*/use_skin_gate,
+                                           /*mask_gain=*/mask_gain);
     // Combine local and line masks with sensitivity: higher keep_ratio favors line mask
     float s = std::clamp(keep_ratio, 0.02f, 0.80f);
     float s_norm = (s - 0.02f) / (0.78f); // 0..1
@@ -627,7 +900,6 @@ void ApplySkinSmoothingAdvBGR(cv::Mat& frame_bgr,
   cv::Mat neg_atten = cv::min(cap, atten);
   cv::Mat outL = base + detail_pos.mul(1.0f - pos_atten) + detail_neg.mul(1.0f - neg_atten);
   outL = cv::min(cv::max(outL, 0.0f), 1.0f);
-  outL.convertTo(ch[0], CV_8U, 255.0);
-  cv::merge(ch, lab);
-  cv::cvtColor(lab, frame_bgr, cv::COLOR_Lab2BGR);
+  outL.convertTo(L8, CV_8U, 255.0);
+  ctx.MarkLabDirty(r);
 }
@@ -29,6 +29,82 @@ cv::Mat BuildWrinkleBoostMap(const mediapipe::NormalizedLandmarkList& lms,
                              float smile_boost,
                              float squint_boost);
 
+// The effects and maps below only process a padded box around the face oval
+// (the mouth for lips and teeth); pixels outside it are never read or written.
+
+// Margin each effect reads around its region, for sizing a FaceEffectsContext.
+int SkinSmoothingPad();
+int SkinSmoothingAdvPad(float radius_px,
+                        float edge_feather_px,
+                        float line_min_px = -1.0f,
+                        float line_max_px = -1.0f,
+                        bool with_landmarks = true);
+int LipRefinerPad(float feather_px, float band_grow_px);
+int TeethWhitenPad();
+
+// Per-frame state shared by the face effects so that colour conversions,
+// gradients and region masks are computed once however many effects run.
+// Covers the face oval (and mouth) grown by pad; everything is built lazily,
+// in Box() coordinates, on first use, and the Lab planes only over the part
+// effects ask for (so lips alone convert just the mouth). Lab-based effects
+// edit the planes in place and mark what they touched; Commit() converts that
+// part back to BGR in a single pass. Gray and gradients describe the frame as it was when
+// they were first requested. fr must outlive the context.
+class FaceEffectsContext {
+ public:
+  // pad: at least the largest *Pad() of the effects that will run
+  FaceEffectsContext(cv::Mat& frame_bgr, const FaceRegions& fr, int pad);
+  // Geometry only, for a frame of frame_size that is not at hand: the region
+  // masks work, the pixel accessors (Bgr, Lab, Gray, gradients) stay empty
+  FaceEffectsContext(const cv::Size& frame_size, const FaceRegions& fr, int pad);
+
+  const FaceRegions& Regions() const { return fr_; }
+  cv::Size FrameSize() const { return frame_size_; }
+  const cv::Rect& Box() const { return box_; }     // frame coordinates
+  cv::Point Origin() const { return box_.tl(); }
+  bool Empty() const { return box_.empty(); }
+  // frame_rect clipped to Box(), in Box() coordinates
+  cv::Rect Local(const cv::Rect& frame_rect) const { return (frame_rect & box_) - box_.tl(); }
+
+  // BGR pixels of Box(), without uncommitted Lab edits
+  cv::Mat Bgr() const { return frame_(box_); }
+  // Whole frame for effects that write BGR directly: commits pending Lab
+  // edits and drops the pixel-derived caches (masks are kept)
+  cv::Mat& MutableFrame();
+
+  // L, a, b planes (8U, Box()-sized), editable and valid at least over local
+  std::vector<cv::Mat>& Lab(const cv::Rect& local);
+  void MarkLabDirty(const cv::Rect& local);    // after editing Lab() there
+  const cv::Mat& Gray();
+  const cv::Mat& GradX();                      // 3x3 Sobel, CV_32F
+  const cv::Mat& GradY();
+  const cv::Mat& GradMag();
+  const cv::Mat& SkinMask();                   // face oval minus lips and eyes (255)
+  // 0..1 ramp over edge_feather_px inside SkinMask(), 0 outside (CV_32F)
+  const cv::Mat& SkinEdgeWeight(float edge_feather_px);
+  // SkinMask()/SkinEdgeWeight() from elsewhere (Box()-sized, shared
+  // read-only), e.g. a FaceGeometryCache carried over from an earlier frame
+  void SetSkinGeometry(const cv::Mat& skin_mask, const cv::Mat& edge_weight, float edge_feather_px);
+  const cv::Mat& FaceOvalMask();               // 255 inside the face oval
+  const cv::Mat& LipsInnerMask();              // 255 inside the inner lips
+
+  // Write edited Lab pixels back into the frame
+  void Commit();
+
+ private:
+  cv::Mat frame_;
+  cv::Size frame_size_;
+  const FaceRegions& fr_;
+  cv::Rect box_;
+  std::vector<cv::Mat> lab_;
+  cv::Rect lab_valid_;   // Converted part of lab_
+  cv::Rect lab_dirty_;
+  cv::Mat gray_, grad_x_, grad_y_, grad_mag_;
+  cv::Mat skin_mask_, face_oval_mask_, lips_inner_mask_;
+  cv::Mat skin_edge_;
+  float skin_edge_px_ = 0.0f;   // edge_feather_px of skin_edge_
+};
+
 // Apply lipstick/lip-refiner using landmark lips (outer minus inner).
 // color_bgr: target tint (0..255 per channel)
 // strength:  0..1 amount of color shift (LAB a/b blend)
@@ -43,6 +119,13 @@ void ApplyLipRefinerBGR(cv::Mat& frame_bgr,
                         float band_grow_px,
                         const mediapipe::NormalizedLandmarkList& lms,
                         const cv::Size& frame_size);
+void ApplyLipRefinerBGR(FaceEffectsContext& ctx,
+                        const cv::Scalar& color_bgr,
+                        float strength,
+                        float feather_px,
+                        float lightness,
+                        float band_grow_px,
+                        const mediapipe::NormalizedLandmarkList& lms);
 
 // Apply simple teeth whitening inside inner lips polygon.
 // strength in 0..1.
@@ -52,6 +135,9 @@ void ApplyTeethWhitenBGR(cv::Mat& frame_bgr,
                          const FaceRegions& fr,
                          float strength,
                          float shrink_px);
+void ApplyTeethWhitenBGR(FaceEffectsContext& ctx,
+                         float strength,
+                         float shrink_px);
 
 // Apply basic skin smoothing inside face oval, excluding lips and eyes.
 // strength controls bilateral filter sigma (typical 0..1 -> 25..75).
@@ -59,6 +145,9 @@ void ApplySkinSmoothingBGR(cv::Mat& frame_bgr,
                            const FaceRegions& fr,
                            float strength,
                            bool use_ocl=false);
+void ApplySkinSmoothingBGR(FaceEffectsContext& ctx,
+                           float strength,
+                           bool use_ocl=false);
 
 // Build a high-quality skin weight map (0..1 float) using landmarks.
 // - edge_feather_px: width of the falloff near face contour in pixels.
@@ -112,3 +201,26 @@ void ApplySkinSmoothingAdvBGR(cv::Mat& frame_bgr,
                               bool use_skin_gate = true,
                               float mask_gain = 1.0f,
                               float neg_atten_cap = 0.8f);
+void ApplySkinSmoothingAdvBGR(FaceEffectsContext& ctx,
+                              float amount,
+                              float radius_px,
+                              float texture_thresh,
+                              float edge_feather_px,
+                              const mediapipe::NormalizedLandmarkList* lms,
+                              float smile_boost,
+                              float squint_boost,
+                              float forehead_boost,
+                              float boost_gain,
+                              bool suppress_lower_face = false,
+                              float lower_face_ratio = 0.45f,
+                              bool ignore_glasses = false,
+                              float glasses_margin_px = 10.0f,
+                              float keep_ratio = 0.12f,
+                              float line_min_px = -1.0f,
+                              float line_max_px = -1.0f,
+                              float forehead_margin_px = 8.0f,
+                              bool wrinkle_preview = false,
+                              float baseline_boost = 0.25f,
+                              bool use_skin_gate = true,
+                              float mask_gain = 1.0f,
+                              float neg_atten_cap = 0.8f);
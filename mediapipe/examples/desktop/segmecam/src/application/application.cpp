@@ -12,6 +12,10 @@
 // Include managers used directly in application
 #include "include/camera/camera_manager.h"
 #include "include/effects/effects_manager.h"
+#include "include/pipeline/frame_synchronizer.h"
+#include "include/pipeline/trace.h"
+#include "include/pipeline/session_file.h"
+#include "include/pipeline/session_replay.h"
 
 // Include MediaPipe for output stream polling
 #include "mediapipe/framework/calculator_graph.h"
@@ -59,10 +63,76 @@ int SegmeCamApplication::Initialize(const ApplicationConfig& config) {
 }
 
 int SegmeCamApplication::Run() {
-    // Use the extracted run module for main application loop
-    return ApplicationRun::ExecuteMainLoop(managers_, mediapipe_graph_, mask_poller_, 
-                                          multi_face_landmarks_poller_, face_rects_poller_,
-                                          window_, app_state_);
+    // Frame/mask fusion is a runtime setting shared with the frame loops
+    app_state_.fusion_policy = config_.fusion_policy;
+    app_state_.fusion_max_wait_ms = config_.fusion_max_wait_ms;
+    
+    if (!config_.vcam_device.empty()) {
+        app_state_.virtual_camera_path = config_.vcam_device;
+    }
+    
+    // Decode camera frames on a camera-owned thread so the loop never waits on read()
+    if (managers_.camera && (config_.async_capture || config_.pipelined || config_.headless)) {
+        // Every frame waiting in the synchronizer pins a pool buffer, plus the
+        // one being decoded and the newest one in the mailbox
+        managers_.camera->SetMinCapturePoolSize((int)FrameSyncConfig{}.max_pending_frames + 2);
+        managers_.camera->SetAsyncCapture(true);
+    }
+    
+    // Stage tracing (also toggled with F12); whatever is recorded is saved on exit
+    Tracer& tracer = Tracer::Instance();
+    tracer.SetOutputPath(config_.trace_file);
+    if (config_.trace) {
+        tracer.SetEnabled(true);
+        std::cout << "🔍 Tracing enabled, writing to " << config_.trace_file << " on exit" << std::endl;
+    }
+    
+    // Session capture: frames plus the graph outputs fused for them
+    if (!config_.record_file.empty()) {
+        session_recorder_ = std::make_unique<SessionRecorder>();
+        if (!session_recorder_->Open(config_.record_file)) {
+            return -1;
+        }
+        app_state_.session_recorder = session_recorder_.get();
+    }
+    
+    std::unique_ptr<SessionReplaySource> replay;
+    if (!config_.replay_file.empty()) {
+        session_reader_ = std::make_unique<SessionReader>();
+        if (!session_reader_->Open(config_.replay_file) || session_reader_->FrameCount() == 0) {
+            std::cerr << "❌ Nothing to replay in " << config_.replay_file << std::endl;
+            return -1;
+        }
+        replay = std::make_unique<SessionReplaySource>(*session_reader_, /*realtime=*/true, /*loop=*/true);
+    }
+    
+    int result;
+    if (config_.headless) {
+        // Always-on virtual camera output, no UI
+        result = ApplicationRun::ExecuteHeadlessLoop(managers_, mediapipe_graph_, mask_poller_,
+                                                     multi_face_landmarks_poller_, face_rects_poller_,
+                                                     app_state_, replay.get());
+    } else if (config_.pipelined) {
+        // Staged multi-threaded loop (capture, effects, vcam, render)
+        result = ApplicationRun::ExecutePipelinedLoop(managers_, mediapipe_graph_, mask_poller_,
+                                                      multi_face_landmarks_poller_, face_rects_poller_,
+                                                      window_, app_state_);
+    } else {
+        // Use the extracted run module for main application loop
+        result = ApplicationRun::ExecuteMainLoop(managers_, mediapipe_graph_, mask_poller_, 
+                                                multi_face_landmarks_poller_, face_rects_poller_,
+                                                window_, app_state_);
+    }
+    
+    if (tracer.IsEnabled()) {
+        tracer.SetEnabled(false);
+        tracer.WriteChromeTrace();
+    }
+    if (session_recorder_) {
+        app_state_.session_recorder = nullptr;
+        session_recorder_->Close();
+    }
+    return result;
 }
 
 void SegmeCamApplication::Cleanup() {
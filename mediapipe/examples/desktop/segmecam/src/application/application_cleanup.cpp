@@ -27,8 +27,10 @@ void ApplicationCleanup::PerformCleanup(
     // 2. Cleanup MediaPipe graph
     CleanupMediaPipe(mediapipe_graph);
     
-    // 3. Shutdown ImGui rendering
-    CleanupImGui();
+    // 3. Shutdown ImGui rendering (never created in headless mode)
+    if (ImGui::GetCurrentContext()) {
+        CleanupImGui();
+    }
     
     // 4. Cleanup SDL and OpenGL resources last
     CleanupSDL(gl_context, window);
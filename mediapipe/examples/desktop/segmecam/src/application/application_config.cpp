@@ -26,6 +26,53 @@ ApplicationConfig ApplicationConfig::FromCommandLine(int argc, char** argv) {
         } else if (arg.find("--camera_id=") == 0) {
             config.cam_index = std::atoi(arg.substr(12).c_str()); // Remove "--camera_id="
             std::cout << "  ✅ Parsed camera_id: " << config.cam_index << std::endl;
+        } else if (arg == "--pipelined" || arg.find("--pipelined=") == 0) {
+            std::string value = (arg == "--pipelined") ? "true" : arg.substr(12); // Remove "--pipelined="
+            config.pipelined = (value == "true" || value == "1");
+            std::cout << "  ✅ Parsed pipelined: " << (config.pipelined ? "true" : "false") << std::endl;
+        } else if (arg == "--async_capture" || arg.find("--async_capture=") == 0) {
+            std::string value = (arg == "--async_capture") ? "true" : arg.substr(16); // Remove "--async_capture="
+            config.async_capture = (value == "true" || value == "1");
+            std::cout << "  ✅ Parsed async_capture: " << (config.async_capture ? "true" : "false") << std::endl;
+        } else if (arg.find("--fusion_policy=") == 0) {
+            std::string value = arg.substr(16); // Remove "--fusion_policy="
+            if (value == "wait" || value == "0") {
+                config.fusion_policy = 0;
+            } else if (value == "latest" || value == "1") {
+                config.fusion_policy = 1;
+            } else if (value == "extrapolate" || value == "2") {
+                config.fusion_policy = 2;
+            } else {
+                std::cout << "  ⚠️  Unknown fusion_policy '" << value << "' (wait|latest|extrapolate)" << std::endl;
+            }
+            std::cout << "  ✅ Parsed fusion_policy: " << config.fusion_policy << std::endl;
+        } else if (arg.find("--fusion_max_wait_ms=") == 0) {
+            config.fusion_max_wait_ms = std::atoi(arg.substr(21).c_str()); // Remove "--fusion_max_wait_ms="
+            std::cout << "  ✅ Parsed fusion_max_wait_ms: " << config.fusion_max_wait_ms << std::endl;
+        } else if (arg == "--trace" || arg.find("--trace=") == 0) {
+            std::string value = (arg == "--trace") ? "true" : arg.substr(8); // Remove "--trace="
+            config.trace = (value == "true" || value == "1");
+            std::cout << "  ✅ Parsed trace: " << (config.trace ? "true" : "false") << std::endl;
+        } else if (arg.find("--trace_file=") == 0) {
+            config.trace_file = arg.substr(13); // Remove "--trace_file="
+            std::cout << "  ✅ Parsed trace_file: '" << config.trace_file << "'" << std::endl;
+        } else if (arg == "--headless" || arg.find("--headless=") == 0) {
+            std::string value = (arg == "--headless") ? "true" : arg.substr(11); // Remove "--headless="
+            config.headless = (value == "true" || value == "1");
+            std::cout << "  ✅ Parsed headless: " << (config.headless ? "true" : "false") << std::endl;
+        } else if (arg.find("--profile=") == 0) {
+            config.profile = arg.substr(10); // Remove "--profile="
+            std::cout << "  ✅ Parsed profile: '" << config.profile << "'" << std::endl;
+        } else if (arg.find("--vcam_device=") == 0) {
+            config.vcam_device = arg.substr(14); // Remove "--vcam_device="
+            std::cout << "  ✅ Parsed vcam_device: '" << config.vcam_device << "'" << std::endl;
+        } else if (arg.find("--record=") == 0) {
+            config.record_file = arg.substr(9); // Remove "--record="
+            std::cout << "  ✅ Parsed record: '" << config.record_file << "'" << std::endl;
+        } else if (arg.find("--replay=") == 0) {
+            config.replay_file = arg.substr(9); // Remove "--replay="
+            config.headless = true;
+            std::cout << "  ✅ Parsed replay: '" << config.replay_file << "' (headless)" << std::endl;
         } else if (arg.find("--") == 0) {
             // Handle other flags if needed in the future
             std::cout << "  ⚠️  Unknown flag: " << arg << std::endl;
@@ -48,6 +95,21 @@ ApplicationConfig ApplicationConfig::FromCommandLine(int argc, char** argv) {
     std::cout << "  graph_path: '" << config.graph_path << "'" << std::endl;
     std::cout << "  resource_root_dir: '" << config.resource_root_dir << "'" << std::endl;
     std::cout << "  cam_index: " << config.cam_index << std::endl;
+    std::cout << "  pipelined: " << (config.pipelined ? "true" : "false") << std::endl;
+    std::cout << "  async_capture: " << (config.async_capture ? "true" : "false") << std::endl;
+    std::cout << "  fusion_policy: " << config.fusion_policy << " (max wait " << config.fusion_max_wait_ms << " ms)" << std::endl;
+    std::cout << "  trace: " << (config.trace ? "true" : "false") << " ('" << config.trace_file << "')" << std::endl;
+    std::cout << "  headless: " << (config.headless ? "true" : "false") << std::endl;
+    std::cout << "  profile: '" << (config.profile.empty() ? "<default>" : config.profile) << "'" << std::endl;
+    if (!config.vcam_device.empty()) {
+        std::cout << "  vcam_device: '" << config.vcam_device << "'" << std::endl;
+    }
+    if (!config.record_file.empty()) {
+        std::cout << "  record: '" << config.record_file << "'" << std::endl;
+    }
+    if (!config.replay_file.empty()) {
+        std::cout << "  replay: '" << config.replay_file << "'" << std::endl;
+    }
     
     return config;
 }
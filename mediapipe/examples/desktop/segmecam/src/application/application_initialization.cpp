@@ -142,16 +142,18 @@ int ApplicationInitialization::InitializeImGui(SDL_Window* window, SDL_GLContext
 
 int ApplicationInitialization::InitializeManagers(
     ManagerCoordination::Managers& managers,
-    AppState& app_state
+    AppState& app_state,
+    const std::string& profile_name,
+    bool camera_optional
 ) {
     // Setup all Phase 1-7 managers using extracted coordination module
-    if (!ManagerCoordination::SetupManagers(managers, app_state)) {
+    if (!ManagerCoordination::SetupManagers(managers, app_state, profile_name, camera_optional)) {
         std::cerr << "❌ Manager setup failed" << std::endl;
         return -8;
     }
     
-    // Load default profile's background image (needs to be done after all managers are initialized)
-    ManagerCoordination::LoadDefaultProfileBackgroundImage(managers, app_state);
+    // Load the profile's background image (needs to be done after all managers are initialized)
+    ManagerCoordination::LoadDefaultProfileBackgroundImage(managers, app_state, profile_name);
     
     return 0;
 }
@@ -173,26 +175,38 @@ int ApplicationInitialization::InitializeApplication(
     // Setup GPU detection using extracted module
     gpu_setup_state = GPUSetup::DetectAndSetupGPU();
     
-    // Initialize MediaPipe system
-    int mediapipe_result = InitializeMediaPipe(config, gpu_setup_state, mediapipe_graph, mask_poller, multi_face_landmarks_poller, face_rects_poller);
-    if (mediapipe_result != 0) {
-        return mediapipe_result;
-    }
-    
-    // Initialize SDL and OpenGL
-    int sdl_result = InitializeSDLAndOpenGL(window, gl_context);
-    if (sdl_result != 0) {
-        return sdl_result;
+    // Initialize MediaPipe system (a replayed session already contains the graph outputs)
+    if (config.replay_file.empty()) {
+        int mediapipe_result = InitializeMediaPipe(config, gpu_setup_state, mediapipe_graph, mask_poller, multi_face_landmarks_poller, face_rects_poller);
+        if (mediapipe_result != 0) {
+            return mediapipe_result;
+        }
+    } else {
+        std::cout << "📂 Session replay - MediaPipe graph not started" << std::endl;
     }
     
-    // Initialize ImGui
-    int imgui_result = InitializeImGui(window, gl_context);
-    if (imgui_result != 0) {
-        return imgui_result;
+    if (config.headless) {
+        // No window, GL context or ImGui: output goes to the virtual camera only
+        std::cout << "🖥️ Headless mode - skipping SDL, OpenGL and ImGui" << std::endl;
+        window = nullptr;
+        gl_context = nullptr;
+    } else {
+        // Initialize SDL and OpenGL
+        int sdl_result = InitializeSDLAndOpenGL(window, gl_context);
+        if (sdl_result != 0) {
+            return sdl_result;
+        }
+        
+        // Initialize ImGui
+        int imgui_result = InitializeImGui(window, gl_context);
+        if (imgui_result != 0) {
+            return imgui_result;
+        }
     }
     
     // Initialize managers
-    int managers_result = InitializeManagers(managers, app_state);
+    bool replaying = !config.replay_file.empty();
+    int managers_result = InitializeManagers(managers, app_state, config.profile, replaying);
     if (managers_result != 0) {
         return managers_result;
     }
@@ -26,84 +26,152 @@
 // Include segmentation composite functions for proper mask decoding
 #include "segmecam_composite.h"
 
+// Include bounded queues connecting the pipeline stages
+#include "include/pipeline/bounded_queue.h"
+#include "include/pipeline/frame_pool.h"
+#include "include/pipeline/frame_synchronizer.h"
+#include "include/pipeline/mask_decoder.h"
+#include "include/pipeline/session_replay.h"
+#include "include/pipeline/trace.h"
+
 #include <iostream>
 #include <chrono>
 #include <thread>
 #include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <csignal>
 
 namespace segmecam {
 
-// Helper function to sync app_state settings to EffectsManager
-void ApplicationRun::SyncSettingsToEffectsManager(EffectsManager& effects_manager, const AppState& app_state) {
+namespace {
+
+// Build the frame/mask fusion settings from the runtime app state
+FrameSyncConfig MakeFrameSyncConfig(int fusion_policy, int fusion_max_wait_ms, bool expect_landmarks) {
+    FrameSyncConfig config;
+    config.policy = static_cast<FusionPolicy>(std::clamp(fusion_policy, 0, 2));
+    config.max_wait_ms = std::max(0, fusion_max_wait_ms);
+    config.expect_landmarks = expect_landmarks;
+    return config;
+}
+
+FrameSyncConfig MakeFrameSyncConfig(const AppState& app_state, bool expect_landmarks) {
+    return MakeFrameSyncConfig(app_state.fusion_policy, app_state.fusion_max_wait_ms, expect_landmarks);
+}
+
+// Graph input conversion and mask decoding lease from the effects pool too
+FramePool* EffectsFramePool(ManagerCoordination::Managers& managers) {
+    return managers.effects ? &managers.effects->GetFramePool() : nullptr;
+}
+
+} // namespace
+
+// Publish the UI-side effect settings as an immutable snapshot. Only
+// allocates (and bumps the version) when something actually changed.
+void ApplicationRun::PublishEffectsSettings(EffectsManager& effects_manager, const AppState& app_state) {
+    EffectsSettings next;
+    BeautyState& b = next.beauty;
+    
     // Background effects settings
-    effects_manager.SetBackgroundMode(app_state.bg_mode);
-    effects_manager.SetBlurStrength(app_state.blur_strength);
-    effects_manager.SetFeatherAmount(app_state.feather_px);
-    effects_manager.SetSolidBackgroundColor(app_state.solid_color[0], app_state.solid_color[1], app_state.solid_color[2]);
-    effects_manager.SetShowMask(app_state.show_mask);
-    effects_manager.SetShowLandmarks(app_state.show_landmarks);
-    
-    // Sync background image if available
-    if (!app_state.bg_image.empty()) {
-        effects_manager.SetBackgroundImage(app_state.bg_image);
-    }
+    b.bg_mode = app_state.bg_mode;
+    b.blur_strength = app_state.blur_strength;
+    b.blur_backend = app_state.blur_backend;
+    b.mask_upsampler = app_state.mask_upsampler;
+    b.feather_px = app_state.feather_px;
+    b.solid_color[0] = app_state.solid_color[0];
+    b.solid_color[1] = app_state.solid_color[1];
+    b.solid_color[2] = app_state.solid_color[2];
+    b.show_mask = app_state.show_mask;
+    next.show_landmarks = app_state.show_landmarks;
+    next.background_video_path = app_state.bg_video_path_buf;
+    next.background_video_preload = app_state.bg_video_preload;
     
-    // Beauty effects settings
-    effects_manager.SetSkinSmoothingEnabled(app_state.fx_skin);
-    effects_manager.SetSkinSmoothingStrength(app_state.fx_skin_strength);
-    effects_manager.SetSkinSmoothingAdvanced(app_state.fx_skin_adv);
-    effects_manager.SetSkinSmoothingAmount(app_state.fx_skin_amount);
-    effects_manager.SetSkinSmoothingRadius(app_state.fx_skin_radius);
-    effects_manager.SetSkinTexturePreservation(app_state.fx_skin_tex);
-    effects_manager.SetSkinEdgeFeather(app_state.fx_skin_edge);
+    // Beauty effects settings (fx_skin_amount is the effective strength)
+    b.fx_skin = app_state.fx_skin;
+    b.fx_skin_adv = app_state.fx_skin_adv;
+    b.fx_skin_amount = app_state.fx_skin_amount;
+    b.fx_skin_radius = app_state.fx_skin_radius;
+    b.fx_skin_tex = app_state.fx_skin_tex;
+    b.fx_skin_edge = app_state.fx_skin_edge;
     
     // Wrinkle-aware settings
-    effects_manager.SetWrinkleAwareEnabled(app_state.fx_skin_wrinkle);
-    effects_manager.SetWrinkleGain(app_state.fx_skin_wrinkle_gain);
-    effects_manager.SetSmileBoost(app_state.fx_skin_smile_boost);
-    effects_manager.SetSquintBoost(app_state.fx_skin_squint_boost);
-    effects_manager.SetForeheadBoost(app_state.fx_skin_forehead_boost);
-    effects_manager.SetSuppressLowerFace(app_state.fx_wrinkle_suppress_lower);
-    effects_manager.SetLowerFaceRatio(app_state.fx_wrinkle_lower_ratio);
-    effects_manager.SetIgnoreGlasses(app_state.fx_wrinkle_ignore_glasses);
-    effects_manager.SetGlassesMargin(app_state.fx_wrinkle_glasses_margin);
-    effects_manager.SetWrinkleSensitivity(app_state.fx_wrinkle_keep_ratio);
-    effects_manager.SetCustomWrinkleScales(app_state.fx_wrinkle_custom_scales);
-    effects_manager.SetWrinkleMinWidth(app_state.fx_wrinkle_min_px);
-    effects_manager.SetWrinkleMaxWidth(app_state.fx_wrinkle_max_px);
-    effects_manager.SetWrinkleSkinGate(app_state.fx_wrinkle_use_skin_gate);
-    effects_manager.SetWrinkleMaskGain(app_state.fx_wrinkle_mask_gain);
-    effects_manager.SetWrinkleBaselineBoost(app_state.fx_wrinkle_baseline);
-    effects_manager.SetWrinkleNegativeCap(app_state.fx_wrinkle_neg_cap);
-    effects_manager.SetWrinklePreview(app_state.fx_wrinkle_preview);
+    b.fx_skin_wrinkle = app_state.fx_skin_wrinkle;
+    b.fx_skin_wrinkle_gain = app_state.fx_skin_wrinkle_gain;
+    b.fx_skin_smile_boost = app_state.fx_skin_smile_boost;
+    b.fx_skin_squint_boost = app_state.fx_skin_squint_boost;
+    b.fx_skin_forehead_boost = app_state.fx_skin_forehead_boost;
+    b.fx_wrinkle_suppress_lower = app_state.fx_wrinkle_suppress_lower;
+    b.fx_wrinkle_lower_ratio = app_state.fx_wrinkle_lower_ratio;
+    b.fx_wrinkle_ignore_glasses = app_state.fx_wrinkle_ignore_glasses;
+    b.fx_wrinkle_glasses_margin = app_state.fx_wrinkle_glasses_margin;
+    b.fx_wrinkle_keep_ratio = app_state.fx_wrinkle_keep_ratio;
+    b.fx_wrinkle_custom_scales = app_state.fx_wrinkle_custom_scales;
+    b.fx_wrinkle_min_px = app_state.fx_wrinkle_min_px;
+    b.fx_wrinkle_max_px = app_state.fx_wrinkle_max_px;
+    b.fx_wrinkle_use_skin_gate = app_state.fx_wrinkle_use_skin_gate;
+    b.fx_wrinkle_mask_gain = app_state.fx_wrinkle_mask_gain;
+    b.fx_wrinkle_baseline = app_state.fx_wrinkle_baseline;
+    b.fx_wrinkle_neg_cap = app_state.fx_wrinkle_neg_cap;
+    b.fx_wrinkle_preview = app_state.fx_wrinkle_preview;
     
     // Processing scale settings
-    effects_manager.SetProcessingScale(app_state.fx_adv_scale);
-    effects_manager.SetDetailPreservation(app_state.fx_adv_detail_preserve);
+    b.fx_adv_scale = app_state.fx_adv_scale;
+    b.fx_adv_detail_preserve = app_state.fx_adv_detail_preserve;
     
     // Auto processing scale settings
-    effects_manager.SetAutoProcessingScaleEnabled(app_state.auto_processing_scale);
-    effects_manager.SetTargetFPS(app_state.target_fps);
+    b.auto_processing_scale = app_state.auto_processing_scale;
+    b.target_fps = app_state.target_fps;
     
     // Lip effects settings
-    effects_manager.SetLipstickEnabled(app_state.fx_lipstick);
-    effects_manager.SetLipAlpha(app_state.fx_lip_alpha);
-    effects_manager.SetLipFeather(app_state.fx_lip_feather);
-    effects_manager.SetLipLightness(app_state.fx_lip_light);
-    effects_manager.SetLipBandGrow(app_state.fx_lip_band);
-    effects_manager.SetLipColor(app_state.fx_lip_color[0], app_state.fx_lip_color[1], app_state.fx_lip_color[2]);
+    b.fx_lipstick = app_state.fx_lipstick;
+    b.fx_lip_alpha = app_state.fx_lip_alpha;
+    b.fx_lip_feather = app_state.fx_lip_feather;
+    b.fx_lip_light = app_state.fx_lip_light;
+    b.fx_lip_band = app_state.fx_lip_band;
+    b.fx_lip_color[0] = app_state.fx_lip_color[0];
+    b.fx_lip_color[1] = app_state.fx_lip_color[1];
+    b.fx_lip_color[2] = app_state.fx_lip_color[2];
     
     // Teeth whitening settings
-    effects_manager.SetTeethWhiteningEnabled(app_state.fx_teeth);
-    effects_manager.SetTeethWhiteningStrength(app_state.fx_teeth_strength);
-    effects_manager.SetTeethMargin(app_state.fx_teeth_margin);
+    b.fx_teeth = app_state.fx_teeth;
+    b.fx_teeth_strength = app_state.fx_teeth_strength;
+    b.fx_teeth_margin = app_state.fx_teeth_margin;
+    
+    // Background image: new images always come with a new buffer, and the
+    // previous snapshot keeps the old one alive, so the pointer identifies it
+    std::shared_ptr<const EffectsSettings> last = effects_manager.GetPublishedSettings();
+    const cv::Mat* last_image = (last && last->background_image) ? last->background_image.get() : nullptr;
+    bool same_image = last_image ? (last_image->data == app_state.bg_image.data &&
+                                    last_image->size() == app_state.bg_image.size())
+                                 : app_state.bg_image.empty();
+    uint64_t last_generation = last ? last->background_generation : 0;
+    next.background_generation = (same_image || app_state.bg_image.empty()) ? last_generation : last_generation + 1;
+    
+    if (last && same_image && last->beauty == next.beauty && last->show_landmarks == next.show_landmarks &&
+        last->background_video_path == next.background_video_path &&
+        last->background_video_preload == next.background_video_preload) {
+        return;  // Unchanged - nothing to publish
+    }
+    
+    if (same_image) {
+        next.background_image = last ? last->background_image : nullptr;
+    } else if (!app_state.bg_image.empty()) {
+        next.background_image = std::make_shared<const cv::Mat>(app_state.bg_image);
+    }
+    next.version = (last ? last->version : 0) + 1;
+    effects_manager.PublishSettings(std::make_shared<const EffectsSettings>(std::move(next)));
 }
 
 // Helper function to sync status FROM EffectsManager back TO app_state
 void ApplicationRun::SyncStatusFromEffectsManager(const EffectsManager& effects_manager, AppState& app_state) {
+    SyncStatusFromEffectsManager(effects_manager.GetState(), app_state);
+}
+
+void ApplicationRun::SyncStatusFromEffectsManager(const EffectsState& effects_state, AppState& app_state) {
     // Sync OpenCL availability status (detected by EffectsManager)
     bool prev_opencl_available = app_state.opencl_available;
-    app_state.opencl_available = effects_manager.IsOpenCLAvailable();
+    app_state.opencl_available = effects_state.opencl_available;
     
     // Enable OpenCL by default when first detected as available
     if (!prev_opencl_available && app_state.opencl_available) {
@@ -112,13 +180,17 @@ void ApplicationRun::SyncStatusFromEffectsManager(const EffectsManager& effects_
     }
 }
 
-// Helper function to convert MediaPipe ImageFrame to OpenCV Mat
-void ApplicationRun::MatToImageFrame(const cv::Mat& mat_bgr, std::unique_ptr<mediapipe::ImageFrame>& frame) {
-    frame = std::make_unique<mediapipe::ImageFrame>(
-        mediapipe::ImageFormat::SRGB, mat_bgr.cols, mat_bgr.rows);
-    cv::Mat frame_rgb;
+// Helper function to convert OpenCV Mat to MediaPipe ImageFrame
+void ApplicationRun::MatToImageFrame(const cv::Mat& mat_bgr, std::unique_ptr<mediapipe::ImageFrame>& frame,
+                                     FramePool* pool) {
+    SEGMECAM_TRACE_SCOPE("graph.to_image_frame");
+    // Convert straight into a pooled buffer and let the ImageFrame adopt it;
+    // the lease returns to the pool when the graph releases the packet
+    cv::Mat frame_rgb = AcquireFrame(pool, mat_bgr.size(), CV_8UC3);
     cv::cvtColor(mat_bgr, frame_rgb, cv::COLOR_BGR2RGB);
-    frame_rgb.copyTo(cv::Mat(frame->Height(), frame->Width(), CV_8UC3, frame->MutablePixelData()));
+    frame = std::make_unique<mediapipe::ImageFrame>(
+        mediapipe::ImageFormat::SRGB, frame_rgb.cols, frame_rgb.rows, (int)frame_rgb.step,
+        frame_rgb.data, [frame_rgb](uint8_t*) mutable { frame_rgb.release(); });
 }
 
 bool ApplicationRun::ProcessEvents(bool& running) {
@@ -143,9 +215,150 @@ void ApplicationRun::UpdateFPSTracking(double& fps, uint64_t& fps_frames, uint32
     }
 }
 
+bool ApplicationRun::PollSegmentationMask(mediapipe::OutputStreamPoller* mask_poller,
+                                          MaskDecoder& mask_decoder,
+                                          FrameSynchronizer& frame_sync, FramePool* pool,
+                                          bool verbose) {
+    if (!mask_poller) return false;
+    SEGMECAM_TRACE_SCOPE("graph.poll_mask");
+    bool got_mask = false;
+    mediapipe::Packet pkt;
+    while (mask_poller->QueueSize() > 0 && mask_poller->Next(&pkt)) {
+        const auto& mask = pkt.Get<mediapipe::ImageFrame>();
+        
+        // 1xU8 masks are used in place; the Mat keeps the packet alive
+        cv::Mat mask_u8 = mask_decoder.DecodeView(pkt, pool);
+        frame_sync.AddMask(pkt.Timestamp(), mask_u8);
+        got_mask = true;
+        
+        if (verbose) {
+            double min_val, max_val;
+            cv::minMaxLoc(mask_u8, &min_val, &max_val);
+            std::cout << "✅ Mask received: " << mask.Width() << "x" << mask.Height() 
+                      << " (format: " << mask.NumberOfChannels() << "ch, " << mask.ByteDepth() << "bd -> 8UC1: " << min_val << "-" << max_val << ")" << std::endl;
+        }
+    }
+    return got_mask;
+}
+
+bool ApplicationRun::PollFaceLandmarks(mediapipe::OutputStreamPoller* landmarks_poller,
+                                       mediapipe::OutputStreamPoller* rects_poller,
+                                       FrameSynchronizer& frame_sync,
+                                       bool verbose) {
+    if (!landmarks_poller) return false;
+    SEGMECAM_TRACE_SCOPE("graph.poll_landmarks");
+    bool have_lms = false;
+    try {
+        mediapipe::Packet lp;
+        // Use non-blocking polling with queue size check
+        int queue_size = landmarks_poller->QueueSize();
+        if (verbose) {
+            std::cout << "📍 Landmarks queue size: " << queue_size << std::endl;
+        }
+        
+        while (queue_size > 0 && landmarks_poller->Next(&lp)) {
+            try {
+                // Expecting vector<NormalizedLandmarkList>
+                const auto& v = lp.Get<std::vector<mediapipe::NormalizedLandmarkList>>();
+                if (!v.empty()) { 
+                    frame_sync.AddLandmarks(lp.Timestamp(), v[0]);
+                    have_lms = true;
+                    if (verbose) {
+                        std::cout << "✅ Got landmarks with " << v[0].landmark_size() << " points" << std::endl;
+                    }
+                }
+                queue_size = landmarks_poller->QueueSize(); // Update queue size
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Error processing landmarks packet: " << e.what() << std::endl;
+                break;
+            }
+        }
+        
+        // Drain face rects if available (not consumed yet, keeps the queue bounded)
+        if (rects_poller) {
+            mediapipe::Packet rp;
+            while (rects_poller->QueueSize() > 0 && rects_poller->Next(&rp)) {
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Exception during landmarks polling: " << e.what() << std::endl;
+        // Don't exit, just continue without landmarks for this frame
+    }
+    return have_lms;
+}
+
+cv::Mat ApplicationRun::ProcessFusedFrame(ManagerCoordination::Managers& managers,
+                                          const FusedFrame& fused) {
+    cv::Mat display_rgb;
+    
+    // Apply effects if EffectsManager is available (settings arrive via PublishEffectsSettings)
+    if (managers.effects) {
+        // Only process if we have a mask or face landmarks
+        if (!fused.mask_u8.empty() || fused.has_landmarks) {
+            // EffectsManager returns RGB directly
+            const mediapipe::NormalizedLandmarkList* landmarks_ptr = fused.has_landmarks ? &fused.landmarks : nullptr;
+            display_rgb = managers.effects->ProcessFrame(fused.frame_bgr, fused.mask_u8, landmarks_ptr);
+        }
+    }
+    
+    if (display_rgb.empty()) {
+        // No processing needed - original frame, converted to the display format
+        cv::cvtColor(fused.frame_bgr, display_rgb, cv::COLOR_BGR2RGB);
+    }
+    return display_rgb;
+}
+
+void ApplicationRun::WriteToVirtualCamera(ManagerCoordination::Managers& managers,
+                                          AppState& app_state,
+                                          const cv::Mat& display_rgb,
+                                          std::mutex* camera_mutex) {
+    if (!app_state.vcam.IsOpen() || display_rgb.empty()) return;
+    SEGMECAM_TRACE_SCOPE("vcam.write_frame");
+    
+    // Check if frame size matches vcam, reopen if needed
+    if (display_rgb.cols != app_state.vcam.Width() || display_rgb.rows != app_state.vcam.Height()) {
+        // Get virtual camera list and reopen with correct size
+        std::string path;
+        {
+            auto lock = LockIf(camera_mutex);
+            const auto& vcam_list = managers.camera->GetVCamList();
+            if (app_state.ui_vcam_idx >= 0 && app_state.ui_vcam_idx < (int)vcam_list.size()) {
+                path = vcam_list[app_state.ui_vcam_idx].path;
+            }
+        }
+        if (!path.empty()) {
+            app_state.vcam.Open(path, display_rgb.cols, display_rgb.rows);
+        }
+    }
+    
+    // VCam converts RGB to YUYV directly
+    app_state.vcam.WriteRGB(display_rgb);
+}
+
+void ApplicationRun::HandleDroppedFiles(UIManager& ui_manager, AppState& app_state) {
+    auto dropped_files = ui_manager.GetDroppedFiles();
+    for (const auto& file_path : dropped_files) {
+        std::cout << "🖼️  Processing dropped file: " << file_path << std::endl;
+        cv::Mat img = cv::imread(file_path);
+        if (!img.empty()) {
+            app_state.bg_image = img.clone();
+            app_state.bg_mode = 2; // Automatically switch to Image mode (0=None, 1=Blur, 2=Image, 3=Solid)
+            // Update the background path for profile persistence
+            strncpy(app_state.bg_path_buf, file_path.c_str(), sizeof(app_state.bg_path_buf) - 1);
+            app_state.bg_path_buf[sizeof(app_state.bg_path_buf) - 1] = '\0';
+            std::cout << "✅ Background image loaded from dropped file: " 
+                      << img.cols << "x" << img.rows << " (auto-switched to Image mode)" << std::endl;
+            std::cout << "🔖 Background path saved: " << app_state.bg_path_buf << std::endl;
+        } else {
+            std::cout << "❌ Failed to load dropped file as image: " << file_path << std::endl;
+        }
+    }
+}
+
 GLuint ApplicationRun::CreateVideoTexture(const cv::Mat& display_rgb) {
     GLuint video_texture = 0;
     if (!display_rgb.empty()) {
+        SEGMECAM_TRACE_SCOPE("render.upload_texture");
         // Debug output for texture upload
         static int texture_debug_count = 0;
         texture_debug_count++;
@@ -238,6 +451,7 @@ int ApplicationRun::ExecuteMainLoop(
     AppState& app_state
 ) {
     std::cout << "🎥 Starting main application loop..." << std::endl;
+    Tracer::Instance().SetThreadName("main");
     
     // Check if face landmarks are available (multi_face_landmarks is required, face_rects is optional)
     bool has_landmarks = (multi_face_landmarks_poller != nullptr);
@@ -255,14 +469,16 @@ int ApplicationRun::ExecuteMainLoop(
     }
     
     // Initialize UI panels with dependencies
-    ui_manager.InitializePanels(app_state, *managers.camera, *managers.effects, managers.config.get());
+    ui_manager.InitializePanels(app_state, *managers.camera, managers.config.get());
     std::cout << "✅ UIManager Enhanced initialized successfully" << std::endl;
     
     // Initialize application state
     bool running = true;
     int64_t frame_id = 0;
-    cv::Mat last_mask_u8;
-    cv::Mat last_display_rgb;
+    FrameSynchronizer frame_sync(MakeFrameSyncConfig(app_state, has_landmarks));
+    frame_sync.SetRecorder(app_state.session_recorder);
+    MaskDecoder mask_decoder;
+    FramePool* frame_pool = EffectsFramePool(managers);
     
     // FPS tracking
     double fps = 0.0;
@@ -287,6 +503,7 @@ int ApplicationRun::ExecuteMainLoop(
         }
         
         try {
+            SEGMECAM_TRACE_SCOPE("frame");
             frame_count++;
             
             // Capture frame from camera using CameraManager
@@ -338,12 +555,19 @@ int ApplicationRun::ExecuteMainLoop(
             app_state.fx_adv_scale = managers.effects->GetProcessingScale();
         }
         
+        // Hand UI changes to the effects (new snapshot only when something changed)
+        PublishEffectsSettings(*managers.effects, app_state);
+        
         // Send frame to MediaPipe graph
         {
             std::unique_ptr<mediapipe::ImageFrame> frame;
-            MatToImageFrame(frame_bgr, frame);
+            MatToImageFrame(frame_bgr, frame, frame_pool);
             auto ts = mediapipe::Timestamp(frame_id++);
-            auto st = mediapipe_graph->AddPacketToInputStream("input_video", mediapipe::Adopt(frame.release()).At(ts));
+            absl::Status st;
+            {
+                SEGMECAM_TRACE_SCOPE("graph.add_packet");
+                st = mediapipe_graph->AddPacketToInputStream("input_video", mediapipe::Adopt(frame.release()).At(ts));
+            }
             if (!st.ok()) {
                 std::cerr << "❌ AddPacket failed: " << st.message() << std::endl;
                 break;
@@ -355,112 +579,37 @@ int ApplicationRun::ExecuteMainLoop(
             if (frame_count <= 5) {
                 std::cout << "✅ Frame " << frame_count << " sent, waiting before polling..." << std::endl;
             }
-        }
-        
-        // Poll for mask output (non-blocking)
-        mediapipe::Packet pkt;
-        while (mask_poller->QueueSize() > 0 && mask_poller->Next(&pkt)) {
-            const auto& mask = pkt.Get<mediapipe::ImageFrame>();
-            
-            // Use the proper mask decoding function (same as original implementation)
-            static bool first_mask_info = false;
-            last_mask_u8 = DecodeMaskToU8(mask, &first_mask_info);
             
-            // Update app state with mask
-            app_state.last_mask_u8 = last_mask_u8.clone();
-            
-            if (frame_count <= 5) {
-                double min_val, max_val;
-                cv::minMaxLoc(last_mask_u8, &min_val, &max_val);
-                std::cout << "✅ Mask received: " << mask.Width() << "x" << mask.Height() 
-                          << " (format: " << mask.NumberOfChannels() << "ch, " << mask.ByteDepth() << "bd -> 8UC1: " << min_val << "-" << max_val << ")" << std::endl;
-            }
+            // Hold the frame until its own mask/landmarks come back
+            frame_sync.AddFrame(ts, frame_bgr);
         }
         
-        // Poll latest face landmarks (non-blocking) - WITH DEFENSIVE ERROR HANDLING
-        mediapipe::NormalizedLandmarkList latest_lms;
-        bool have_lms = false;
-        std::vector<mediapipe::NormalizedRect> latest_rects;
+        // Poll graph outputs (non-blocking) - WITH DEFENSIVE ERROR HANDLING
+        PollSegmentationMask(mask_poller.get(), mask_decoder, frame_sync, frame_pool, frame_count <= 5);
         if (has_landmarks && multi_face_landmarks_poller) {
-            try {
-                mediapipe::Packet lp;
-                // Use non-blocking polling with queue size check
-                int queue_size = multi_face_landmarks_poller->QueueSize();
-                if (frame_count <= 5) {
-                    std::cout << "📍 Landmarks queue size: " << queue_size << std::endl;
-                }
-                
-                while (queue_size > 0 && multi_face_landmarks_poller->Next(&lp)) {
-                    try {
-                        // Expecting vector<NormalizedLandmarkList>
-                        const auto& v = lp.Get<std::vector<mediapipe::NormalizedLandmarkList>>();
-                        if (!v.empty()) { 
-                            latest_lms = v[0]; 
-                            have_lms = true;
-                            if (frame_count <= 5) {
-                                std::cout << "✅ Got landmarks with " << latest_lms.landmark_size() << " points" << std::endl;
-                            }
-                        }
-                        queue_size = multi_face_landmarks_poller->QueueSize(); // Update queue size
-                    } catch (const std::exception& e) {
-                        std::cerr << "❌ Error processing landmarks packet: " << e.what() << std::endl;
-                        break;
-                    }
-                }
-                
-                // Process face rects if available
-                if (face_rects_poller) {
-                    mediapipe::Packet rp;
-                    while (face_rects_poller->QueueSize() > 0 && face_rects_poller->Next(&rp)) {
-                        latest_rects = rp.Get<std::vector<mediapipe::NormalizedRect>>();
-                    }
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "❌ Exception during landmarks polling: " << e.what() << std::endl;
-                // Don't exit, just continue without landmarks for this frame
-            }
+            PollFaceLandmarks(multi_face_landmarks_poller.get(), face_rects_poller.get(),
+                              frame_sync, frame_count <= 5);
         }
         
-        // Process frame for display
+        // Process the newest frame whose outputs are available (per fusion policy)
+        frame_sync.SetConfig(MakeFrameSyncConfig(app_state, has_landmarks));
+        FusedFrame fused;
         cv::Mat display_rgb;
-        cv::Mat processed_frame = frame_bgr;
-        
-        // Apply effects if EffectsManager is available
-        if (managers.effects) {
-            // Sync app_state settings to EffectsManager before processing
-            SyncSettingsToEffectsManager(*managers.effects, app_state);
-            
-            // Only process if we have a mask or face landmarks
-            if (!last_mask_u8.empty() || have_lms) {
-                // Use EffectsManager to process the frame with segmentation mask and face landmarks
-                const mediapipe::NormalizedLandmarkList* landmarks_ptr = (have_lms) ? &latest_lms : nullptr;
-                processed_frame = managers.effects->ProcessFrame(frame_bgr, last_mask_u8, landmarks_ptr);
-            } else {
-                // No processing needed - use original frame
-            }
-        }
-        
-        // EffectsManager now returns RGB directly, no conversion needed
-        display_rgb = processed_frame.clone();
-        
-        // Update app state with current frame
-        app_state.last_display_rgb = display_rgb.clone();
-        
-        // Virtual Camera Output - write to v4l2loopback device
-        if (app_state.vcam.IsOpen() && !display_rgb.empty()) {
-            // Check if frame size matches vcam, reopen if needed
-            if (display_rgb.cols != app_state.vcam.Width() || display_rgb.rows != app_state.vcam.Height()) {
-                // Get virtual camera list and reopen with correct size
-                auto vcam_list = managers.camera->GetVCamList();
-                if (app_state.ui_vcam_idx >= 0 && app_state.ui_vcam_idx < (int)vcam_list.size()) {
-                    app_state.vcam.Open(vcam_list[app_state.ui_vcam_idx].path, display_rgb.cols, display_rgb.rows);
-                }
+        if (frame_sync.PopReady(fused)) {
+            if (!fused.mask_u8.empty()) {
+                // Update app state with mask
+                app_state.last_mask_u8 = fused.mask_u8;
             }
+            display_rgb = ProcessFusedFrame(managers, fused);
             
-            // Convert RGB to BGR and write to virtual camera
-            cv::Mat display_bgr;
-            cv::cvtColor(display_rgb, display_bgr, cv::COLOR_RGB2BGR);
-            app_state.vcam.WriteBGR(display_bgr);
+            // Update app state with current frame
+            app_state.last_display_rgb = display_rgb;
+            
+            // Virtual Camera Output - write to v4l2loopback device
+            WriteToVirtualCamera(managers, app_state, display_rgb);
+        } else {
+            // Nothing matched yet - keep showing the previous result
+            display_rgb = app_state.last_display_rgb;
         }
         
         // Let UIManager handle events first
@@ -470,23 +619,7 @@ int ApplicationRun::ExecuteMainLoop(
         }
         
         // Handle any dropped files
-        auto dropped_files = ui_manager.GetDroppedFiles();
-        for (const auto& file_path : dropped_files) {
-            std::cout << "🖼️  Processing dropped file: " << file_path << std::endl;
-            cv::Mat img = cv::imread(file_path);
-            if (!img.empty()) {
-                app_state.bg_image = img.clone();
-                app_state.bg_mode = 2; // Automatically switch to Image mode (0=None, 1=Blur, 2=Image, 3=Solid)
-                // Update the background path for profile persistence
-                strncpy(app_state.bg_path_buf, file_path.c_str(), sizeof(app_state.bg_path_buf) - 1);
-                app_state.bg_path_buf[sizeof(app_state.bg_path_buf) - 1] = '\0';
-                std::cout << "✅ Background image loaded from dropped file: " 
-                          << img.cols << "x" << img.rows << " (auto-switched to Image mode)" << std::endl;
-                std::cout << "🔖 Background path saved: " << app_state.bg_path_buf << std::endl;
-            } else {
-                std::cout << "❌ Failed to load dropped file as image: " << file_path << std::endl;
-            }
-        }
+        HandleDroppedFiles(ui_manager, app_state);
         
         if (!running) {
             std::cout << "🛑 Running flag set to false by event handler, exiting..." << std::endl;
@@ -516,9 +649,15 @@ int ApplicationRun::ExecuteMainLoop(
         }
         
         // Begin ImGui frame and render UI panels on top
-        ui_manager.BeginFrame();
-        ui_manager.RenderUI();
-        ui_manager.EndFrame();
+        {
+            SEGMECAM_TRACE_SCOPE("render.ui");
+            ui_manager.BeginFrame();
+            ui_manager.RenderUI();
+        }
+        {
+            SEGMECAM_TRACE_SCOPE("render.present");
+            ui_manager.EndFrame();
+        }
         
         if (frame_count <= 5) {
             std::cout << "✅ UI rendered successfully for frame " << frame_count << std::endl;
@@ -557,4 +696,565 @@ int ApplicationRun::ExecuteMainLoop(
     return 0;
 }
 
+// ---------------------------------------------------------------------------
+// Headless execution
+//
+// capture -> MediaPipe -> EffectsManager -> virtual camera, on the calling
+// thread, with no SDL, OpenGL or ImGui. Settings come from the profile that
+// was applied at startup. Stops on SIGINT/SIGTERM so it can run as a service.
+// With a replay source, recorded frames and graph outputs replace the camera
+// and the pollers.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+volatile std::sig_atomic_t g_headless_stop = 0;
+
+void HandleHeadlessStopSignal(int) {
+    g_headless_stop = 1;
+}
+
+constexpr auto kHeadlessStatusInterval = std::chrono::seconds(10);
+constexpr auto kVCamRetryInterval = std::chrono::seconds(5);
+
+} // namespace
+
+int ApplicationRun::ExecuteHeadlessLoop(
+    ManagerCoordination::Managers& managers,
+    std::unique_ptr<mediapipe::CalculatorGraph>& mediapipe_graph,
+    std::unique_ptr<mediapipe::OutputStreamPoller>& mask_poller,
+    std::unique_ptr<mediapipe::OutputStreamPoller>& multi_face_landmarks_poller,
+    std::unique_ptr<mediapipe::OutputStreamPoller>& face_rects_poller,
+    AppState& app_state,
+    SessionReplaySource* replay
+) {
+    std::cout << "🎥 Starting headless loop (output: " << app_state.virtual_camera_path << ")..." << std::endl;
+    Tracer::Instance().SetThreadName("main");
+    
+    bool live = (replay == nullptr);
+    if (!managers.effects || (live && (!managers.camera || !mediapipe_graph || !mask_poller))) {
+        std::cerr << "❌ Headless loop requires effects, and camera, graph and mask poller unless replaying" << std::endl;
+        return -1;
+    }
+    
+    g_headless_stop = 0;
+    auto prev_sigint = std::signal(SIGINT, HandleHeadlessStopSignal);
+    auto prev_sigterm = std::signal(SIGTERM, HandleHeadlessStopSignal);
+    
+    bool has_landmarks = live ? (multi_face_landmarks_poller != nullptr) : replay->HasLandmarks();
+    FrameSynchronizer frame_sync(MakeFrameSyncConfig(app_state, has_landmarks));
+    frame_sync.SetRecorder(app_state.session_recorder);
+    MaskDecoder mask_decoder;
+    FramePool* frame_pool = EffectsFramePool(managers);
+    if (managers.camera) {
+        managers.effects->UpdateTargetFPSFromCamera(managers.camera->GetCurrentFPS());
+    }
+    
+    int result = 0;
+    int64_t frame_id = 0;
+    int capture_failures = 0;
+    uint64_t processed = 0;
+    uint64_t written = 0;
+    uint64_t fps_frames = 0;
+    double fps = 0.0;
+    auto fps_last = std::chrono::steady_clock::now();
+    auto next_status = fps_last + kHeadlessStatusInterval;
+    auto next_vcam_attempt = fps_last;
+    
+    while (!g_headless_stop) {
+        try {
+            SEGMECAM_TRACE_SCOPE("frame");
+            
+            cv::Mat frame_bgr;
+            if (!live) {
+                // Recorded frame plus the outputs the graph produced for it
+                mediapipe::Timestamp ts;
+                if (!replay->NextFrame(frame_bgr, ts)) {
+                    std::cout << "📂 Replay finished" << std::endl;
+                    break;
+                }
+                frame_sync.AddFrame(ts, frame_bgr);
+                replay->FeedOutputs(ts, frame_sync);
+            } else {
+                if (!managers.camera->CaptureFrame(frame_bgr) || frame_bgr.empty()) {
+                    if (++capture_failures < 10) {  // Only log first few failures
+                        std::cout << "⚠️  Frame capture failed or empty (headless)" << std::endl;
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                    continue;
+                }
+                
+                std::unique_ptr<mediapipe::ImageFrame> frame;
+                MatToImageFrame(frame_bgr, frame, frame_pool);
+                auto ts = mediapipe::Timestamp(frame_id++);
+                absl::Status st;
+                {
+                    SEGMECAM_TRACE_SCOPE("graph.add_packet");
+                    st = mediapipe_graph->AddPacketToInputStream("input_video", mediapipe::Adopt(frame.release()).At(ts));
+                }
+                if (!st.ok()) {
+                    std::cerr << "❌ AddPacket failed: " << st.message() << std::endl;
+                    result = -1;
+                    break;
+                }
+                frame_sync.AddFrame(ts, frame_bgr);
+                
+                PollSegmentationMask(mask_poller.get(), mask_decoder, frame_sync, frame_pool, processed == 0);
+                if (has_landmarks) {
+                    PollFaceLandmarks(multi_face_landmarks_poller.get(), face_rects_poller.get(),
+                                      frame_sync, false);
+                }
+            }
+            
+            FusedFrame fused;
+            if (!frame_sync.PopReady(fused)) {
+                continue;
+            }
+            cv::Mat display_rgb = ProcessFusedFrame(managers, fused);
+            processed++;
+            
+            // (Re)open the loopback device at the output size; retry slowly if
+            // it is missing (e.g. v4l2loopback loaded after the service started)
+            auto now = std::chrono::steady_clock::now();
+            bool size_changed = display_rgb.cols != app_state.vcam.Width() ||
+                                display_rgb.rows != app_state.vcam.Height();
+            if ((!app_state.vcam.IsOpen() || size_changed) && now >= next_vcam_attempt) {
+                if (app_state.vcam.Open(app_state.virtual_camera_path, display_rgb.cols, display_rgb.rows)) {
+                    std::cout << "✅ Virtual camera opened: " << app_state.virtual_camera_path << " at "
+                              << display_rgb.cols << "x" << display_rgb.rows << std::endl;
+                } else {
+                    std::cerr << "❌ Failed to open virtual camera " << app_state.virtual_camera_path
+                              << ", retrying in " << kVCamRetryInterval.count() << "s" << std::endl;
+                    next_vcam_attempt = now + kVCamRetryInterval;
+                }
+            }
+            if (app_state.vcam.IsOpen()) {
+                SEGMECAM_TRACE_SCOPE("vcam.write_frame");
+                if (app_state.vcam.WriteRGB(display_rgb)) written++;
+            }
+            
+            // Output rate drives the auto processing scale
+            fps_frames++;
+            double elapsed_ms = std::chrono::duration<double, std::milli>(now - fps_last).count();
+            if (elapsed_ms >= 500.0) {
+                fps = (double)fps_frames * 1000.0 / elapsed_ms;
+                fps_frames = 0;
+                fps_last = now;
+                if (app_state.auto_processing_scale) {
+                    managers.effects->UpdateAutoProcessingScale((float)fps);
+                }
+            }
+            
+            if (now >= next_status) {
+                next_status = now + kHeadlessStatusInterval;
+                std::cout << "📊 Headless: " << std::fixed << std::setprecision(1) << fps << " fps, "
+                          << processed << " processed, " << written << " written, scale "
+                          << std::setprecision(2) << managers.effects->GetProcessingScale()
+                          << std::defaultfloat << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Exception in headless loop: " << e.what() << std::endl;
+            result = -1;
+            break;
+        } catch (...) {
+            std::cerr << "❌ Unknown exception in headless loop" << std::endl;
+            result = -1;
+            break;
+        }
+    }
+    
+    std::signal(SIGINT, prev_sigint);
+    std::signal(SIGTERM, prev_sigterm);
+    if (g_headless_stop) {
+        std::cout << "🛑 Stop signal received" << std::endl;
+    }
+    
+    const FrameSyncStats& sync_stats = frame_sync.GetStats();
+    std::cout << "📊 Frame sync - released: " << sync_stats.released << ", exact: " << sync_stats.exact_matches
+              << ", fallbacks: " << sync_stats.fallbacks << ", dropped: " << sync_stats.dropped_frames << std::endl;
+    std::cout << "🛑 Headless loop ended (" << processed << " frames processed)" << std::endl;
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Pipelined execution
+//
+// capture ──q──> effects ──q──> vcam
+//                   └─────q──> render/UI (main thread)
+//
+// Every queue is a short BoundedQueue with drop-oldest semantics so the
+// newest frame always wins. Shared objects that are not thread-safe are
+// guarded by one mutex each, held only around the individual call that
+// needs it: the UI never holds one across a frame. Effect settings reach the
+// effects stage as published snapshots, and its status (mask, auto scale)
+// comes back with each processed frame, so AppState stays on the render
+// thread.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr size_t kStageQueueDepth = 2;
+
+struct CapturedFrame {
+    int64_t seq = -1;
+    cv::Mat bgr;
+};
+
+struct ProcessedFrame {
+    int64_t seq = -1;
+    cv::Mat rgb;
+    // Status for the UI (render copy only)
+    cv::Mat mask_u8;
+    bool auto_scaled = false;
+    float current_fps = 0.0f;
+    float processing_scale = 1.0f;
+};
+
+} // namespace
+
+struct ApplicationRun::PipelineContext {
+    PipelineContext(ManagerCoordination::Managers& m,
+                    mediapipe::CalculatorGraph* g,
+                    mediapipe::OutputStreamPoller* mp,
+                    mediapipe::OutputStreamPoller* lp,
+                    mediapipe::OutputStreamPoller* rp,
+                    AppState& s)
+        : managers(m), graph(g), mask_poller(mp), landmarks_poller(lp), rects_poller(rp),
+          app_state(s),
+          fusion_policy(s.fusion_policy),
+          fusion_max_wait_ms(s.fusion_max_wait_ms),
+          capture_to_effects(kStageQueueDepth),
+          effects_to_vcam(kStageQueueDepth),
+          effects_to_render(kStageQueueDepth) {}
+
+    ManagerCoordination::Managers& managers;
+    mediapipe::CalculatorGraph* graph;
+    mediapipe::OutputStreamPoller* mask_poller;
+    mediapipe::OutputStreamPoller* landmarks_poller;
+    mediapipe::OutputStreamPoller* rects_poller;
+    AppState& app_state;              // Render thread, except vcam/ui_vcam_idx
+    std::atomic<int> fusion_policy;   // Render -> effects
+    std::atomic<int> fusion_max_wait_ms;
+
+    BoundedQueue<CapturedFrame> capture_to_effects;
+    BoundedQueue<ProcessedFrame> effects_to_vcam;
+    BoundedQueue<ProcessedFrame> effects_to_render;
+
+    // Lock order: vcam_mutex before camera_mutex; nothing else nests them.
+    std::mutex camera_mutex;   // CameraManager
+    std::mutex effects_mutex;  // EffectsManager
+    std::mutex vcam_mutex;     // AppState::vcam + ui_vcam_idx
+
+    std::atomic<bool> running{true};
+    std::atomic<double> effects_fps{0.0};
+};
+
+void ApplicationRun::RunCaptureStage(PipelineContext& ctx) {
+    Tracer::Instance().SetThreadName("capture");
+    int64_t frame_id = 0;
+    int failures = 0;
+    while (ctx.running.load(std::memory_order_relaxed)) {
+        try {
+            cv::Mat frame_bgr;
+            bool ok;
+            if (ctx.managers.camera->IsAsyncCaptureEnabled()) {
+                // Mailbox read is thread-safe and must not hold the UI off while waiting
+                ok = ctx.managers.camera->CaptureFrame(frame_bgr);
+            } else {
+                std::lock_guard<std::mutex> lock(ctx.camera_mutex);
+                ok = ctx.managers.camera->CaptureFrame(frame_bgr);
+            }
+            if (!ok || frame_bgr.empty()) {
+                if (++failures < 10) {  // Only log first few failures
+                    std::cout << "⚠️  Frame capture failed or empty (capture stage)" << std::endl;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                continue;
+            }
+            
+            // Send frame to MediaPipe graph (thread-safe)
+            std::unique_ptr<mediapipe::ImageFrame> frame;
+            MatToImageFrame(frame_bgr, frame, EffectsFramePool(ctx.managers));
+            absl::Status st;
+            {
+                SEGMECAM_TRACE_SCOPE("graph.add_packet");
+                st = ctx.graph->AddPacketToInputStream(
+                    "input_video", mediapipe::Adopt(frame.release()).At(mediapipe::Timestamp(frame_id)));
+            }
+            if (!st.ok()) {
+                std::cerr << "❌ AddPacket failed: " << st.message() << std::endl;
+                ctx.running = false;
+                break;
+            }
+            if (frame_id == 0) {
+                std::cout << "✅ First frame captured and sent to MediaPipe: "
+                          << frame_bgr.cols << "x" << frame_bgr.rows << std::endl;
+            }
+            
+            ctx.capture_to_effects.PushDropOldest(CapturedFrame{frame_id, std::move(frame_bgr)});
+            frame_id++;
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Exception in capture stage: " << e.what() << std::endl;
+            ctx.running = false;
+        } catch (...) {
+            std::cerr << "❌ Unknown exception in capture stage" << std::endl;
+            ctx.running = false;
+        }
+    }
+}
+
+void ApplicationRun::RunEffectsStage(PipelineContext& ctx) {
+    Tracer::Instance().SetThreadName("effects");
+    FrameSynchronizer frame_sync;
+    frame_sync.SetRecorder(ctx.app_state.session_recorder);
+    MaskDecoder mask_decoder;
+    bool expect_landmarks = (ctx.landmarks_poller != nullptr);
+    int processed = 0;
+    uint64_t fps_frames = 0;
+    auto fps_last = std::chrono::steady_clock::now();
+    
+    while (ctx.running.load(std::memory_order_relaxed)) {
+        try {
+            bool verbose = processed < 5;
+            
+            // Frames from capture wait in the synchronizer for their outputs
+            CapturedFrame in;
+            if (ctx.capture_to_effects.TryPop(in)) {
+                frame_sync.AddFrame(mediapipe::Timestamp(in.seq), in.bgr);
+            }
+            
+            // Pollers are only touched by this stage
+            PollSegmentationMask(ctx.mask_poller, mask_decoder, frame_sync, EffectsFramePool(ctx.managers), verbose);
+            PollFaceLandmarks(ctx.landmarks_poller, ctx.rects_poller, frame_sync, verbose);
+            
+            frame_sync.SetConfig(MakeFrameSyncConfig(ctx.fusion_policy.load(std::memory_order_relaxed),
+                                                     ctx.fusion_max_wait_ms.load(std::memory_order_relaxed),
+                                                     expect_landmarks));
+            FusedFrame fused;
+            if (!frame_sync.PopReady(fused)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            
+            // Throughput of this stage drives the auto processing scale
+            fps_frames++;
+            auto now = std::chrono::steady_clock::now();
+            double elapsed_ms = std::chrono::duration<double, std::milli>(now - fps_last).count();
+            if (elapsed_ms >= 500.0) {
+                ctx.effects_fps = (double)fps_frames * 1000.0 / elapsed_ms;
+                fps_frames = 0;
+                fps_last = now;
+            }
+            
+            ProcessedFrame out;
+            out.seq = fused.timestamp.Value();
+            {
+                std::lock_guard<std::mutex> lock(ctx.effects_mutex);
+                out.rgb = ProcessFusedFrame(ctx.managers, fused);
+                
+                double fps = ctx.effects_fps.load(std::memory_order_relaxed);
+                if (ctx.managers.effects->IsAutoProcessingScaleEnabled() && fps > 0.0) {
+                    ctx.managers.effects->UpdateAutoProcessingScale((float)fps);
+                    out.auto_scaled = true;
+                    out.current_fps = ctx.managers.effects->GetCurrentFPS();
+                    out.processing_scale = ctx.managers.effects->GetProcessingScale();
+                }
+            }
+            out.mask_u8 = fused.mask_u8;
+            
+            // Output is read-only from here on, both consumers share the buffer
+            ProcessedFrame to_vcam;
+            to_vcam.seq = out.seq;
+            to_vcam.rgb = out.rgb;
+            ctx.effects_to_vcam.PushDropOldest(std::move(to_vcam));
+            ctx.effects_to_render.PushDropOldest(std::move(out));
+            processed++;
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Exception in effects stage: " << e.what() << std::endl;
+            ctx.running = false;
+        } catch (...) {
+            std::cerr << "❌ Unknown exception in effects stage" << std::endl;
+            ctx.running = false;
+        }
+    }
+    
+    const FrameSyncStats& st = frame_sync.GetStats();
+    std::cout << "📊 Frame sync - released: " << st.released << ", exact: " << st.exact_matches
+              << ", fallbacks: " << st.fallbacks << ", dropped: " << st.dropped_frames << std::endl;
+}
+
+void ApplicationRun::RunVCamStage(PipelineContext& ctx) {
+    Tracer::Instance().SetThreadName("vcam");
+    while (ctx.running.load(std::memory_order_relaxed)) {
+        try {
+            ProcessedFrame in;
+            if (!ctx.effects_to_vcam.TryPop(in)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            // Camera lock is taken inside, only to read the loopback list when reopening
+            std::lock_guard<std::mutex> lock(ctx.vcam_mutex);
+            WriteToVirtualCamera(ctx.managers, ctx.app_state, in.rgb, &ctx.camera_mutex);
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Exception in vcam stage: " << e.what() << std::endl;
+            ctx.running = false;
+        } catch (...) {
+            std::cerr << "❌ Unknown exception in vcam stage" << std::endl;
+            ctx.running = false;
+        }
+    }
+}
+
+int ApplicationRun::ExecutePipelinedLoop(
+    ManagerCoordination::Managers& managers,
+    std::unique_ptr<mediapipe::CalculatorGraph>& mediapipe_graph,
+    std::unique_ptr<mediapipe::OutputStreamPoller>& mask_poller,
+    std::unique_ptr<mediapipe::OutputStreamPoller>& multi_face_landmarks_poller,
+    std::unique_ptr<mediapipe::OutputStreamPoller>& face_rects_poller,
+    SDL_Window* window,
+    AppState& app_state
+) {
+    std::cout << "🎥 Starting pipelined application loop..." << std::endl;
+    
+    if (!managers.camera || !managers.effects || !mediapipe_graph || !mask_poller) {
+        std::cerr << "❌ Pipelined loop requires camera, effects, graph and mask poller" << std::endl;
+        return -1;
+    }
+    
+    UIManager ui_manager;
+    if (!ui_manager.Initialize(window)) {
+        std::cerr << "❌ Failed to initialize UIManager Enhanced" << std::endl;
+        return -1;
+    }
+    
+    PipelineContext ctx(managers, mediapipe_graph.get(), mask_poller.get(),
+                        multi_face_landmarks_poller.get(), face_rects_poller.get(), app_state);
+    
+    PanelLocks panel_locks;
+    panel_locks.camera = &ctx.camera_mutex;
+    panel_locks.vcam = &ctx.vcam_mutex;
+    ui_manager.InitializePanels(app_state, *managers.camera, managers.config.get(), panel_locks);
+    std::cout << "✅ UIManager Enhanced initialized successfully" << std::endl;
+    
+    Tracer::Instance().SetThreadName("render");
+    std::thread capture_thread(RunCaptureStage, std::ref(ctx));
+    std::thread effects_thread(RunEffectsStage, std::ref(ctx));
+    std::thread vcam_thread(RunVCamStage, std::ref(ctx));
+    std::cout << "✅ Pipeline stages started (capture, effects, vcam)" << std::endl;
+    
+    // Render stage (main thread owns the GL context)
+    bool running = true;
+    cv::Mat display_rgb;
+    double fps = 0.0;
+    uint64_t fps_frames = 0;
+    uint32_t fps_last_ms = SDL_GetTicks();
+    float last_camera_fps = -1.0f;
+    
+    while (running && ctx.running.load(std::memory_order_relaxed)) {
+        try {
+            // Always show the newest processed frame
+            bool new_frame = false;
+            ProcessedFrame pf;
+            while (ctx.effects_to_render.TryPop(pf)) {
+                display_rgb = std::move(pf.rgb);
+                if (!pf.mask_u8.empty()) {
+                    app_state.last_mask_u8 = std::move(pf.mask_u8);
+                }
+                if (pf.auto_scaled) {
+                    app_state.current_fps = pf.current_fps;
+                    app_state.fx_adv_scale = pf.processing_scale;
+                }
+                new_frame = true;
+            }
+            if (new_frame) {
+                app_state.last_display_rgb = display_rgb;
+                UpdateFPSTracking(fps, fps_frames, fps_last_ms);
+            }
+            
+            app_state.fps = fps;
+            {
+                std::lock_guard<std::mutex> lock(ctx.camera_mutex);
+                app_state.camera_width = managers.camera->GetCurrentWidth();
+                app_state.camera_height = managers.camera->GetCurrentHeight();
+                app_state.camera_fps = managers.camera->GetCurrentFPS();
+            }
+            
+            // Status is copied out so the effects stage only waits for the copy
+            EffectsState effects_status;
+            {
+                std::lock_guard<std::mutex> lock(ctx.effects_mutex);
+                // Auto-update target FPS based on camera settings
+                if (std::abs(app_state.camera_fps - last_camera_fps) > 0.1f) {
+                    managers.effects->UpdateTargetFPSFromCamera(app_state.camera_fps);
+                    app_state.target_fps = managers.effects->GetTargetFPS();
+                    last_camera_fps = app_state.camera_fps;
+                }
+                effects_status = managers.effects->GetState();
+            }
+            SyncStatusFromEffectsManager(effects_status, app_state);
+            
+            if (!ui_manager.ProcessEvents(running)) {
+                std::cout << "🛑 UIManager ProcessEvents returned false, exiting..." << std::endl;
+                break;
+            }
+            HandleDroppedFiles(ui_manager, app_state);
+            if (!running) break;
+            
+            int dw, dh;
+            SDL_GL_GetDrawableSize(window, &dw, &dh);
+            glViewport(0, 0, dw, dh);
+            glClearColor(0.06f, 0.06f, 0.07f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            
+            GLuint video_texture = CreateVideoTexture(display_rgb);
+            if (video_texture && !display_rgb.empty()) {
+                glBindTexture(GL_TEXTURE_2D, video_texture);
+                RenderVideoBackground(display_rgb, dw, dh);
+            }
+            
+            {
+                SEGMECAM_TRACE_SCOPE("render.ui");
+                ui_manager.BeginFrame();
+                ui_manager.RenderUI();
+            }
+            
+            // Effects stage picks these up on its next frame
+            PublishEffectsSettings(*managers.effects, app_state);
+            ctx.fusion_policy.store(app_state.fusion_policy, std::memory_order_relaxed);
+            ctx.fusion_max_wait_ms.store(app_state.fusion_max_wait_ms, std::memory_order_relaxed);
+            
+            if (video_texture) {
+                glDeleteTextures(1, &video_texture);
+            }
+            
+            {
+                SEGMECAM_TRACE_SCOPE("render.present");
+                ui_manager.EndFrame();
+            }
+            
+            if (!new_frame) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Exception in render stage: " << e.what() << std::endl;
+            break;
+        } catch (...) {
+            std::cerr << "❌ Unknown exception in render stage" << std::endl;
+            break;
+        }
+    }
+    
+    ctx.running = false;
+    capture_thread.join();
+    effects_thread.join();
+    vcam_thread.join();
+    
+    std::cout << "📊 Pipeline drops - camera mailbox: " << managers.camera->GetDroppedFrameCount()
+              << ", capture->effects: " << ctx.capture_to_effects.DroppedCount()
+              << ", effects->vcam: " << ctx.effects_to_vcam.DroppedCount()
+              << ", effects->render: " << ctx.effects_to_render.DroppedCount() << std::endl;
+    std::cout << "🛑 Pipelined loop ended" << std::endl;
+    return 0;
+}
+
 } // namespace segmecam
\ No newline at end of file
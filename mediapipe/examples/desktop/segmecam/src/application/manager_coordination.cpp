@@ -7,19 +7,24 @@
 #include <iostream>
 #include <cstring>
 
-bool ManagerCoordination::SetupManagers(Managers& managers, segmecam::AppState& app_state) {
+bool ManagerCoordination::SetupManagers(Managers& managers, segmecam::AppState& app_state,
+                                        const std::string& profile_name, bool camera_optional) {
     std::cout << "Initializing essential managers..." << std::endl;
     
     // Initialize config manager
-    if (!InitializeConfigManager(managers, app_state)) {
+    if (!InitializeConfigManager(managers, app_state, profile_name)) {
         std::cerr << "Error: Failed to initialize ConfigManager" << std::endl;
         return false;
     }
     
     // Initialize camera manager
     if (!InitializeCameraManager(managers, app_state)) {
-        std::cerr << "Error: Failed to initialize CameraManager" << std::endl;
-        return false;
+        if (!camera_optional) {
+            std::cerr << "Error: Failed to initialize CameraManager" << std::endl;
+            return false;
+        }
+        std::cout << "No camera available, continuing without CameraManager" << std::endl;
+        managers.camera.reset();
     }
     
     // Initialize effects manager
@@ -70,17 +75,28 @@ bool ManagerCoordination::ValidateManagers(const Managers& managers) {
     return true;
 }
 
-bool ManagerCoordination::InitializeConfigManager(Managers& managers, segmecam::AppState& app_state) {
+bool ManagerCoordination::ResolveProfileName(const Managers& managers, const std::string& requested,
+                                             std::string& name) {
+    if (!managers.config) return false;
+    if (!requested.empty()) {
+        name = requested;
+        return true;
+    }
+    return managers.config->GetDefaultProfile(name) && !name.empty();
+}
+
+bool ManagerCoordination::InitializeConfigManager(Managers& managers, segmecam::AppState& app_state,
+                                                  const std::string& profile_name) {
     try {
         managers.config = std::make_unique<segmecam::ConfigManager>();
         
         // ConfigManager doesn't have an Initialize method, it's ready to use
         std::cout << "ConfigManager created successfully" << std::endl;
         
-        // Try to get default profile
+        // Try to get the requested (or default) profile
         std::string default_profile;
-        if (managers.config->GetDefaultProfile(default_profile) && !default_profile.empty()) {
-            std::cout << "Loading default profile: " << default_profile << std::endl;
+        if (ResolveProfileName(managers, profile_name, default_profile)) {
+            std::cout << "Loading profile: " << default_profile << std::endl;
             // Load the default profile using ConfigData and apply basic settings
             segmecam::ConfigData config_data;
             if (managers.config->LoadProfile(default_profile, config_data)) {
@@ -90,9 +106,18 @@ bool ManagerCoordination::InitializeConfigManager(Managers& managers, segmecam::
                 app_state.show_landmarks = config_data.display.show_landmarks;
                 app_state.bg_mode = config_data.background.bg_mode;
                 app_state.blur_strength = config_data.background.blur_strength;
+                app_state.blur_backend = config_data.background.blur_backend;
+                app_state.mask_upsampler = config_data.background.mask_upsampler;
+                app_state.feather_px = config_data.background.feather_px;
+                app_state.solid_color[0] = config_data.background.solid_color[0];
+                app_state.solid_color[1] = config_data.background.solid_color[1];
+                app_state.solid_color[2] = config_data.background.solid_color[2];
                 // Apply background path from profile to preserve it for future saves
                 strncpy(app_state.bg_path_buf, config_data.background.bg_path.c_str(), sizeof(app_state.bg_path_buf) - 1);
                 app_state.bg_path_buf[sizeof(app_state.bg_path_buf) - 1] = '\0';
+                strncpy(app_state.bg_video_path_buf, config_data.background.bg_video_path.c_str(), sizeof(app_state.bg_video_path_buf) - 1);
+                app_state.bg_video_path_buf[sizeof(app_state.bg_video_path_buf) - 1] = '\0';
+                app_state.bg_video_preload = config_data.background.bg_video_preload;
                 
                 // Apply beauty effects settings from profile
                 app_state.fx_skin = config_data.beauty.fx_skin;
@@ -104,6 +129,8 @@ bool ManagerCoordination::InitializeConfigManager(Managers& managers, segmecam::
                 app_state.fx_skin_edge = config_data.beauty.fx_skin_edge;
                 app_state.fx_adv_scale = config_data.beauty.fx_adv_scale;
                 app_state.fx_adv_detail_preserve = config_data.beauty.fx_adv_detail_preserve;
+                app_state.auto_processing_scale = config_data.beauty.auto_processing_scale;
+                app_state.target_fps = config_data.beauty.target_fps;
                 
                 // Wrinkle settings
                 app_state.fx_skin_wrinkle = config_data.beauty.fx_skin_wrinkle;
@@ -156,7 +183,11 @@ bool ManagerCoordination::InitializeConfigManager(Managers& managers, segmecam::
                 }
                 
                 // Note: Full beauty effects will be loaded by UI panels
-                std::cout << "Default profile loaded successfully: " << default_profile << std::endl;
+                std::cout << "Profile loaded successfully: " << default_profile << std::endl;
+            } else if (!profile_name.empty()) {
+                // An explicitly requested profile must exist (headless runs rely on it)
+                std::cerr << "Failed to load profile: " << profile_name << std::endl;
+                return false;
             } else {
                 std::cout << "Failed to load default profile: " << default_profile << std::endl;
             }
@@ -228,8 +259,8 @@ bool ManagerCoordination::InitializeEffectsManager(Managers& managers, segmecam:
             return false;
         }
         
-        // Sync profile settings to EffectsManager after initialization
-        segmecam::ApplicationRun::SyncSettingsToEffectsManager(*managers.effects, app_state);
+        // Publish profile settings to EffectsManager after initialization
+        segmecam::ApplicationRun::PublishEffectsSettings(*managers.effects, app_state);
         
         // Sync status from EffectsManager back to app_state (e.g., OpenCL availability)
         segmecam::ApplicationRun::SyncStatusFromEffectsManager(*managers.effects, app_state);
@@ -242,15 +273,16 @@ bool ManagerCoordination::InitializeEffectsManager(Managers& managers, segmecam:
     }
 }
 
-void ManagerCoordination::LoadDefaultProfileBackgroundImage(Managers& managers, segmecam::AppState& app_state) {
+void ManagerCoordination::LoadDefaultProfileBackgroundImage(Managers& managers, segmecam::AppState& app_state,
+                                                            const std::string& profile_name) {
     if (!managers.config || !managers.effects) {
         std::cout << "Config or Effects manager not available for default profile background loading" << std::endl;
         return;
     }
     
-    // Check if there's a default profile set
+    // Check if there's a requested or default profile
     std::string default_profile;
-    if (!managers.config->GetDefaultProfile(default_profile) || default_profile.empty()) {
+    if (!ResolveProfileName(managers, profile_name, default_profile)) {
         std::cout << "No default profile set for background image loading" << std::endl;
         return;
     }
@@ -1,7 +1,9 @@
 #include "include/camera/camera_manager.h"
+#include "include/pipeline/trace.h"
 
 #include <iostream>
 #include <algorithm>
+#include <chrono>
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
@@ -31,6 +33,7 @@ CameraManager::CameraManager() {
 }
 
 CameraManager::~CameraManager() {
+    StopAsyncCapture();
     Cleanup();
 #ifdef FLATPAK_BUILD
     CleanupGStreamer();
@@ -40,6 +43,7 @@ CameraManager::~CameraManager() {
 int CameraManager::Initialize(const CameraConfig& config) {
     config_ = config;
     state_ = CameraState{}; // Reset state
+    async_enabled_ = config_.async_capture;
 
     std::cout << "📷 Initializing Camera Manager..." << std::endl;
 
@@ -212,6 +216,10 @@ bool CameraManager::OpenCamera(int camera_index, int width, int height, int fps)
               << " @ " << state_.actual_fps << " FPS" << std::endl;
     std::cout << "🔧 Backend: " << state_.backend_name << std::endl;
 
+    if (async_enabled_) {
+        StartAsyncCapture();
+    }
+
     return true;
 #endif
 }
@@ -220,6 +228,7 @@ void CameraManager::CloseCamera() {
 #ifdef FLATPAK_BUILD
     StopPipeWireCapture();
 #else
+    StopAsyncCapture();
     if (cap_.isOpened()) {
         cap_.release();
         state_.is_opened = false;
@@ -232,7 +241,25 @@ bool CameraManager::IsOpened() const {
     return state_.is_opened && cap_.isOpened();
 }
 
-bool CameraManager::CaptureFrame(cv::Mat& frame) {
+bool CameraManager::CaptureFrame(cv::Mat& frame, uint64_t* sequence) {
+    SEGMECAM_TRACE_SCOPE("camera.capture");
+#ifndef FLATPAK_BUILD
+    if (async_enabled_) {
+        // Latest-frame mailbox: never touches cap_, safe to call from another thread
+        std::unique_lock<std::mutex> lock(mailbox_mutex_);
+        mailbox_cv_.wait_for(lock, std::chrono::milliseconds(capture_wait_ms_), [this] {
+            return !async_running_ || (mailbox_slot_ >= 0 && mailbox_seq_ > consumed_seq_);
+        });
+        if (mailbox_slot_ < 0 || mailbox_seq_ <= consumed_seq_) {
+            return false;
+        }
+        frame = capture_pool_[mailbox_slot_];  // Shares the buffer, refcount pins it
+        consumed_seq_ = mailbox_seq_;
+        if (sequence) *sequence = consumed_seq_;
+        return true;
+    }
+#endif
+
     if (!IsOpened()) {
         return false;
     }
@@ -252,12 +279,136 @@ bool CameraManager::CaptureFrame(cv::Mat& frame) {
     bool success = cap_.read(frame);
     if (success) {
         state_.frames_captured++;
+        if (sequence) *sequence = (uint64_t)state_.frames_captured;
     }
 
     return success;
 #endif
 }
 
+void CameraManager::SetMinCapturePoolSize(int buffers) {
+    if (buffers <= config_.capture_pool_size) return;
+    config_.capture_pool_size = buffers;
+#ifndef FLATPAK_BUILD
+    if (async_running_) {
+        // The pool is only sized on start
+        StopAsyncCapture();
+        StartAsyncCapture();
+    }
+#endif
+}
+
+void CameraManager::SetAsyncCapture(bool enabled) {
+    if (async_enabled_ == enabled) return;
+    async_enabled_ = enabled;
+#ifndef FLATPAK_BUILD
+    if (enabled && IsOpened()) {
+        StartAsyncCapture();
+    } else if (!enabled) {
+        StopAsyncCapture();
+    }
+#endif
+}
+
+uint64_t CameraManager::GetLatestFrameSequence() const {
+    std::lock_guard<std::mutex> lock(mailbox_mutex_);
+    return mailbox_seq_;
+}
+
+bool CameraManager::StartAsyncCapture() {
+#ifdef FLATPAK_BUILD
+    // PipeWire frames already arrive asynchronously through the appsink callback
+    return false;
+#else
+    if (async_running_ || !cap_.isOpened()) return async_running_;
+
+    {
+        std::lock_guard<std::mutex> lock(mailbox_mutex_);
+        // Preallocate the pool at the negotiated size so steady-state decode
+        // writes into existing buffers
+        int pool_size = std::max(3, config_.capture_pool_size);
+        capture_pool_.assign(pool_size, cv::Mat());
+        if (state_.current_width > 0 && state_.current_height > 0) {
+            for (auto& buf : capture_pool_) {
+                buf.create(state_.current_height, state_.current_width, CV_8UC3);
+            }
+        }
+        mailbox_slot_ = -1;
+        consumed_seq_ = mailbox_seq_;
+        double fps = state_.actual_fps > 0.0 ? state_.actual_fps : 30.0;
+        capture_wait_ms_ = std::clamp((int)(2000.0 / fps), 50, 250);
+    }
+
+    capture_stop_ = false;
+    async_running_ = true;
+    capture_thread_ = std::thread(&CameraManager::CaptureThreadLoop, this);
+    std::cout << "🚀 Async capture started (" << capture_pool_.size() << " buffers)" << std::endl;
+    return true;
+#endif
+}
+
+void CameraManager::StopAsyncCapture() {
+    if (!capture_thread_.joinable()) return;
+    capture_stop_ = true;
+    capture_thread_.join();
+    {
+        std::lock_guard<std::mutex> lock(mailbox_mutex_);
+        async_running_ = false;
+        mailbox_slot_ = -1;
+    }
+    mailbox_cv_.notify_all();
+    std::cout << "📷 Async capture stopped (dropped " << frames_dropped_.load() << " frames)" << std::endl;
+}
+
+int CameraManager::AcquireFreePoolSlot() {
+    std::lock_guard<std::mutex> lock(mailbox_mutex_);
+    int fallback = -1;
+    for (int i = 0; i < (int)capture_pool_.size(); ++i) {
+        if (i == mailbox_slot_) continue;
+        cv::Mat& buf = capture_pool_[i];
+        // Free when only the pool references it (consumers hold Mat copies)
+        if (!buf.u || CV_XADD(&buf.u->refcount, 0) == 1) return i;
+        if (fallback < 0) fallback = i;
+    }
+    // Every buffer is still held downstream: detach one and let the next read
+    // allocate a replacement (the old buffer lives on with its holder)
+    if (fallback >= 0) capture_pool_[fallback] = cv::Mat();
+    return fallback;
+}
+
+void CameraManager::CaptureThreadLoop() {
+    Tracer::Instance().SetThreadName("camera");
+    while (!capture_stop_) {
+        int slot = AcquireFreePoolSlot();
+        if (slot < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // Blocks on the frame interval + MJPEG decode, off the processing path
+        cv::Mat& buf = capture_pool_[slot];
+        bool ok;
+        {
+            SEGMECAM_TRACE_SCOPE("camera.read");
+            ok = cap_.read(buf);
+        }
+        if (!ok || buf.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mailbox_mutex_);
+            if (mailbox_slot_ >= 0 && mailbox_seq_ > consumed_seq_) {
+                frames_dropped_++;  // Previous frame was never picked up
+            }
+            mailbox_slot_ = slot;
+            mailbox_seq_++;
+        }
+        mailbox_cv_.notify_all();
+    }
+}
+
 void CameraManager::RefreshCameraList() {
     std::cout << "🔍 Enumerating cameras..." << std::endl;
     cam_list_ = EnumerateCameras();
@@ -327,6 +478,10 @@ const std::vector<std::pair<int,int>>& CameraManager::GetCurrentResolutions() co
 bool CameraManager::SetResolution(int width, int height) {
     if (!IsOpened()) return false;
     
+    // The capture thread must not read while the format changes
+    bool restart_async = async_running_;
+    StopAsyncCapture();
+    
     cap_.set(cv::CAP_PROP_FRAME_WIDTH, width);
     cap_.set(cv::CAP_PROP_FRAME_HEIGHT, height);
     
@@ -337,6 +492,10 @@ bool CameraManager::SetResolution(int width, int height) {
     state_.current_width = (int)actual_w;
     state_.current_height = (int)actual_h;
     
+    if (restart_async) {
+        StartAsyncCapture();
+    }
+    
     return (state_.current_width == width && state_.current_height == height);
 }
 
@@ -474,7 +633,7 @@ double CameraManager::GetActualFPS() const {
 }
 
 void CameraManager::UpdatePerformanceStats() {
-    if (IsOpened()) {
+    if (IsOpened() && !async_running_) {
         state_.actual_fps = cap_.get(cv::CAP_PROP_FPS);
     }
 }
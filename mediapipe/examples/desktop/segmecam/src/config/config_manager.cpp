@@ -177,8 +177,10 @@ bool ConfigManager::ValidateConfig(const ConfigData& config) const {
     // Basic validation - can be extended as needed
     if (config.camera.res_w < 0 || config.camera.res_h < 0) return false;
     if (config.camera.fps_value < 0) return false;
-    if (config.background.bg_mode < 0 || config.background.bg_mode > 3) return false;
+    if (config.background.bg_mode < 0 || config.background.bg_mode > 4) return false;
     if (config.background.blur_strength < 1) return false;
+    if (config.background.blur_backend < 0 || config.background.blur_backend > 2) return false;
+    if (config.background.mask_upsampler < 0 || config.background.mask_upsampler > 1) return false;
     if (config.background.feather_px < 0.0f) return false;
     
     // Validate color arrays are in valid range [0.0, 1.0]
@@ -238,10 +240,14 @@ bool ConfigManager::WriteConfigToStorage(cv::FileStorage& fs, const ConfigData&
         // Background settings
         fs << "bg_mode" << config.background.bg_mode;
         fs << "blur_strength" << config.background.blur_strength;
+        fs << "blur_backend" << config.background.blur_backend;
+        fs << "mask_upsampler" << config.background.mask_upsampler;
         fs << "feather_px" << config.background.feather_px;
         fs << "solid_color" << "[" << config.background.solid_color[0] 
            << config.background.solid_color[1] << config.background.solid_color[2] << "]";
         fs << "bg_path" << config.background.bg_path;
+        fs << "bg_video_path" << config.background.bg_video_path;
+        fs << "bg_video_preload" << (int)config.background.bg_video_preload;
         
         // Landmark settings
         fs << "lm_roi_mode" << (int)config.landmarks.lm_roi_mode;
@@ -339,10 +345,14 @@ bool ConfigManager::ReadConfigFromStorage(cv::FileStorage& fs, ConfigData& confi
         // Background settings
         config.background.bg_mode = ReadInt(root["bg_mode"], 0);
         config.background.blur_strength = ReadInt(root["blur_strength"], 25);
+        config.background.blur_backend = ReadInt(root["blur_backend"], 0);
+        config.background.mask_upsampler = ReadInt(root["mask_upsampler"], 0);
         config.background.feather_px = ReadFloat(root["feather_px"], 2.0f);
         ReadColorArray(root["solid_color"], config.background.solid_color, 
                       (const float[]){0.0f, 0.0f, 0.0f});
         config.background.bg_path = ReadString(root["bg_path"], "");
+        config.background.bg_video_path = ReadString(root["bg_video_path"], "");
+        config.background.bg_video_preload = ReadInt(root["bg_video_preload"], 1) != 0;
         
         // Landmark settings
         config.landmarks.lm_roi_mode = ReadInt(root["lm_roi_mode"], 0) != 0;
@@ -468,6 +478,8 @@ void ConfigData::ApplyBeautyPreset(int preset_index) {
     // Copy current beauty settings to BeautyState
     state.bg_mode = background.bg_mode;
     state.blur_strength = background.blur_strength;
+    state.blur_backend = background.blur_backend;
+    state.mask_upsampler = background.mask_upsampler;
     state.feather_px = background.feather_px;
     state.show_mask = display.show_mask;
     
@@ -520,6 +532,8 @@ void ConfigData::ApplyBeautyPreset(int preset_index) {
     // Copy back to ConfigData
     background.bg_mode = state.bg_mode;
     background.blur_strength = state.blur_strength;
+    background.blur_backend = state.blur_backend;
+    background.mask_upsampler = state.mask_upsampler;
     background.feather_px = state.feather_px;
     display.show_mask = state.show_mask;
     
@@ -103,11 +103,15 @@ struct ConfigData {
     
     // Background settings
     struct BackgroundConfig {
-        int bg_mode = 0;  // 0=None, 1=Blur, 2=Image, 3=Color
+        int bg_mode = 0;  // 0=None, 1=Blur, 2=Image, 3=Color, 4=Video
         int blur_strength = 25;
+        int blur_backend = 0;  // 0=Gaussian, 1=Box (constant time), 2=Pyramid (push-pull)
+        int mask_upsampler = 0;  // 0=Bilinear, 1=Guided (edge-aware)
         float feather_px = 2.0f;
         float solid_color[3] = {0.0f, 0.0f, 0.0f};
         std::string bg_path;
+        std::string bg_video_path;
+        bool bg_video_preload = true;  // Hold short clips fully decoded in memory
     } background;
     
     // Landmark settings
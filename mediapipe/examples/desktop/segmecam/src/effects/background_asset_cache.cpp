@@ -0,0 +1,47 @@
+#include "include/effects/background_asset_cache.h"
+#include "include/pipeline/trace.h"
+
+#include <algorithm>
+#include <opencv2/imgproc.hpp>
+
+namespace segmecam {
+
+const cv::Mat& BackgroundAssetCache::Get(const cv::Mat& image, uint64_t generation, const cv::Size& size) {
+    stats_.lookups++;
+    clock_++;
+
+    // Plates of an older image are never needed again
+    plates_.erase(std::remove_if(plates_.begin(), plates_.end(),
+                                 [&](const Plate& p) { return p.generation != generation; }),
+                  plates_.end());
+
+    for (Plate& p : plates_) {
+        if (p.size == size) {
+            p.last_used = clock_;
+            return p.bgr;
+        }
+    }
+
+    SEGMECAM_TRACE_SCOPE("bg_asset.rebuild");
+    if (plates_.size() >= kMaxPlates) {
+        auto lru = std::min_element(plates_.begin(), plates_.end(),
+                                    [](const Plate& a, const Plate& b) { return a.last_used < b.last_used; });
+        plates_.erase(lru);
+    }
+    Plate plate;
+    plate.generation = generation;
+    plate.size = size;
+    plate.last_used = clock_;
+    if (image.size() == size) {
+        plate.bgr = image;  // Shared, read-only
+    } else {
+        // Area filter when shrinking (no aliasing), linear when enlarging
+        bool shrink = image.cols > size.width || image.rows > size.height;
+        cv::resize(image, plate.bgr, size, 0, 0, shrink ? cv::INTER_AREA : cv::INTER_LINEAR);
+    }
+    stats_.rebuilds++;
+    plates_.push_back(std::move(plate));
+    return plates_.back().bgr;
+}
+
+} // namespace segmecam
@@ -0,0 +1,147 @@
+#include "include/effects/background_blur_cache.h"
+#include "include/pipeline/trace.h"
+#include "segmecam_composite.h"
+
+#include <algorithm>
+#include <opencv2/imgproc.hpp>
+
+namespace segmecam {
+
+namespace {
+
+constexpr int kProbeScale = 4;  // Change detection runs at 1/4 resolution
+
+} // namespace
+
+void BackgroundBlurCache::Reset() {
+    plate_.release();
+    ref_luma_.release();
+    ref_mask_.release();
+    blur_strength_ = -1;
+    engine_ = -1;
+    frames_since_refresh_ = 0;
+}
+
+void BackgroundBlurCache::Downscale(const cv::Mat& frame_bgr, const cv::Mat& mask_u8,
+                                   cv::Mat& luma, cv::Mat& mask) {
+    cv::Size small((frame_bgr.cols + kProbeScale - 1) / kProbeScale,
+                   (frame_bgr.rows + kProbeScale - 1) / kProbeScale);
+    // Area-downscale the colour frame first: one full-resolution read
+    cv::resize(frame_bgr, small_bgr_, small, 0, 0, cv::INTER_AREA);
+    cv::cvtColor(small_bgr_, luma, cv::COLOR_BGR2GRAY);
+    cv::resize(mask_u8, mask, small, 0, 0, cv::INTER_AREA);
+}
+
+void BackgroundBlurCache::FullRefresh(const cv::Mat& frame_bgr, const cv::Mat& mask_u8, FramePool* pool) {
+    BlurredBackgroundPlateBGR(frame_bgr, mask_u8, blur_strength_, engine_, pool).copyTo(plate_);
+    cur_luma_.copyTo(ref_luma_);
+    cur_mask_.copyTo(ref_mask_);
+    frames_since_refresh_ = 0;
+    stats_.full_refreshes++;
+}
+
+const cv::Mat& BackgroundBlurCache::Update(const cv::Mat& frame_bgr, const cv::Mat& mask_u8,
+                                           int blur_strength, int engine, FramePool* pool) {
+    SEGMECAM_TRACE_SCOPE("blur_cache.update");
+    const int ts = std::max(kProbeScale, config_.tile_size / kProbeScale * kProbeScale);
+    const int tiles_x = (frame_bgr.cols + ts - 1) / ts;
+    const int tiles_y = (frame_bgr.rows + ts - 1) / ts;
+    const int tile_count = tiles_x * tiles_y;
+    stats_.frames++;
+    stats_.tiles_total += (uint64_t)tile_count;
+
+    {
+        SEGMECAM_TRACE_SCOPE("blur_cache.probe");
+        Downscale(frame_bgr, mask_u8, cur_luma_, cur_mask_);
+    }
+
+    bool settings_changed = (blur_strength != blur_strength_ || engine != engine_);
+    blur_strength_ = blur_strength;
+    engine_ = engine;
+    if (plate_.size() != frame_bgr.size() || settings_changed || engine == 2 ||
+        ++frames_since_refresh_ >= config_.full_refresh_interval) {
+        FullRefresh(frame_bgr, mask_u8, pool);
+        return plate_;
+    }
+
+    // Stale tiles: their own inputs drifted from what the plate was built on
+    const int sts = ts / kProbeScale;
+    stale_.assign((size_t)tile_count, 0);
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        for (int tx = 0; tx < tiles_x; ++tx) {
+            cv::Rect r(tx * sts, ty * sts, sts, sts);
+            r &= cv::Rect(0, 0, cur_luma_.cols, cur_luma_.rows);
+            double sad = cv::norm(cur_luma_(r), ref_luma_(r), cv::NORM_L1) / (double)r.area();
+            bool stale = sad > config_.luma_sad_threshold ||
+                         cv::norm(cur_mask_(r), ref_mask_(r), cv::NORM_INF) > config_.mask_threshold;
+            stale_[ty * tiles_x + tx] = stale ? 1 : 0;
+        }
+    }
+
+    // A change reaches as far as the blur kernel: grow by that many tiles
+    const int margin = (blur_strength | 1) / 2 + 1;
+    const int grow = (margin + ts - 1) / ts;
+    dirty_.assign((size_t)tile_count, 0);
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        for (int tx = 0; tx < tiles_x; ++tx) {
+            if (!stale_[ty * tiles_x + tx]) continue;
+            for (int y = std::max(0, ty - grow); y <= std::min(tiles_y - 1, ty + grow); ++y) {
+                for (int x = std::max(0, tx - grow); x <= std::min(tiles_x - 1, tx + grow); ++x) {
+                    dirty_[y * tiles_x + x] = 1;
+                }
+            }
+        }
+    }
+
+    // Past a point the padding around the dirty regions costs more than
+    // blurring the whole frame once
+    const int dirty_count = (int)std::count(dirty_.begin(), dirty_.end(), (uint8_t)1);
+    if (dirty_count > config_.full_refresh_dirty_ratio * tile_count) {
+        FullRefresh(frame_bgr, mask_u8, pool);
+        return plate_;
+    }
+
+    // Runs of dirty tiles, merged with the run of the same extent in the row
+    // above so that stacked runs share one padded ROI (tile units)
+    regions_.clear();
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        for (int tx = 0; tx < tiles_x;) {
+            if (!dirty_[ty * tiles_x + tx]) { ++tx; continue; }
+            int end = tx;
+            while (end < tiles_x && dirty_[ty * tiles_x + end]) ++end;
+            auto above = std::find_if(regions_.begin(), regions_.end(), [&](const cv::Rect& r) {
+                return r.x == tx && r.width == end - tx && r.y + r.height == ty;
+            });
+            if (above != regions_.end()) {
+                above->height++;
+            } else {
+                regions_.emplace_back(tx, ty, end - tx, 1);
+            }
+            tx = end;
+        }
+    }
+
+    // Recompute each region on a padded ROI; the padding holds the whole
+    // kernel support, so the region itself comes out as a full recompute
+    const cv::Rect frame_rect(0, 0, frame_bgr.cols, frame_bgr.rows);
+    const cv::Rect small_rect(0, 0, cur_luma_.cols, cur_luma_.rows);
+    const int reused = tile_count - dirty_count;
+    for (const cv::Rect& region : regions_) {
+        cv::Rect rect = cv::Rect(region.x * ts, region.y * ts, region.width * ts, region.height * ts) & frame_rect;
+        cv::Rect padded = cv::Rect(rect.x - margin, rect.y - margin,
+                                   rect.width + 2 * margin, rect.height + 2 * margin) & frame_rect;
+        SEGMECAM_TRACE_SCOPE("blur_cache.recompute");
+        // Variable-sized ROIs: plain allocations, not pool slabs
+        cv::Mat blurred = BlurredBackgroundPlateBGR(frame_bgr(padded), mask_u8(padded),
+                                                    blur_strength, engine, nullptr);
+        blurred(rect - padded.tl()).copyTo(plate_(rect));
+
+        cv::Rect probe = cv::Rect(region.x * sts, region.y * sts, region.width * sts, region.height * sts) & small_rect;
+        cur_luma_(probe).copyTo(ref_luma_(probe));
+        cur_mask_(probe).copyTo(ref_mask_(probe));
+    }
+    stats_.tiles_reused += (uint64_t)reused;
+    return plate_;
+}
+
+} // namespace segmecam
@@ -0,0 +1,286 @@
+#include "include/effects/background_video_source.h"
+#include "include/pipeline/trace.h"
+
+#include <algorithm>
+#include <iostream>
+#include <opencv2/imgproc.hpp>
+
+namespace segmecam {
+
+namespace {
+
+uint64_t PackSize(const cv::Size& size) {
+    return ((uint64_t)(uint32_t)size.width << 32) | (uint32_t)size.height;
+}
+
+cv::Size UnpackSize(uint64_t packed) {
+    return cv::Size((int)(packed >> 32), (int)(packed & 0xffffffffu));
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+std::chrono::steady_clock::duration FromMs(double ms) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(ms));
+}
+
+// Decoded frame -> new BGR plate of size (never aliases the capture buffer)
+cv::Mat ToPlate(const cv::Mat& raw, const cv::Size& size) {
+    cv::Mat bgr = raw;
+    if (raw.channels() == 1) {
+        cv::cvtColor(raw, bgr, cv::COLOR_GRAY2BGR);
+    } else if (raw.channels() == 4) {
+        cv::cvtColor(raw, bgr, cv::COLOR_BGRA2BGR);
+    }
+    cv::Mat plate;
+    if (bgr.size() == size) {
+        plate = (bgr.data == raw.data) ? raw.clone() : bgr;
+    } else {
+        bool shrink = bgr.cols > size.width || bgr.rows > size.height;
+        cv::resize(bgr, plate, size, 0, 0, shrink ? cv::INTER_AREA : cv::INTER_LINEAR);
+    }
+    return plate;
+}
+
+void Rewind(cv::VideoCapture& cap, const std::string& path) {
+    // Reopen where the backend cannot seek
+    if (!cap.set(cv::CAP_PROP_POS_FRAMES, 0)) cap.open(path);
+}
+
+} // namespace
+
+BackgroundVideoSource::~BackgroundVideoSource() {
+    Close();
+}
+
+void BackgroundVideoSource::Open(const std::string& path, bool preload) {
+    Close();
+    path_ = path;
+    preload_ = preload;
+    decode_thread_ = std::thread(&BackgroundVideoSource::DecodeThreadLoop, this, path, preload);
+}
+
+void BackgroundVideoSource::Close() {
+    if (decode_thread_.joinable()) {
+        stop_ = true;
+        decode_thread_.join();
+        std::cout << "🎞️  Background video closed: " << path_ << std::endl;
+    }
+    stop_ = false;
+    failed_ = false;
+    Plate discarded;
+    while (ring_.TryPop(discarded)) {}
+    {
+        std::lock_guard<std::mutex> lock(loop_mutex_);
+        published_loop_.reset();
+    }
+    loop_version_ = 0;
+    loop_version_seen_ = 0;
+    loop_.reset();
+    pending_ = Plate{};
+    current_.release();
+    playing_ = false;
+    frames_decoded_ = 0;
+    frames_shown_ = 0;
+    underruns_ = 0;
+    path_.clear();
+}
+
+cv::Size BackgroundVideoSource::LoopSize() const {
+    return UnpackSize(loop_size_.load(std::memory_order_relaxed));
+}
+
+cv::Size BackgroundVideoSource::StreamSize() const {
+    return UnpackSize(stream_size_.load(std::memory_order_relaxed));
+}
+
+cv::Mat BackgroundVideoSource::Frame(const cv::Size& output_size, const cv::Size& working_size) {
+    SEGMECAM_TRACE_SCOPE("bg_video.frame");
+    loop_size_.store(PackSize(output_size), std::memory_order_relaxed);
+    stream_size_.store(PackSize(working_size), std::memory_order_relaxed);
+    const auto now = std::chrono::steady_clock::now();
+
+    uint64_t version = loop_version_.load(std::memory_order_acquire);
+    if (version != loop_version_seen_) {
+        std::lock_guard<std::mutex> lock(loop_mutex_);
+        loop_ = published_loop_;
+        loop_version_seen_ = version;
+    }
+
+    // Preloaded: pick the frame by the clock, nothing to dequeue
+    if (loop_) {
+        if (!playing_) {
+            play_start_ = now;
+            playing_ = true;
+        }
+        size_t index = (size_t)(ElapsedMs(play_start_, now) / loop_->frame_ms) % loop_->frames.size();
+        if (current_.data != loop_->frames[index].data) frames_shown_++;
+        current_ = loop_->frames[index];
+        return current_;
+    }
+
+    // Streamed: the newest plate that is due; several due plates means the
+    // compositor runs slower than the video, so the older ones are skipped
+    for (;;) {
+        if (pending_.bgr.empty() && !ring_.TryPop(pending_)) {
+            if (playing_ && ElapsedMs(play_start_, now) > current_pts_ms_ + 2.0 * current_frame_ms_) {
+                underruns_++;
+            }
+            break;
+        }
+        if (!playing_) {
+            play_start_ = now - FromMs(pending_.pts_ms);
+            playing_ = true;
+        }
+        double t = ElapsedMs(play_start_, now);
+        if (pending_.pts_ms > t) break;
+        if (t - pending_.pts_ms > kMaxLagMs) {
+            play_start_ = now - FromMs(pending_.pts_ms);
+        }
+        current_ = std::move(pending_.bgr);
+        current_pts_ms_ = pending_.pts_ms;
+        current_frame_ms_ = pending_.frame_ms;
+        pending_ = Plate{};
+        frames_shown_++;
+    }
+    return current_;
+}
+
+BackgroundVideoStats BackgroundVideoSource::GetStats() const {
+    BackgroundVideoStats stats;
+    stats.frames_decoded = frames_decoded_.load(std::memory_order_relaxed);
+    stats.frames_shown = frames_shown_;
+    stats.underruns = underruns_;
+    stats.in_memory = loop_ != nullptr;
+    return stats;
+}
+
+void BackgroundVideoSource::DecodeThreadLoop(std::string path, bool preload) {
+    Tracer::Instance().SetThreadName("bg_video");
+    cv::VideoCapture cap;
+    {
+        SEGMECAM_TRACE_SCOPE("bg_video.open");
+        cap.open(path);
+    }
+    if (!cap.isOpened()) {
+        std::cerr << "❌ Failed to open background video: " << path << std::endl;
+        failed_ = true;
+        return;
+    }
+    double fps = cap.get(cv::CAP_PROP_FPS);
+    if (!(fps >= 1.0 && fps <= 240.0)) fps = 30.0;  // Containers without a frame rate
+    const double frame_ms = 1000.0 / fps;
+    std::cout << "🎞️  Background video: " << path << " (" << fps << " fps"
+              << (preload ? ", preloading" : "") << ")" << std::endl;
+
+    cv::Size loop_size;     // Size of the published loop, if any
+    uint64_t seq = 0;       // Plates queued so far
+    cv::Mat raw;
+    while (!stop_) {
+        if (LoopSize().area() == 0) {
+            // Nothing asked for a plate yet
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        if (preload) {
+            // Held at the output size: only a new output size reloads it
+            const cv::Size size = LoopSize();
+            if (size == loop_size) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                continue;
+            }
+            if (DecodeIntoMemory(cap, path, size, frame_ms)) {
+                loop_size = size;
+                continue;
+            }
+            if (stop_) break;
+            if (LoopSize() != size) continue;  // Resized while loading: start over
+            preload = false;                      // Too long to hold: stream it instead
+            if (loop_size.area() > 0) {
+                // Withdraw the loop of the previous size, or Frame() would keep
+                // resizing it instead of taking the streamed plates
+                {
+                    std::lock_guard<std::mutex> lock(loop_mutex_);
+                    published_loop_.reset();
+                }
+                loop_version_.fetch_add(1, std::memory_order_release);
+                loop_size = cv::Size();
+            }
+            Rewind(cap, path);
+        }
+
+        // Streaming: stay at most kRingFrames ahead of playback
+        if (ring_.SizeApprox() >= ring_.Capacity()) {
+            std::this_thread::sleep_for(FromMs(std::max(1.0, frame_ms / 2)));
+            continue;
+        }
+        bool ok;
+        {
+            SEGMECAM_TRACE_SCOPE("bg_video.decode");
+            ok = cap.read(raw) && !raw.empty();
+            if (!ok) {
+                Rewind(cap, path);
+                ok = cap.read(raw) && !raw.empty();
+            }
+        }
+        if (!ok) {
+            std::cerr << "❌ Background video stopped decoding: " << path << std::endl;
+            failed_ = true;
+            return;
+        }
+        Plate plate;
+        plate.bgr = ToPlate(raw, StreamSize());
+        plate.pts_ms = (double)seq++ * frame_ms;
+        plate.frame_ms = frame_ms;
+        ring_.TryPush(std::move(plate));
+        frames_decoded_++;
+    }
+}
+
+bool BackgroundVideoSource::DecodeIntoMemory(cv::VideoCapture& cap, const std::string& path,
+                                             const cv::Size& size, double frame_ms) {
+    SEGMECAM_TRACE_SCOPE("bg_video.preload");
+    Rewind(cap, path);
+    auto loop = std::make_shared<Loop>();
+    loop->size = size;
+    loop->frame_ms = frame_ms;
+    const size_t plate_bytes = (size_t)size.area() * 3;
+    const bool first_loop = loop_version_.load() == 0;
+    cv::Mat raw;
+
+    // Unpaced: the clip is played from memory once complete
+    while (!stop_ && LoopSize() == size) {
+        if (!cap.read(raw) || raw.empty()) break;  // End of the clip
+        if ((loop->frames.size() + 1) * plate_bytes > kPreloadBudgetBytes) {
+            std::cout << "🎞️  Background video exceeds the " << (kPreloadBudgetBytes >> 20)
+                      << " MB preload budget at " << size.width << "x" << size.height
+                      << ", streaming instead" << std::endl;
+            return false;
+        }
+        loop->frames.push_back(ToPlate(raw, size));
+        frames_decoded_++;
+        if (first_loop && loop->frames.size() == 1) {
+            // Something to show while the rest loads
+            Plate poster;
+            poster.bgr = loop->frames[0];
+            poster.frame_ms = frame_ms;
+            ring_.TryPush(std::move(poster));
+        }
+    }
+    if (stop_ || LoopSize() != size || loop->frames.empty()) return false;
+
+    std::cout << "🎞️  Background loop in memory: " << loop->frames.size() << " frames at "
+              << size.width << "x" << size.height << " ("
+              << (loop->frames.size() * plate_bytes >> 20) << " MB)" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(loop_mutex_);
+        published_loop_ = std::move(loop);
+    }
+    loop_version_.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+} // namespace segmecam
@@ -1,5 +1,6 @@
 #include "include/effects/effects_manager.h"
 #include "segmecam_composite.h"
+#include "include/pipeline/trace.h"
 #include "mediapipe/tasks/cc/vision/face_landmarker/face_landmarks_connections.h"
 
 #include <iostream>
@@ -82,8 +83,10 @@ cv::Mat EffectsManager::ProcessFrame(const cv::Mat& frame_bgr,
                                     const cv::Mat& segmentation_mask,
                                     const mediapipe::NormalizedLandmarkList* face_landmarks) {
     if (!state_.is_initialized) {
-        // Return BGR frame as-is when not initialized (ApplicationRun will convert to RGB for display)
-        return frame_bgr.clone();
+        // Pass the frame through unprocessed, in the same RGB format callers expect
+        cv::Mat rgb;
+        cv::cvtColor(frame_bgr, rgb, cv::COLOR_BGR2RGB);
+        return rgb;
     }
     
     static int debug_frame_count = 0;
@@ -96,15 +99,26 @@ cv::Mat EffectsManager::ProcessFrame(const cv::Mat& frame_bgr,
                   << " center pixel: [" << (int)input_pixel[0] << "," << (int)input_pixel[1] << "," << (int)input_pixel[2] << "]" << std::endl;
     }
     
+    SEGMECAM_TRACE_SCOPE("effects.process_frame");
+    
+    // Pick up settings published since the last frame (no-op when unchanged)
+    ApplyPendingSettings();
+    
     auto start_time = std::chrono::steady_clock::now();    // Track frame info
     state_.last_frame_width = frame_bgr.cols;
     state_.last_frame_height = frame_bgr.rows;
+    frame_pool_.BeginFrame();
+    uint64_t pool_allocs_before = frame_pool_.AllocationCount();
     
-    // Work on a copy to avoid modifying the original
-    cv::Mat processed_frame = frame_bgr.clone();
+    // Face effects modify the frame in place, so only they need a (pooled) copy;
+    // background composites read the input and write into new buffers
+    bool apply_face_effects = config_.enable_face_effects && face_landmarks && face_landmarks->landmark_size() > 0;
+    cv::Mat processed_frame = frame_bgr;
     
     // Apply face effects if landmarks are available
-    if (config_.enable_face_effects && face_landmarks && face_landmarks->landmark_size() > 0) {
+    if (apply_face_effects) {
+        processed_frame = frame_pool_.Acquire(frame_bgr.size(), frame_bgr.type());
+        frame_bgr.copyTo(processed_frame);
         auto smooth_start = std::chrono::steady_clock::now();
         ApplyFaceEffects(processed_frame, *face_landmarks);
         auto smooth_end = std::chrono::steady_clock::now();
@@ -123,10 +137,13 @@ cv::Mat EffectsManager::ProcessFrame(const cv::Mat& frame_bgr,
         state_.last_background_time_ms = std::chrono::duration<double, std::milli>(bg_end - bg_start).count();
         perf_sum_bg_ms_ += state_.last_background_time_ms;
     } else {
-        // No background effects, return BGR frame as-is (ApplicationRun will convert to RGB for display)
-        result = processed_frame.clone();
+        // No background effects - still return RGB like every other path
+        SEGMECAM_TRACE_SCOPE("effects.bgr_to_rgb");
+        result = frame_pool_.Acquire(processed_frame.size(), CV_8UC3);
+        cv::cvtColor(processed_frame, result, cv::COLOR_BGR2RGB);
         state_.last_background_time_ms = 0.0;
     }
+    state_.last_frame_pool_allocations = frame_pool_.AllocationCount() - pool_allocs_before;
     
     // Update performance tracking
     auto end_time = std::chrono::steady_clock::now();
@@ -151,20 +168,27 @@ cv::Mat EffectsManager::ProcessFrame(const cv::Mat& frame_bgr,
     return result;
 }
 
-cv::Mat EffectsManager::ApplyBackgroundEffect(const cv::Mat& frame_bgr, const cv::Mat& mask) {
-    cv::Mat resized_mask = ResizeMaskIfNeeded(mask, frame_bgr.size());
+cv::Mat EffectsManager::ApplyBackgroundEffect(const cv::Mat& frame_bgr, const cv::Mat& model_mask) {
+    // Guided upsampling produces the frame-sized alpha directly, for every mode
+    cv::Mat mask = model_mask;
+    if (beauty_state_.mask_upsampler == 1 && !mask.empty() && mask.size() != frame_bgr.size()) {
+        mask = GuidedUpsampleMask(model_mask, frame_bgr, &frame_pool_);
+    }
     
     // Check if user wants to show mask visualization (overrides all other background effects)
-    if (state_.show_mask && !resized_mask.empty()) {
-        return VisualizeMask(resized_mask);
+    if (state_.show_mask && !mask.empty()) {
+        return VisualizeMask(ResizeMaskIfNeeded(mask, frame_bgr.size()));
     }
     
+    // Image and solid composites take the model-resolution mask and upsample
+    // it per strip; the blur needs it at frame size for the background plate
     switch (beauty_state_.bg_mode) {
         case 1: // Blur
-            return ApplyBlurBackground(frame_bgr, resized_mask, beauty_state_.blur_strength, beauty_state_.feather_px);
+            return ApplyBlurBackground(frame_bgr, ResizeMaskIfNeeded(mask, frame_bgr.size()),
+                                       beauty_state_.blur_strength, beauty_state_.feather_px);
         case 2: // Image
             if (!background_image_.empty()) {
-                return ApplyImageBackground(frame_bgr, resized_mask, background_image_);
+                return ApplyImageBackground(frame_bgr, mask, background_image_);
             }
             break;
         case 3: // Solid Color
@@ -174,14 +198,28 @@ cv::Mat EffectsManager::ApplyBackgroundEffect(const cv::Mat& frame_bgr, const cv
                     beauty_state_.solid_color[1], 
                     beauty_state_.solid_color[2]
                 );
-                return ApplySolidBackground(frame_bgr, resized_mask, solid_color);
+                return ApplySolidBackground(frame_bgr, mask, solid_color);
+            }
+        case 4: // Video
+            {
+                // A preloaded loop stays at frame size so scale changes never
+                // reload it; streamed plates come at the working size. Never
+                // waits for the decoder
+                cv::Mat plate = bg_video_.Frame(frame_bgr.size(),
+                                                AccelWorkingSize(frame_bgr.size(), beauty_state_.fx_adv_scale));
+                if (!plate.empty()) {
+                    return CompositeImageBackgroundBGR_Accel(frame_bgr, mask, plate,
+                                                           state_.opencl_enabled, beauty_state_.fx_adv_scale, &frame_pool_);
+                }
             }
+            break;
         default: // None
             break;
     }
     
     // No background effect or fallback - convert BGR to RGB for display
-    cv::Mat rgb;
+    SEGMECAM_TRACE_SCOPE("bg.none");
+    cv::Mat rgb = frame_pool_.Acquire(frame_bgr.size(), CV_8UC3);
     cv::cvtColor(frame_bgr, rgb, cv::COLOR_BGR2RGB);
     
     // Debug output for no-background path
@@ -200,65 +238,125 @@ cv::Mat EffectsManager::ApplyBackgroundEffect(const cv::Mat& frame_bgr, const cv
 
 cv::Mat EffectsManager::ApplyBlurBackground(const cv::Mat& frame_bgr, const cv::Mat& mask, 
                                            int blur_strength, float feather_px) {
+    // Cached plate: only tiles whose content changed are blurred again; the
+    // frame is then blended over the plate at full resolution. The Gaussian
+    // engine keeps the accelerated path when that works at a reduced
+    // processing scale or on OpenCL, which the cache does not.
+    bool gaussian_accel = beauty_state_.blur_backend == 0 &&
+                          (beauty_state_.fx_adv_scale < 0.999f || state_.opencl_enabled);
+    if (config_.enable_background_blur_cache && beauty_state_.blur_backend != 2 && !gaussian_accel) {
+        cv::Mat feathered = FeatherMaskU8(mask, feather_px, &frame_pool_);
+        const cv::Mat& plate = blur_cache_.Update(frame_bgr, feathered, blur_strength,
+                                                  beauty_state_.blur_backend, &frame_pool_);
+        return CompositeImageBackgroundBGR(frame_bgr, feathered, plate, &frame_pool_);
+    }
+    
+    // Box and pyramid engines ignore the processing scale: their cost no
+    // longer grows with the kernel, and the pyramid already works coarse
+    switch (beauty_state_.blur_backend) {
+        case 1:
+            return CompositeBlurBackgroundBGR_Box(frame_bgr, mask, blur_strength, feather_px, &frame_pool_);
+        case 2:
+            return CompositeBlurBackgroundBGR_Pyramid(frame_bgr, mask, blur_strength, feather_px, &frame_pool_);
+        default:
+            break;
+    }
     return CompositeBlurBackgroundBGR_Accel(frame_bgr, mask, blur_strength, feather_px, 
-                                           state_.opencl_enabled, beauty_state_.fx_adv_scale);
+                                           state_.opencl_enabled, beauty_state_.fx_adv_scale, &frame_pool_);
 }
 
 cv::Mat EffectsManager::ApplyImageBackground(const cv::Mat& frame_bgr, const cv::Mat& mask, const cv::Mat& bg_image) {
-    return CompositeImageBackgroundBGR_Accel(frame_bgr, mask, bg_image, 
-                                           state_.opencl_enabled, beauty_state_.fx_adv_scale);
+    // Plate at the size the composite works at, resized once per image and resolution
+    const cv::Mat& plate = bg_asset_cache_.Get(bg_image, background_content_id_,
+                                               AccelWorkingSize(frame_bgr.size(), beauty_state_.fx_adv_scale));
+    return CompositeImageBackgroundBGR_Accel(frame_bgr, mask, plate, 
+                                           state_.opencl_enabled, beauty_state_.fx_adv_scale, &frame_pool_);
 }
 
 cv::Mat EffectsManager::ApplySolidBackground(const cv::Mat& frame_bgr, const cv::Mat& mask, const cv::Scalar& color) {
     return CompositeSolidBackgroundBGR_Accel(frame_bgr, mask, color, 
-                                           state_.opencl_enabled, beauty_state_.fx_adv_scale);
+                                           state_.opencl_enabled, beauty_state_.fx_adv_scale, &frame_pool_);
 }
 
 void EffectsManager::ApplyFaceEffects(cv::Mat& frame_bgr, const mediapipe::NormalizedLandmarkList& landmarks) {
     // Extract face regions from landmarks
-    FaceRegions regions = ExtractFaceRegionsFromLandmarks(landmarks, frame_bgr.size());
+    FaceRegions regions;
+    {
+        SEGMECAM_TRACE_SCOPE("face.regions");
+        regions = ExtractFaceRegionsFromLandmarks(landmarks, frame_bgr.size());
+    }
     
     // Draw landmarks overlay if enabled
     if (state_.show_landmarks) {
+        SEGMECAM_TRACE_SCOPE("face.draw_landmarks");
         DrawLandmarks(frame_bgr, landmarks);
     }
     
+    // Lab planes, gray, gradients and region masks are shared by the effects
+    // below and built once; their Lab edits are converted back in Commit()
+    FaceEffectsContext face_ctx(frame_bgr, regions, FaceEffectsPad());
+    
     // Apply skin smoothing
     if (beauty_state_.fx_skin) {
         if (beauty_state_.fx_skin_adv) {
-            ApplySkinSmoothingAdvanced(frame_bgr, regions, landmarks);
+            SEGMECAM_TRACE_SCOPE("face.skin_smoothing_adv");
+            ApplySkinSmoothingAdvanced(face_ctx, landmarks);
         } else {
-            ApplySkinSmoothing(frame_bgr, regions);
+            SEGMECAM_TRACE_SCOPE("face.skin_smoothing");
+            ApplySkinSmoothing(face_ctx);
         }
     }
     
     // Apply lip effects
     if (beauty_state_.fx_lipstick) {
-        ApplyLipEffects(frame_bgr, regions, landmarks, frame_bgr.size());
+        SEGMECAM_TRACE_SCOPE("face.lips");
+        ApplyLipEffects(face_ctx, landmarks);
     }
     
     // Apply teeth whitening
     if (beauty_state_.fx_teeth) {
-        ApplyTeethWhitening(frame_bgr, regions);
+        SEGMECAM_TRACE_SCOPE("face.teeth");
+        ApplyTeethWhitening(face_ctx);
+    }
+    
+    {
+        SEGMECAM_TRACE_SCOPE("face.commit");
+        face_ctx.Commit();
+    }
+}
+
+int EffectsManager::FaceEffectsPad() const {
+    int pad = TeethWhitenPad();
+    if (beauty_state_.fx_skin) {
+        pad = std::max(pad, beauty_state_.fx_skin_adv
+            ? SkinSmoothingAdvPad(beauty_state_.fx_skin_radius, beauty_state_.fx_skin_edge,
+                                  beauty_state_.fx_wrinkle_custom_scales ? beauty_state_.fx_wrinkle_min_px : -1.0f,
+                                  beauty_state_.fx_wrinkle_custom_scales ? beauty_state_.fx_wrinkle_max_px : -1.0f)
+            : SkinSmoothingPad());
+    }
+    if (beauty_state_.fx_lipstick) {
+        pad = std::max(pad, LipRefinerPad(beauty_state_.fx_lip_feather, beauty_state_.fx_lip_band));
     }
+    return pad;
 }
 
-void EffectsManager::ApplySkinSmoothing(cv::Mat& frame_bgr, const FaceRegions& regions) {
-    ApplySkinSmoothingBGR(frame_bgr, regions, beauty_state_.fx_skin_amount, state_.opencl_enabled);
+void EffectsManager::ApplySkinSmoothing(FaceEffectsContext& ctx) {
+    ApplySkinSmoothingBGR(ctx, beauty_state_.fx_skin_amount, state_.opencl_enabled);
 }
 
-void EffectsManager::ApplySkinSmoothingAdvanced(cv::Mat& frame_bgr, const FaceRegions& regions, 
-                                               const mediapipe::NormalizedLandmarkList& landmarks) {
+void EffectsManager::ApplySkinSmoothingAdvanced(FaceEffectsContext& ctx, const mediapipe::NormalizedLandmarkList& landmarks) {
     // Use user-configured processing scale directly for stability
     float effective_scale = beauty_state_.fx_adv_scale;
     
     // Check if processing scale optimization should be used
     if (effective_scale < 0.999f) {
-        ApplySkinSmoothingWithProcessingScale(frame_bgr, regions, landmarks);
+        // Works on its own downscaled copy and writes BGR back
+        ApplySkinSmoothingWithProcessingScale(ctx.MutableFrame(), ctx.Regions(), landmarks);
     } else {
         // Full resolution processing
+        face_geometry_cache_.Apply(ctx, landmarks, beauty_state_.fx_skin_edge);
         ApplySkinSmoothingAdvBGR(
-            frame_bgr, regions,
+            ctx,
             beauty_state_.fx_skin_amount,
             beauty_state_.fx_skin_radius,
             beauty_state_.fx_skin_tex,
@@ -285,8 +383,7 @@ void EffectsManager::ApplySkinSmoothingAdvanced(cv::Mat& frame_bgr, const FaceRe
     }
 }
 
-void EffectsManager::ApplyLipEffects(cv::Mat& frame_bgr, const FaceRegions& regions, 
-                                    const mediapipe::NormalizedLandmarkList& landmarks, const cv::Size& frame_size) {
+void EffectsManager::ApplyLipEffects(FaceEffectsContext& ctx, const mediapipe::NormalizedLandmarkList& landmarks) {
     cv::Scalar lip_color_bgr(
         beauty_state_.fx_lip_color[2] * 255, // B
         beauty_state_.fx_lip_color[1] * 255, // G  
@@ -294,17 +391,102 @@ void EffectsManager::ApplyLipEffects(cv::Mat& frame_bgr, const FaceRegions& regi
     );
     
     ApplyLipRefinerBGR(
-        frame_bgr, regions, lip_color_bgr,
+        ctx, lip_color_bgr,
         beauty_state_.fx_lip_alpha,
         beauty_state_.fx_lip_feather,
         beauty_state_.fx_lip_light,
         beauty_state_.fx_lip_band,
-        landmarks, frame_size
+        landmarks
     );
 }
 
-void EffectsManager::ApplyTeethWhitening(cv::Mat& frame_bgr, const FaceRegions& regions) {
-    ApplyTeethWhitenBGR(frame_bgr, regions, beauty_state_.fx_teeth_strength, beauty_state_.fx_teeth_margin);
+void EffectsManager::ApplyTeethWhitening(FaceEffectsContext& ctx) {
+    ApplyTeethWhitenBGR(ctx, beauty_state_.fx_teeth_strength, beauty_state_.fx_teeth_margin);
+}
+
+void EffectsManager::PublishSettings(std::shared_ptr<const EffectsSettings> settings) {
+    settings_mailbox_.Publish(std::move(settings));
+}
+
+void EffectsManager::ApplyPendingSettings() {
+    if (settings_mailbox_.Version() == applied_settings_version_) return;
+    std::shared_ptr<const EffectsSettings> settings = settings_mailbox_.Load();
+    if (!settings) return;
+    ApplySettings(*settings);
+}
+
+void EffectsManager::ApplySettings(const EffectsSettings& settings) {
+    SEGMECAM_TRACE_SCOPE("effects.apply_settings");
+    // Go through the setters so values are clamped exactly as before
+    const BeautyState& b = settings.beauty;
+    // Mode and video path first, then the decoder is opened or closed once
+    // for both (the setters would each do it)
+    beauty_state_.bg_mode = std::clamp(b.bg_mode, 0, 4);
+    background_video_path_ = settings.background_video_path;
+    background_video_preload_ = settings.background_video_preload;
+    UpdateBackgroundVideo();
+    SetBlurStrength(b.blur_strength);
+    SetBlurBackend(b.blur_backend);
+    SetMaskUpsampler(b.mask_upsampler);
+    SetFeatherAmount(b.feather_px);
+    SetSolidBackgroundColor(b.solid_color[0], b.solid_color[1], b.solid_color[2]);
+    SetShowMask(b.show_mask);
+    SetShowLandmarks(settings.show_landmarks);
+    
+    SetSkinSmoothingEnabled(b.fx_skin);
+    SetSkinSmoothingAdvanced(b.fx_skin_adv);
+    SetSkinSmoothingAmount(b.fx_skin_amount);
+    SetSkinSmoothingRadius(b.fx_skin_radius);
+    SetSkinTexturePreservation(b.fx_skin_tex);
+    SetSkinEdgeFeather(b.fx_skin_edge);
+    
+    SetWrinkleAwareEnabled(b.fx_skin_wrinkle);
+    SetWrinkleGain(b.fx_skin_wrinkle_gain);
+    SetSmileBoost(b.fx_skin_smile_boost);
+    SetSquintBoost(b.fx_skin_squint_boost);
+    SetForeheadBoost(b.fx_skin_forehead_boost);
+    SetSuppressLowerFace(b.fx_wrinkle_suppress_lower);
+    SetLowerFaceRatio(b.fx_wrinkle_lower_ratio);
+    SetIgnoreGlasses(b.fx_wrinkle_ignore_glasses);
+    SetGlassesMargin(b.fx_wrinkle_glasses_margin);
+    SetWrinkleSensitivity(b.fx_wrinkle_keep_ratio);
+    SetCustomWrinkleScales(b.fx_wrinkle_custom_scales);
+    SetWrinkleMinWidth(b.fx_wrinkle_min_px);
+    SetWrinkleMaxWidth(b.fx_wrinkle_max_px);
+    SetWrinkleSkinGate(b.fx_wrinkle_use_skin_gate);
+    SetWrinkleMaskGain(b.fx_wrinkle_mask_gain);
+    SetWrinkleBaselineBoost(b.fx_wrinkle_baseline);
+    SetWrinkleNegativeCap(b.fx_wrinkle_neg_cap);
+    SetWrinklePreview(b.fx_wrinkle_preview);
+    
+    SetProcessingScale(b.fx_adv_scale);
+    SetDetailPreservation(b.fx_adv_detail_preserve);
+    SetAutoProcessingScaleEnabled(b.auto_processing_scale);
+    SetTargetFPS(b.target_fps);
+    
+    SetLipstickEnabled(b.fx_lipstick);
+    SetLipAlpha(b.fx_lip_alpha);
+    SetLipFeather(b.fx_lip_feather);
+    SetLipLightness(b.fx_lip_light);
+    SetLipBandGrow(b.fx_lip_band);
+    SetLipColor(b.fx_lip_color[0], b.fx_lip_color[1], b.fx_lip_color[2]);
+    
+    SetTeethWhiteningEnabled(b.fx_teeth);
+    SetTeethWhiteningStrength(b.fx_teeth_strength);
+    SetTeethMargin(b.fx_teeth_margin);
+    
+    // Derived state: only when the image itself changed. The buffer is shared
+    // (read-only) with the snapshot instead of cloned. An empty snapshot image
+    // keeps whatever was loaded directly (e.g. from a profile path).
+    if (settings.background_generation != applied_background_generation_) {
+        if (settings.background_image && !settings.background_image->empty()) {
+            background_image_ = *settings.background_image;
+            background_content_id_++;
+        }
+        applied_background_generation_ = settings.background_generation;
+    }
+    
+    applied_settings_version_ = settings.version;
 }
 
 void EffectsManager::ApplyBeautyPreset(int preset_index) {
@@ -327,7 +509,8 @@ void EffectsManager::SetBeautyState(const BeautyState& state) {
 
 // Background settings
 void EffectsManager::SetBackgroundMode(int mode) {
-    beauty_state_.bg_mode = std::clamp(mode, 0, 3);
+    beauty_state_.bg_mode = std::clamp(mode, 0, 4);
+    UpdateBackgroundVideo();
 }
 
 void EffectsManager::SetBlurStrength(int strength) {
@@ -335,6 +518,19 @@ void EffectsManager::SetBlurStrength(int strength) {
     if ((beauty_state_.blur_strength % 2) == 0) beauty_state_.blur_strength++; // Ensure odd
 }
 
+void EffectsManager::SetBlurBackend(int backend) {
+    beauty_state_.blur_backend = std::clamp(backend, 0, 2);
+}
+
+void EffectsManager::SetMaskUpsampler(int upsampler) {
+    beauty_state_.mask_upsampler = std::clamp(upsampler, 0, 1);
+}
+
+void EffectsManager::SetBackgroundBlurCacheEnabled(bool enabled) {
+    config_.enable_background_blur_cache = enabled;
+    if (!enabled) blur_cache_.Reset();
+}
+
 void EffectsManager::SetFeatherAmount(float feather_px) {
     beauty_state_.feather_px = std::max(0.0f, feather_px);
 }
@@ -342,6 +538,7 @@ void EffectsManager::SetFeatherAmount(float feather_px) {
 void EffectsManager::SetBackgroundImage(const cv::Mat& image) {
     if (!image.empty()) {
         background_image_ = image.clone();
+        background_content_id_++;
     }
 }
 
@@ -349,6 +546,29 @@ void EffectsManager::SetBackgroundImageFromPath(const std::string& path) {
     LoadBackgroundImage(path);
 }
 
+void EffectsManager::SetBackgroundVideo(const std::string& path, bool preload) {
+    background_video_path_ = path;
+    background_video_preload_ = preload;
+    UpdateBackgroundVideo();
+}
+
+// The decode thread only runs while the video is on screen
+void EffectsManager::UpdateBackgroundVideo() {
+    bool wanted = beauty_state_.bg_mode == 4 && !background_video_path_.empty();
+    if (bg_video_.Failed()) {
+        // Join the finished decode thread; a wanted path is retried below
+        bg_video_.Close();
+    }
+    if (!wanted) {
+        if (bg_video_.IsOpen()) bg_video_.Close();
+        return;
+    }
+    if (!bg_video_.IsOpen() || bg_video_.Path() != background_video_path_ ||
+        bg_video_.Preload() != background_video_preload_) {
+        bg_video_.Open(background_video_path_, background_video_preload_);
+    }
+}
+
 void EffectsManager::SetSolidBackgroundColor(float r, float g, float b) {
     beauty_state_.solid_color[0] = std::clamp(r, 0.0f, 1.0f);
     beauty_state_.solid_color[1] = std::clamp(g, 0.0f, 1.0f);
@@ -525,7 +745,7 @@ void EffectsManager::SetShowLandmarks(bool enabled) {
 }
 
 cv::Mat EffectsManager::VisualizeMask(const cv::Mat& mask) {
-    return VisualizeMaskRGB(mask);
+    return VisualizeMaskRGB(mask, &frame_pool_);
 }
 
 // Performance monitoring
@@ -551,6 +771,7 @@ bool EffectsManager::LoadBackgroundImage(const std::string& path) {
     cv::Mat img = cv::imread(path, cv::IMREAD_COLOR);
     if (!img.empty()) {
         background_image_ = img;
+        background_content_id_++;
         std::cout << "🖼️  Loaded background image: " << path << " (" << img.cols << "x" << img.rows << ")" << std::endl;
         return true;
     }
@@ -560,6 +781,7 @@ bool EffectsManager::LoadBackgroundImage(const std::string& path) {
 
 void EffectsManager::ClearBackgroundImage() {
     background_image_.release();
+    bg_asset_cache_.Clear();
     std::cout << "🗑️  Background image cleared" << std::endl;
 }
 
@@ -570,6 +792,13 @@ void EffectsManager::Cleanup() {
     
     // Clear background image
     background_image_.release();
+    bg_asset_cache_.Clear();
+    bg_video_.Close();
+    blur_cache_.Reset();
+    face_geometry_cache_.Reset();
+    
+    // Give back pooled buffers nobody holds anymore
+    frame_pool_.Trim();
     
     // Reset state
     state_ = EffectsState{};
@@ -589,13 +818,7 @@ FaceRegions EffectsManager::ExtractFaceRegionsFromLandmarks(const mediapipe::Nor
 cv::Mat EffectsManager::ResizeMaskIfNeeded(const cv::Mat& mask, const cv::Size& target_size) {
     if (mask.empty()) return mask;
     
-    if (mask.cols != target_size.width || mask.rows != target_size.height) {
-        cv::Mat resized;
-        cv::resize(mask, resized, target_size, 0, 0, cv::INTER_LINEAR);
-        return resized;
-    }
-    
-    return mask;
+    return ResizeMaskToFrame(mask, target_size, &frame_pool_);
 }
 
 cv::Scalar EffectsManager::ConvertRGBColorToBGR(float r, float g, float b) {
@@ -679,6 +902,34 @@ void EffectsManager::LogPerformanceStats() {
     if (state_.opencl_enabled) {
         std::cout << "  OpenCL: enabled" << std::endl;
     }
+    FramePoolStats pool_stats = frame_pool_.GetStats();
+    std::cout << "  Frame pool: " << pool_stats.pooled_buffers << " buffers ("
+              << pool_stats.pooled_bytes / (1024 * 1024) << " MB), last frame allocations: "
+              << state_.last_frame_pool_allocations << " (0 = steady state), overflows: "
+              << pool_stats.overflows << std::endl;
+    if (config_.enable_background_blur_cache && blur_cache_.GetStats().frames > 0) {
+        const BackgroundBlurCacheStats& cache_stats = blur_cache_.GetStats();
+        std::cout << "  Blur cache: " << cache_stats.HitRate() * 100.0 << "% tiles reused, "
+                  << cache_stats.full_refreshes << " full refreshes" << std::endl;
+        blur_cache_.ResetStats();
+    }
+    if (face_geometry_cache_.GetStats().frames > 0) {
+        const FaceGeometryCacheStats& geo_stats = face_geometry_cache_.GetStats();
+        std::cout << "  Face geometry cache: " << geo_stats.HitRate() * 100.0 << "% reused/warped ("
+                  << geo_stats.reused << " reused, " << geo_stats.warped << " warped), "
+                  << geo_stats.rebuilt << " rebuilds" << std::endl;
+        face_geometry_cache_.ResetStats();
+    }
+    if (bg_video_.IsOpen()) {
+        BackgroundVideoStats video_stats = bg_video_.GetStats();
+        std::cout << "  Background video: " << video_stats.frames_shown << " shown, "
+                  << video_stats.frames_decoded << " decoded, " << video_stats.underruns << " late"
+                  << (video_stats.in_memory ? " (in memory)" : "") << std::endl;
+    }
+    if (bg_asset_cache_.GetStats().lookups > 0) {
+        std::cout << "  Background plates: " << bg_asset_cache_.GetStats().rebuilds << " rebuilt in "
+                  << bg_asset_cache_.GetStats().lookups << " lookups" << std::endl;
+    }
     
     // Reset for next interval
     ResetPerformanceStats();
@@ -770,9 +1021,16 @@ void EffectsManager::ApplySkinSmoothingWithProcessingScale(cv::Mat& frame_bgr, c
                         std::max(1, (int)std::round(roi.height * sc)));
     cv::resize(roi_bgr, small, target_size, 0, 0, cv::INTER_AREA); // Always use INTER_AREA for stable downsampling
     
-    // Apply skin smoothing on the downscaled image with scaled parameters
+    // Apply skin smoothing on the downscaled image with scaled parameters;
+    // lms_roi is normalized to the ROI and so to small as well
+    float small_min_px = beauty_state_.fx_wrinkle_custom_scales ? beauty_state_.fx_wrinkle_min_px * sc : -1.0f;
+    float small_max_px = beauty_state_.fx_wrinkle_custom_scales ? beauty_state_.fx_wrinkle_max_px * sc : -1.0f;
+    FaceEffectsContext small_ctx(small, fr_small,
+                                 SkinSmoothingAdvPad(beauty_state_.fx_skin_radius * sc, beauty_state_.fx_skin_edge * sc,
+                                                     small_min_px, small_max_px));
+    face_geometry_cache_.Apply(small_ctx, lms_roi, beauty_state_.fx_skin_edge * sc);
     ApplySkinSmoothingAdvBGR(
-        small, fr_small,
+        small_ctx,
         beauty_state_.fx_skin_amount,
         beauty_state_.fx_skin_radius * sc,  // Scale radius
         beauty_state_.fx_skin_tex,
@@ -787,8 +1045,8 @@ void EffectsManager::ApplySkinSmoothingWithProcessingScale(cv::Mat& frame_bgr, c
         beauty_state_.fx_wrinkle_ignore_glasses,
         beauty_state_.fx_wrinkle_glasses_margin * sc,  // Scale glasses margin
         beauty_state_.fx_wrinkle_keep_ratio,
-        beauty_state_.fx_wrinkle_custom_scales ? beauty_state_.fx_wrinkle_min_px * sc : -1.0f,  // Scale min width
-        beauty_state_.fx_wrinkle_custom_scales ? beauty_state_.fx_wrinkle_max_px * sc : -1.0f,  // Scale max width
+        small_min_px,  // Scaled min width
+        small_max_px,  // Scaled max width
         8.0f * sc,  // Scale forehead margin
         beauty_state_.fx_wrinkle_preview,
         beauty_state_.fx_wrinkle_baseline,
@@ -796,6 +1054,7 @@ void EffectsManager::ApplySkinSmoothingWithProcessingScale(cv::Mat& frame_bgr, c
         beauty_state_.fx_wrinkle_mask_gain,
         beauty_state_.fx_wrinkle_neg_cap
     );
+    small_ctx.Commit();
     
     // Upsample back to original ROI size using LANCZOS4 for better texture preservation
     cv::Mat up; 
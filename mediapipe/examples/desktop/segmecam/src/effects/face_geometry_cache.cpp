@@ -0,0 +1,115 @@
+#include "include/effects/face_geometry_cache.h"
+#include "include/pipeline/trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <opencv2/imgproc.hpp>
+
+namespace segmecam {
+
+namespace {
+
+// Least-squares similarity q ~ [a -b; b a] p + t; returns the largest residual
+double FitSimilarity(const std::vector<cv::Point2f>& p, const std::vector<cv::Point2f>& q,
+                     double* a, double* b, cv::Point2d* t) {
+    const size_t n = p.size();
+    cv::Point2d pc(0, 0), qc(0, 0);
+    for (size_t i = 0; i < n; ++i) {
+        pc += cv::Point2d(p[i]);
+        qc += cv::Point2d(q[i]);
+    }
+    pc *= 1.0 / n;
+    qc *= 1.0 / n;
+    double sxx = 0.0, sdot = 0.0, scross = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        cv::Point2d u = cv::Point2d(p[i]) - pc;
+        cv::Point2d v = cv::Point2d(q[i]) - qc;
+        sxx += u.dot(u);
+        sdot += u.dot(v);
+        scross += u.x * v.y - u.y * v.x;
+    }
+    if (sxx < 1e-9) {
+        *a = 1.0;
+        *b = 0.0;
+    } else {
+        *a = sdot / sxx;
+        *b = scross / sxx;
+    }
+    *t = qc - cv::Point2d(*a * pc.x - *b * pc.y, *b * pc.x + *a * pc.y);
+    double worst = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        cv::Point2d m(*a * p[i].x - *b * p[i].y + t->x, *b * p[i].x + *a * p[i].y + t->y);
+        worst = std::max(worst, cv::norm(m - cv::Point2d(q[i])));
+    }
+    return worst;
+}
+
+} // namespace
+
+void FaceGeometryCache::Apply(FaceEffectsContext& ctx, const mediapipe::NormalizedLandmarkList& lms,
+                              float edge_feather_px) {
+    if (ctx.Empty() || lms.landmark_size() == 0) return;
+    stats_.frames++;
+
+    const cv::Size size = ctx.FrameSize();
+    current_.resize(lms.landmark_size());
+    for (int i = 0; i < lms.landmark_size(); ++i) {
+        current_[i] = cv::Point2f(lms.landmark(i).x() * size.width, lms.landmark(i).y() * size.height);
+    }
+    if (!valid_ || edge_feather_px != edge_feather_px_ || current_.size() != points_.size()) {
+        Rebuild(ctx, edge_feather_px);
+        return;
+    }
+
+    double moved = 0.0;
+    for (size_t i = 0; i < current_.size(); ++i) {
+        moved = std::max(moved, (double)cv::norm(current_[i] - points_[i]));
+    }
+
+    double a = 1.0, b = 0.0;
+    cv::Point2d t(0, 0);
+    if (moved < kReuseMaxPx) {
+        if (ctx.Box() == box_) {
+            ctx.SetSkinGeometry(skin_mask_, edge_weight_, edge_feather_px);
+            stats_.reused++;
+            return;
+        }
+        // Same geometry, box shifted by rounding: plain translation below
+        stats_.reused++;
+    } else if (moved < kWarpMaxPx && FitSimilarity(points_, current_, &a, &b, &t) < kWarpResidualMaxPx) {
+        stats_.warped++;
+    } else {
+        Rebuild(ctx, edge_feather_px);
+        return;
+    }
+
+    SEGMECAM_TRACE_SCOPE("face_geometry.warp");
+    // Cached box coordinates -> frame -> current box coordinates
+    const cv::Rect& dst = ctx.Box();
+    cv::Matx23d m(a, -b, a * box_.x - b * box_.y + t.x - dst.x,
+                  b,  a, b * box_.x + a * box_.y + t.y - dst.y);
+    cv::Mat mask, weight;
+    cv::warpAffine(skin_mask_, mask, m, dst.size(), cv::INTER_NEAREST, cv::BORDER_CONSTANT, cv::Scalar(0));
+    cv::warpAffine(edge_weight_, weight, m, dst.size(), cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(0));
+    ctx.SetSkinGeometry(mask, weight, edge_feather_px);
+}
+
+void FaceGeometryCache::Rebuild(FaceEffectsContext& ctx, float edge_feather_px) {
+    SEGMECAM_TRACE_SCOPE("face_geometry.rebuild");
+    skin_mask_ = ctx.SkinMask();
+    edge_weight_ = ctx.SkinEdgeWeight(edge_feather_px);
+    box_ = ctx.Box();
+    points_ = current_;
+    edge_feather_px_ = edge_feather_px;
+    valid_ = true;
+    stats_.rebuilt++;
+}
+
+void FaceGeometryCache::Reset() {
+    valid_ = false;
+    points_.clear();
+    skin_mask_.release();
+    edge_weight_.release();
+}
+
+} // namespace segmecam
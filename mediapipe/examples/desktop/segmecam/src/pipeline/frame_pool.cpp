@@ -0,0 +1,94 @@
+#include "include/pipeline/frame_pool.h"
+
+namespace segmecam {
+
+namespace {
+
+// Slabs untouched for this many frames release their free buffers
+constexpr uint64_t kIdleFramesBeforeTrim = 120;
+
+} // namespace
+
+FramePool::FramePool(size_t max_buffers_per_key)
+    : max_buffers_per_key_(max_buffers_per_key > 0 ? max_buffers_per_key : 1) {}
+
+uint64_t FramePool::MakeKey(int rows, int cols, int type) {
+    return ((uint64_t)(uint32_t)rows << 40) ^ ((uint64_t)(uint32_t)cols << 16) ^ (uint64_t)(uint32_t)type;
+}
+
+bool FramePool::IsFree(const cv::Mat& buf) {
+    // Only the pool holds a reference. Leases only ever drop references
+    // outside the lock, so a free buffer cannot become leased behind our back.
+    return buf.u && CV_XADD(&buf.u->refcount, 0) == 1;
+}
+
+cv::Mat FramePool::Acquire(int rows, int cols, int type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.acquisitions++;
+    Slab& slab = slabs_[MakeKey(rows, cols, type)];
+    slab.last_used_frame = frame_counter_;
+    for (const cv::Mat& buf : slab.buffers) {
+        if (IsFree(buf)) return buf;
+    }
+
+    cv::Mat buf(rows, cols, type);
+    stats_.allocations++;
+    if (slab.buffers.size() < max_buffers_per_key_) {
+        slab.buffers.push_back(buf);
+        stats_.pooled_buffers++;
+        stats_.pooled_bytes += buf.total() * buf.elemSize();
+    } else {
+        stats_.overflows++;
+    }
+    return buf;
+}
+
+void FramePool::ReleaseFreeBuffers(Slab& slab) {
+    auto& bufs = slab.buffers;
+    for (size_t i = 0; i < bufs.size();) {
+        if (IsFree(bufs[i])) {
+            stats_.pooled_buffers--;
+            stats_.pooled_bytes -= bufs[i].total() * bufs[i].elemSize();
+            bufs[i] = bufs.back();
+            bufs.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void FramePool::BeginFrame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frame_counter_++;
+    if (frame_counter_ % kIdleFramesBeforeTrim != 0) return;
+
+    for (auto it = slabs_.begin(); it != slabs_.end();) {
+        if (frame_counter_ - it->second.last_used_frame >= kIdleFramesBeforeTrim) {
+            ReleaseFreeBuffers(it->second);
+        }
+        if (it->second.buffers.empty()) {
+            it = slabs_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void FramePool::Trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& kv : slabs_) {
+        ReleaseFreeBuffers(kv.second);
+    }
+}
+
+uint64_t FramePool::AllocationCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.allocations;
+}
+
+FramePoolStats FramePool::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace segmecam
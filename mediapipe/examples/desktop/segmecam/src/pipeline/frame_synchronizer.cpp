@@ -0,0 +1,237 @@
+#include "include/pipeline/frame_synchronizer.h"
+#include "include/pipeline/session_file.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace segmecam {
+
+namespace {
+
+// Outputs kept around even when no pending frame needs them (fallback and
+// landmark freshness checks need the previous mask).
+constexpr size_t kMinKeptOutputs = 2;
+constexpr size_t kMaxKeptOutputs = 16;
+
+cv::Point2f LandmarkCentroid(const mediapipe::NormalizedLandmarkList& lms) {
+    cv::Point2f c(0.f, 0.f);
+    int n = lms.landmark_size();
+    if (n == 0) return c;
+    for (int i = 0; i < n; ++i) {
+        c.x += lms.landmark(i).x();
+        c.y += lms.landmark(i).y();
+    }
+    return c * (1.0f / (float)n);
+}
+
+} // namespace
+
+void FrameSynchronizer::Reset() {
+    frames_.clear();
+    masks_.clear();
+    landmarks_.clear();
+}
+
+void FrameSynchronizer::AddFrame(mediapipe::Timestamp ts, const cv::Mat& frame_bgr) {
+    if (recorder_) recorder_->WriteFrame(ts.Value(), frame_bgr);
+    if (!frames_.empty() && ts <= frames_.back().ts) {
+        // Timestamps went backwards (graph restarted) - start over
+        Reset();
+    }
+    while (frames_.size() >= std::max<size_t>(1, config_.max_pending_frames)) {
+        frames_.pop_front();
+        stats_.dropped_frames++;
+    }
+    frames_.push_back(PendingFrame{ts, frame_bgr, Clock::now()});
+}
+
+void FrameSynchronizer::AddMask(mediapipe::Timestamp ts, const cv::Mat& mask_u8) {
+    if (recorder_) recorder_->WriteMask(ts.Value(), mask_u8);
+    if (!masks_.empty() && ts <= masks_.back().ts) return;
+    masks_.push_back(MaskEntry{ts, mask_u8, Clock::now()});
+    while (masks_.size() > kMaxKeptOutputs) masks_.pop_front();
+}
+
+void FrameSynchronizer::AddLandmarks(mediapipe::Timestamp ts,
+                                     const mediapipe::NormalizedLandmarkList& landmarks) {
+    if (recorder_) recorder_->WriteLandmarks(ts.Value(), landmarks);
+    if (!landmarks_.empty() && ts <= landmarks_.back().ts) return;
+    landmarks_.push_back(LandmarksEntry{ts, landmarks});
+    while (landmarks_.size() > kMaxKeptOutputs) landmarks_.pop_front();
+}
+
+const FrameSynchronizer::MaskEntry* FrameSynchronizer::FindMask(mediapipe::Timestamp ts) const {
+    for (auto it = masks_.rbegin(); it != masks_.rend(); ++it) {
+        if (it->ts == ts) return &*it;
+        if (it->ts < ts) break;
+    }
+    return nullptr;
+}
+
+const FrameSynchronizer::LandmarksEntry* FrameSynchronizer::FindLandmarks(mediapipe::Timestamp ts) const {
+    for (auto it = landmarks_.rbegin(); it != landmarks_.rend(); ++it) {
+        if (it->ts == ts) return &*it;
+        if (it->ts < ts) break;
+    }
+    return nullptr;
+}
+
+int FrameSynchronizer::CheckMatch(const PendingFrame& frame, Clock::time_point now, bool* timed_out) const {
+    auto max_wait = std::chrono::milliseconds(config_.max_wait_ms);
+    const MaskEntry* mask = FindMask(frame.ts);
+    if (!mask) {
+        // Streams are timestamp ordered: a newer mask means this frame was skipped
+        if (!masks_.empty() && masks_.back().ts > frame.ts) return -1;
+        if (now - frame.arrival > max_wait) {
+            *timed_out = true;
+            return 1;
+        }
+        return 0;
+    }
+    if (!config_.expect_landmarks) return 1;
+    if (FindLandmarks(frame.ts)) return 1;
+    // No packet is emitted when there is no face; a newer one proves absence
+    if (!landmarks_.empty() && landmarks_.back().ts > frame.ts) return 1;
+    if (now - mask->arrival > std::chrono::milliseconds(config_.landmark_grace_ms)) return 1;
+    if (now - frame.arrival > max_wait) {
+        *timed_out = true;
+        return 1;
+    }
+    return 0;
+}
+
+void FrameSynchronizer::Fill(const PendingFrame& frame, bool allow_extrapolation, FusedFrame& out) {
+    out.timestamp = frame.ts;
+    out.frame_bgr = frame.frame_bgr;
+    out.mask_u8.release();
+    out.exact_mask = false;
+    out.has_landmarks = false;
+
+    // Mask: exact match, else the newest one (never newer than the frame here)
+    mediapipe::Timestamp prev_mask_ts = mediapipe::Timestamp::Unset();
+    if (const MaskEntry* m = FindMask(frame.ts)) {
+        out.mask_u8 = m->mask_u8;
+        out.exact_mask = true;
+    } else if (!masks_.empty()) {
+        out.mask_u8 = masks_.back().mask_u8;
+    }
+    for (auto it = masks_.rbegin(); it != masks_.rend(); ++it) {
+        if (it->ts < frame.ts && it->mask_u8.data != out.mask_u8.data) {
+            prev_mask_ts = it->ts;
+            break;
+        }
+    }
+
+    // Landmarks: exact match, else the newest set if it is not staler than
+    // the mask before the one used (older sets mean the face is gone)
+    if (const LandmarksEntry* l = FindLandmarks(frame.ts)) {
+        out.landmarks = l->landmarks;
+        out.has_landmarks = true;
+    } else if (!landmarks_.empty() &&
+               (config_.policy != FusionPolicy::kWaitForMatch || !out.exact_mask) &&
+               (prev_mask_ts == mediapipe::Timestamp::Unset() || landmarks_.back().ts >= prev_mask_ts)) {
+        out.landmarks = landmarks_.back().landmarks;
+        out.has_landmarks = true;
+    }
+
+    if (out.exact_mask) stats_.exact_matches++;
+    if (allow_extrapolation && Extrapolate(frame, out)) stats_.extrapolated++;
+    stats_.released++;
+}
+
+bool FrameSynchronizer::Extrapolate(const PendingFrame& frame, FusedFrame& out) const {
+    // Constant-velocity prediction from the two newest landmark sets
+    if (landmarks_.size() < 2 || !out.has_landmarks) return false;
+    const LandmarksEntry& l1 = landmarks_.back();
+    const LandmarksEntry& l0 = landmarks_[landmarks_.size() - 2];
+    if (l1.ts == frame.ts) return false;  // Already exact
+    if (l0.landmarks.landmark_size() != l1.landmarks.landmark_size()) return false;
+
+    double dt_hist = (double)(l1.ts.Value() - l0.ts.Value());
+    double dt_pred = (double)(frame.ts.Value() - l1.ts.Value());
+    if (dt_hist <= 0.0 || dt_pred <= 0.0) return false;
+    float alpha = (float)std::min(2.0, dt_pred / dt_hist);
+
+    mediapipe::NormalizedLandmarkList predicted = l1.landmarks;
+    for (int i = 0; i < predicted.landmark_size(); ++i) {
+        const auto& a = l0.landmarks.landmark(i);
+        const auto& b = l1.landmarks.landmark(i);
+        auto* p = predicted.mutable_landmark(i);
+        p->set_x(b.x() + alpha * (b.x() - a.x()));
+        p->set_y(b.y() + alpha * (b.y() - a.y()));
+        p->set_z(b.z() + alpha * (b.z() - a.z()));
+    }
+
+    // Shift a stale mask by the predicted face motion since the mask's frame
+    if (!out.exact_mask && !out.mask_u8.empty()) {
+        const mediapipe::NormalizedLandmarkList* base = &l1.landmarks;
+        if (!masks_.empty()) {
+            if (const LandmarksEntry* at_mask = FindLandmarks(masks_.back().ts)) base = &at_mask->landmarks;
+        }
+        cv::Point2f d = LandmarkCentroid(predicted) - LandmarkCentroid(*base);
+        float dx = d.x * (float)out.mask_u8.cols;
+        float dy = d.y * (float)out.mask_u8.rows;
+        if (std::abs(dx) > 0.25f || std::abs(dy) > 0.25f) {
+            cv::Mat shift = (cv::Mat_<float>(2, 3) << 1.f, 0.f, dx, 0.f, 1.f, dy);
+            cv::Mat shifted;
+            cv::warpAffine(out.mask_u8, shifted, shift, out.mask_u8.size(),
+                           cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+            out.mask_u8 = shifted;
+        }
+    }
+    out.landmarks = std::move(predicted);
+    return true;
+}
+
+void FrameSynchronizer::PruneOutputs() {
+    if (frames_.empty()) {
+        while (masks_.size() > kMinKeptOutputs) masks_.pop_front();
+        while (landmarks_.size() > kMinKeptOutputs) landmarks_.pop_front();
+        return;
+    }
+    mediapipe::Timestamp oldest = frames_.front().ts;
+    while (masks_.size() > kMinKeptOutputs && masks_.front().ts < oldest) masks_.pop_front();
+    while (landmarks_.size() > kMinKeptOutputs && landmarks_.front().ts < oldest) landmarks_.pop_front();
+}
+
+bool FrameSynchronizer::PopReady(FusedFrame& out) {
+    if (frames_.empty()) return false;
+
+    if (config_.policy != FusionPolicy::kWaitForMatch) {
+        // Freshness first: newest frame, whatever outputs exist
+        stats_.superseded_frames += frames_.size() - 1;
+        PendingFrame newest = std::move(frames_.back());
+        frames_.clear();
+        Fill(newest, config_.policy == FusionPolicy::kExtrapolate, out);
+        PruneOutputs();
+        return true;
+    }
+
+    auto now = Clock::now();
+    bool found = false;
+    bool chosen_timed_out = false;
+    PendingFrame chosen;
+    while (!frames_.empty()) {
+        bool timed_out = false;
+        int r = CheckMatch(frames_.front(), now, &timed_out);
+        if (r < 0) {
+            frames_.pop_front();
+            stats_.dropped_frames++;
+            continue;
+        }
+        if (r == 0) break;  // Later frames cannot be ready before this one
+        if (found) stats_.superseded_frames++;
+        chosen = std::move(frames_.front());
+        chosen_timed_out = timed_out;
+        found = true;
+        frames_.pop_front();
+    }
+    if (!found) return false;
+
+    Fill(chosen, false, out);
+    if (chosen_timed_out) stats_.fallbacks++;
+    PruneOutputs();
+    return true;
+}
+
+} // namespace segmecam
@@ -0,0 +1,111 @@
+#include "include/pipeline/mask_decoder.h"
+#include "include/pipeline/trace.h"
+
+#include <iostream>
+
+namespace segmecam {
+
+namespace {
+
+// Owner of packet-backed Mats: the UMatData carries a heap copy of the
+// Packet (a shared reference to the ImageFrame) and frees it together with
+// the header once the last Mat referencing it is released. Never allocates,
+// so it is only ever installed as currAllocator, not as Mat::allocator.
+class PacketAllocator : public cv::MatAllocator {
+public:
+    cv::UMatData* allocate(int, const int*, int, void*, size_t*,
+                           cv::AccessFlag, cv::UMatUsageFlags) const override {
+        return nullptr;
+    }
+    bool allocate(cv::UMatData*, cv::AccessFlag, cv::UMatUsageFlags) const override {
+        return false;
+    }
+    void deallocate(cv::UMatData* u) const override {
+        if (!u) return;
+        delete static_cast<mediapipe::Packet*>(u->userdata);
+        delete u;
+    }
+};
+
+void HoldPacket(cv::Mat& view, const mediapipe::Packet& packet) {
+    static PacketAllocator allocator;
+    cv::UMatData* u = new cv::UMatData(&allocator);
+    u->data = u->origdata = view.data;
+    u->size = view.step[0] * (size_t)view.rows;
+    u->userdata = new mediapipe::Packet(packet);
+    u->refcount = 1;
+    view.u = u;
+}
+
+} // namespace
+
+void MaskDecoder::SelectChannel(const cv::Mat& rgba) {
+    // Channel with the highest mean value (most likely to contain segmentation data);
+    // alpha only if clearly better, to avoid blue tint issues
+    cv::Scalar m = cv::mean(rgba);
+    int best = 0;
+    double bestv = m[0];
+    if (m[1] > bestv) { best = 1; bestv = m[1]; }
+    if (m[2] > bestv) { best = 2; bestv = m[2]; }
+    if (m[3] > bestv + 10.0) { best = 3; bestv = m[3]; }
+    rgba_channel_ = best;
+    std::cout << "🎭 Mask channels=4 byteDepth=1 means[B,G,R,A]="
+              << m[0] << "," << m[1] << "," << m[2] << "," << m[3]
+              << " chosen=" << "BGRA"[best] << std::endl;
+}
+
+cv::Mat MaskDecoder::Decode(const mediapipe::ImageFrame& mask, FramePool* pool) {
+    SEGMECAM_TRACE_SCOPE("mask.decode");
+    const int ch = mask.NumberOfChannels();
+    const int bd = mask.ByteDepth();
+    const cv::Size size(mask.Width(), mask.Height());
+    const size_t step = mask.WidthStep();
+    uint8_t* pixels = const_cast<uint8_t*>(mask.PixelData());
+    cv::Mat out = AcquireFrame(pool, size, CV_8UC1);
+
+    if (ch == 1 && bd == 1) {
+        cv::Mat(size, CV_8UC1, pixels, step).copyTo(out);
+    } else if (ch == 4 && bd == 1) {
+        cv::Mat rgba(size, CV_8UC4, pixels, step);
+        if (rgba_channel_ < 0) SelectChannel(rgba);
+        // Strided single-channel copy, no split into planes
+        int from_to[] = {rgba_channel_, 0};
+        cv::mixChannels(&rgba, 1, &out, 1, from_to, 1);
+    } else if (bd == 4) {
+        // Float confidence 0..1; first channel when there are several
+        if (ch == 1) {
+            cv::Mat(size, CV_32FC1, pixels, step).convertTo(out, CV_8UC1, 255.0);
+        } else {
+            for (int y = 0; y < size.height; ++y) {
+                const float* src = reinterpret_cast<const float*>(pixels + y * step);
+                uint8_t* dst = out.ptr<uint8_t>(y);
+                for (int x = 0; x < size.width; ++x) {
+                    dst[x] = cv::saturate_cast<uint8_t>(src[x * ch] * 255.0f);
+                }
+            }
+        }
+    } else if (ch == 1 && bd == 2) {
+        cv::Mat(size, CV_16UC1, pixels, step).convertTo(out, CV_8UC1, 1.0 / 257.0);
+    } else {
+        if (!warned_format_) {
+            std::cerr << "⚠️ Unsupported mask format: " << ch << " channels, byte depth " << bd << std::endl;
+            warned_format_ = true;
+        }
+        out.setTo(0);
+    }
+    return out;
+}
+
+cv::Mat MaskDecoder::DecodeView(const mediapipe::Packet& packet, FramePool* pool) {
+    const auto& mask = packet.Get<mediapipe::ImageFrame>();
+    if (mask.NumberOfChannels() != 1 || mask.ByteDepth() != 1) {
+        return Decode(mask, pool);
+    }
+    SEGMECAM_TRACE_SCOPE("mask.view");
+    cv::Mat view(mask.Height(), mask.Width(), CV_8UC1,
+                 const_cast<uint8_t*>(mask.PixelData()), mask.WidthStep());
+    HoldPacket(view, packet);
+    return view;
+}
+
+} // namespace segmecam
@@ -0,0 +1,313 @@
+#include "include/pipeline/session_file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace segmecam {
+
+namespace {
+
+constexpr char kFileMagic[8] = {'S', 'G', 'M', 'S', 'E', 'S', 'S', '1'};
+constexpr uint32_t kFileVersion = 1;
+constexpr uint32_t kRecordMagic = 0x44524353;  // "SCRD"
+constexpr size_t kAlign = 64;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_bytes;
+    uint8_t reserved[48];
+};
+static_assert(sizeof(FileHeader) == kAlign, "file header must stay 64 bytes");
+
+struct RecordHeader {
+    uint32_t magic;
+    uint16_t type;
+    uint16_t reserved0;
+    int64_t timestamp;
+    int64_t capture_us;
+    int32_t rows;
+    int32_t cols;
+    int32_t cv_type;
+    uint32_t step;
+    uint64_t payload_bytes;
+    uint8_t reserved1[8];
+};
+static_assert(sizeof(RecordHeader) == kAlign, "record header must stay 64 bytes");
+
+size_t PaddedSize(uint64_t bytes) {
+    return (size_t)((bytes + kAlign - 1) / kAlign * kAlign);
+}
+
+// Whether the header can be trusted: the payload lies within the available
+// bytes and an image record describes a cv::Mat that fits its payload
+bool ValidRecord(const RecordHeader& rec, size_t available) {
+    if (rec.magic != kRecordMagic || rec.payload_bytes > available) return false;
+    const SessionRecordType type = (SessionRecordType)rec.type;
+    if (type == SessionRecordType::kLandmarks) {
+        return rec.payload_bytes <= (uint64_t)INT_MAX;  // ParseFromArray takes an int
+    }
+    if (type != SessionRecordType::kFrame && type != SessionRecordType::kMask) return true;
+    if (rec.rows <= 0 || rec.cols <= 0 || rec.cv_type < 0 ||
+        rec.cv_type != (rec.cv_type & CV_MAT_TYPE_MASK) || CV_MAT_DEPTH(rec.cv_type) > CV_64F) {
+        return false;
+    }
+    return (uint64_t)rec.cols * CV_ELEM_SIZE(rec.cv_type) <= rec.step &&
+           (uint64_t)rec.rows * rec.step <= rec.payload_bytes;
+}
+
+int64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// SessionRecorder
+// ---------------------------------------------------------------------------
+
+SessionRecorder::~SessionRecorder() {
+    Close();
+}
+
+bool SessionRecorder::Open(const std::string& path) {
+    Close();
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "❌ Failed to create session file: " << path << std::endl;
+        return false;
+    }
+    // Large buffer: frames arrive as multi-megabyte writes at camera rate
+    std::setvbuf(file_, nullptr, _IOFBF, 8 << 20);
+
+    FileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version = kFileVersion;
+    header.header_bytes = sizeof(FileHeader);
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+        Fail();
+        return false;
+    }
+    path_ = path;
+    records_ = 0;
+    bytes_ = sizeof(header);
+    std::cout << "🔴 Recording session to " << path << std::endl;
+    return true;
+}
+
+void SessionRecorder::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) return;
+    std::fclose(file_);
+    file_ = nullptr;
+    std::cout << "💾 Session saved: " << path_ << " (" << records_ << " records, "
+              << (bytes_ >> 20) << " MB)" << std::endl;
+}
+
+bool SessionRecorder::IsOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_ != nullptr;
+}
+
+uint64_t SessionRecorder::RecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+}
+
+uint64_t SessionRecorder::BytesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+void SessionRecorder::Fail() {
+    std::cerr << "❌ Session write failed, recording stopped: " << path_ << std::endl;
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+bool SessionRecorder::WriteFrame(int64_t ts, const cv::Mat& frame_bgr) {
+    return WriteImage(SessionRecordType::kFrame, ts, frame_bgr);
+}
+
+bool SessionRecorder::WriteMask(int64_t ts, const cv::Mat& mask_u8) {
+    return WriteImage(SessionRecordType::kMask, ts, mask_u8);
+}
+
+bool SessionRecorder::WriteLandmarks(int64_t ts, const mediapipe::NormalizedLandmarkList& landmarks) {
+    std::string bytes;
+    if (!landmarks.SerializeToString(&bytes)) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return WriteRecord(SessionRecordType::kLandmarks, ts, 0, 0, 0, 0, bytes.data(), bytes.size());
+}
+
+bool SessionRecorder::WriteImage(SessionRecordType type, int64_t ts, const cv::Mat& img) {
+    if (img.empty()) return false;
+    // Store tightly packed rows so the reader can map the payload as is
+    uint32_t row_bytes = (uint32_t)(img.cols * img.elemSize());
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (img.isContinuous()) {
+        return WriteRecord(type, ts, img.rows, img.cols, img.type(), row_bytes, img.data,
+                           (uint64_t)row_bytes * img.rows);
+    }
+    cv::Mat packed = img.clone();
+    return WriteRecord(type, ts, packed.rows, packed.cols, packed.type(), row_bytes, packed.data,
+                       (uint64_t)row_bytes * packed.rows);
+}
+
+bool SessionRecorder::WriteRecord(SessionRecordType type, int64_t ts, int rows, int cols, int cv_type,
+                                  uint32_t step, const void* data, uint64_t bytes) {
+    if (!file_) return false;
+    RecordHeader header{};
+    header.magic = kRecordMagic;
+    header.type = (uint16_t)type;
+    header.timestamp = ts;
+    header.capture_us = NowUs();
+    header.rows = rows;
+    header.cols = cols;
+    header.cv_type = cv_type;
+    header.step = step;
+    header.payload_bytes = bytes;
+
+    static const uint8_t kZeros[kAlign] = {};
+    size_t padding = PaddedSize(bytes) - bytes;
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1 ||
+        (bytes > 0 && std::fwrite(data, 1, bytes, file_) != bytes) ||
+        (padding > 0 && std::fwrite(kZeros, 1, padding, file_) != padding)) {
+        Fail();
+        return false;
+    }
+    records_++;
+    bytes_ += sizeof(header) + bytes + padding;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// SessionReader
+// ---------------------------------------------------------------------------
+
+SessionReader::~SessionReader() {
+    Close();
+}
+
+bool SessionReader::Open(const std::string& path) {
+    Close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "❌ Failed to open session file: " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(FileHeader)) {
+        std::cerr << "❌ Not a session file (too small): " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* mapped = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file referenced
+    if (mapped == MAP_FAILED) {
+        std::cerr << "❌ mmap failed for session file: " << path << std::endl;
+        return false;
+    }
+    base_ = static_cast<const uint8_t*>(mapped);
+    size_ = (size_t)st.st_size;
+    ::madvise(mapped, size_, MADV_SEQUENTIAL);
+
+    FileHeader header;
+    std::memcpy(&header, base_, sizeof(header));
+    if (std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0 || header.version != kFileVersion) {
+        std::cerr << "❌ Unsupported session file: " << path << std::endl;
+        Close();
+        return false;
+    }
+
+    // Index by walking the record headers only (payloads are never touched)
+    size_t offset = std::max<size_t>(header.header_bytes, sizeof(FileHeader));
+    while (offset <= size_ && sizeof(RecordHeader) <= size_ - offset) {
+        RecordHeader rec;
+        std::memcpy(&rec, base_ + offset, sizeof(rec));
+        // Checked before padding so that a huge payload_bytes cannot wrap the offset
+        const size_t available = size_ - offset - sizeof(rec);
+        if (!ValidRecord(rec, available) || PaddedSize(rec.payload_bytes) > available) {
+            std::cerr << "⚠️  Session truncated or corrupt at byte " << offset << ", using what precedes it" << std::endl;
+            break;
+        }
+        const size_t end = offset + sizeof(rec) + PaddedSize(rec.payload_bytes);
+        IndexEntry entry{rec.timestamp, rec.capture_us, offset};
+        switch ((SessionRecordType)rec.type) {
+            case SessionRecordType::kFrame: frames_.push_back(entry); break;
+            case SessionRecordType::kMask: masks_.push_back(entry); break;
+            case SessionRecordType::kLandmarks: landmarks_.push_back(entry); break;
+            default: break;  // Unknown record types are skipped
+        }
+        offset = end;
+    }
+    // Lookups binary-search by timestamp; each stream is recorded in order
+    auto by_ts = [](const IndexEntry& a, const IndexEntry& b) { return a.timestamp < b.timestamp; };
+    std::stable_sort(masks_.begin(), masks_.end(), by_ts);
+    std::stable_sort(landmarks_.begin(), landmarks_.end(), by_ts);
+
+    std::cout << "📂 Session " << path << ": " << frames_.size() << " frames, " << masks_.size()
+              << " masks, " << landmarks_.size() << " landmark sets" << std::endl;
+    return true;
+}
+
+void SessionReader::Close() {
+    if (base_) {
+        ::munmap(const_cast<uint8_t*>(base_), size_);
+    }
+    base_ = nullptr;
+    size_ = 0;
+    frames_.clear();
+    masks_.clear();
+    landmarks_.clear();
+}
+
+cv::Mat SessionReader::ImageAt(const IndexEntry& entry) const {
+    RecordHeader rec;
+    std::memcpy(&rec, base_ + entry.offset, sizeof(rec));
+    // Header layout keeps the payload 64-byte aligned within the page-aligned mapping
+    void* data = const_cast<uint8_t*>(base_ + entry.offset + sizeof(rec));
+    return cv::Mat(rec.rows, rec.cols, rec.cv_type, data, rec.step);
+}
+
+SessionReader::FrameRecord SessionReader::Frame(size_t index) const {
+    FrameRecord out;
+    if (index >= frames_.size()) return out;
+    const IndexEntry& entry = frames_[index];
+    out.timestamp = entry.timestamp;
+    out.capture_us = entry.capture_us;
+    out.frame_bgr = ImageAt(entry);
+    return out;
+}
+
+const SessionReader::IndexEntry* SessionReader::Find(const std::vector<IndexEntry>& index, int64_t ts) const {
+    auto it = std::lower_bound(index.begin(), index.end(), ts,
+                               [](const IndexEntry& e, int64_t t) { return e.timestamp < t; });
+    return (it != index.end() && it->timestamp == ts) ? &*it : nullptr;
+}
+
+bool SessionReader::FindMask(int64_t ts, cv::Mat& mask_u8) const {
+    const IndexEntry* entry = Find(masks_, ts);
+    if (!entry) return false;
+    mask_u8 = ImageAt(*entry);
+    return true;
+}
+
+bool SessionReader::FindLandmarks(int64_t ts, mediapipe::NormalizedLandmarkList& landmarks) const {
+    const IndexEntry* entry = Find(landmarks_, ts);
+    if (!entry) return false;
+    RecordHeader rec;
+    std::memcpy(&rec, base_ + entry->offset, sizeof(rec));
+    return landmarks.ParseFromArray(base_ + entry->offset + sizeof(rec), (int)rec.payload_bytes);
+}
+
+} // namespace segmecam
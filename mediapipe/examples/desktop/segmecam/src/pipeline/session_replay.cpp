@@ -0,0 +1,57 @@
+#include "include/pipeline/session_replay.h"
+
+#include <thread>
+
+namespace segmecam {
+
+SessionReplaySource::SessionReplaySource(const SessionReader& reader, bool realtime, bool loop)
+    : reader_(reader), realtime_(realtime), loop_(loop) {
+    size_t n = reader_.FrameCount();
+    if (n > 0) {
+        loop_span_ = reader_.Frame(n - 1).timestamp - reader_.Frame(0).timestamp + 1;
+    }
+    finished_ = (n == 0);
+}
+
+bool SessionReplaySource::NextFrame(cv::Mat& frame_bgr, mediapipe::Timestamp& ts) {
+    if (finished_) return false;
+    if (next_ >= reader_.FrameCount()) {
+        if (!loop_) {
+            finished_ = true;
+            return false;
+        }
+        next_ = 0;
+        ts_offset_ += loop_span_;
+        last_capture_us_ = 0;
+    }
+
+    SessionReader::FrameRecord rec = reader_.Frame(next_++);
+    if (realtime_ && last_capture_us_ > 0) {
+        auto interval = std::chrono::microseconds(rec.capture_us - last_capture_us_);
+        auto due = last_delivery_ + interval;
+        if (interval.count() > 0 && due > std::chrono::steady_clock::now()) {
+            std::this_thread::sleep_until(due);
+        }
+    }
+    last_capture_us_ = rec.capture_us;
+    last_delivery_ = std::chrono::steady_clock::now();
+
+    frame_bgr = rec.frame_bgr;
+    ts = mediapipe::Timestamp(rec.timestamp + ts_offset_);
+    delivered_++;
+    return true;
+}
+
+void SessionReplaySource::FeedOutputs(mediapipe::Timestamp ts, FrameSynchronizer& frame_sync) const {
+    int64_t recorded_ts = ts.Value() - ts_offset_;
+    cv::Mat mask_u8;
+    if (reader_.FindMask(recorded_ts, mask_u8)) {
+        frame_sync.AddMask(ts, mask_u8);
+    }
+    mediapipe::NormalizedLandmarkList landmarks;
+    if (reader_.FindLandmarks(recorded_ts, landmarks)) {
+        frame_sync.AddLandmarks(ts, landmarks);
+    }
+}
+
+} // namespace segmecam
@@ -0,0 +1,218 @@
+#include "include/pipeline/trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace segmecam {
+
+namespace {
+
+// Per-thread capacity (power of two). ~1 MB per thread, several seconds of
+// spans at 30 fps with every stage instrumented.
+constexpr uint64_t kRingCapacity = 1u << 15;
+
+const auto kProcessStart = std::chrono::steady_clock::now();
+
+void WriteJsonString(std::ostream& os, const std::string& s) {
+    os << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') os << '\\' << c;
+        else if ((unsigned char)c < 0x20) os << ' ';
+        else os << c;
+    }
+    os << '"';
+}
+
+} // namespace
+
+// Single-writer ring. Each slot is a small seqlock (odd sequence while the
+// owning thread writes it), so a concurrent dump skips torn slots instead
+// of blocking the writer.
+struct TraceSlot {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start_ns{0};
+    std::atomic<uint64_t> dur_ns{0};
+};
+
+struct TraceRing {
+    explicit TraceRing(uint32_t id) : tid(id), slots(new TraceSlot[kRingCapacity]) {}
+
+    uint32_t tid;
+    std::string thread_name;  // Guarded by Tracer::mutex_
+    std::atomic<uint64_t> head{0};
+    std::unique_ptr<TraceSlot[]> slots;
+};
+
+namespace {
+
+// Append the intact spans of one ring; torn or overwritten slots are skipped
+void ReadRing(const TraceRing& ring, std::vector<TraceEvent>& out) {
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t begin = head > kRingCapacity ? head - kRingCapacity : 0;
+    for (uint64_t i = begin; i < head; ++i) {
+        const TraceSlot& slot = ring.slots[i & (kRingCapacity - 1)];
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq != 2 * i + 2) continue;  // Overwritten, being written or cleared
+        TraceEvent ev;
+        ev.name = slot.name.load(std::memory_order_relaxed);
+        ev.tid = ring.tid;
+        ev.start_ns = slot.start_ns.load(std::memory_order_relaxed);
+        ev.dur_ns = slot.dur_ns.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != seq || !ev.name) continue;
+        out.push_back(ev);
+    }
+}
+
+// Invalidate the spans there now; the owner may keep appending
+void ClearRing(TraceRing& ring) {
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t first = head > kRingCapacity ? head - kRingCapacity : 0;
+    for (uint64_t i = first; i < head; ++i) {
+        TraceSlot& slot = ring.slots[i & (kRingCapacity - 1)];
+        uint64_t expected = 2 * i + 2;
+        slot.seq.compare_exchange_strong(expected, 0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+Tracer& Tracer::Instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+uint64_t Tracer::NowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - kProcessStart).count();
+}
+
+TraceRing& Tracer::ThreadRing() {
+    // Rings are owned by the registry so spans survive thread exit; the
+    // holder hands the ring back then, for the next thread to reuse
+    struct Holder {
+        TraceRing* ring = nullptr;
+        ~Holder() {
+            if (ring) Tracer::Instance().ReleaseRing(ring);
+        }
+    };
+    thread_local Holder holder;
+    if (!holder.ring) holder.ring = AcquireRing();
+    return *holder.ring;
+}
+
+TraceRing* Tracer::AcquireRing() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_rings_.empty()) {
+        // The exited thread's spans are dropped only now
+        TraceRing* ring = free_rings_.back();
+        free_rings_.pop_back();
+        ClearRing(*ring);
+        ring->thread_name.clear();
+        return ring;
+    }
+    rings_.push_back(std::make_shared<TraceRing>((uint32_t)rings_.size() + 1));
+    return rings_.back().get();
+}
+
+void Tracer::ReleaseRing(TraceRing* ring) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_rings_.push_back(ring);
+}
+
+void Tracer::SetOutputPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    output_path_ = path;
+}
+
+std::string Tracer::GetOutputPath() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return output_path_;
+}
+
+void Tracer::SetThreadName(const char* name) {
+    TraceRing& ring = ThreadRing();
+    std::lock_guard<std::mutex> lock(mutex_);
+    ring.thread_name = name ? name : "";
+}
+
+void Tracer::Record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+    TraceRing& ring = ThreadRing();
+    uint64_t idx = ring.head.load(std::memory_order_relaxed);
+    TraceSlot& slot = ring.slots[idx & (kRingCapacity - 1)];
+    slot.seq.store(2 * idx + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.dur_ns.store(end_ns >= start_ns ? end_ns - start_ns : 0, std::memory_order_relaxed);
+    slot.seq.store(2 * idx + 2, std::memory_order_release);
+    ring.head.store(idx + 1, std::memory_order_release);
+}
+
+void Tracer::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& ring : rings_) {
+        ClearRing(*ring);
+    }
+}
+
+std::vector<TraceEvent> Tracer::CollectEvents() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<TraceEvent> events;
+    for (const auto& ring : rings_) {
+        ReadRing(*ring, events);
+    }
+    return events;
+}
+
+bool Tracer::WriteChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "❌ Failed to open trace file: " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t events = 0;
+    std::vector<TraceEvent> spans;
+    bool first = true;
+    auto sep = [&]() { out << (first ? "\n" : ",\n"); first = false; };
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (const auto& ring : rings_) {
+        if (!ring->thread_name.empty()) {
+            sep();
+            out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << ring->tid
+                << ",\"args\":{\"name\":";
+            WriteJsonString(out, ring->thread_name);
+            out << "}}";
+        }
+        spans.clear();
+        ReadRing(*ring, spans);
+        for (const TraceEvent& ev : spans) {
+            sep();
+            out << "{\"ph\":\"X\",\"name\":";
+            WriteJsonString(out, ev.name);
+            out << ",\"pid\":1,\"tid\":" << ev.tid
+                << ",\"ts\":" << (double)ev.start_ns / 1000.0
+                << ",\"dur\":" << (double)ev.dur_ns / 1000.0 << "}";
+        }
+        events += spans.size();
+    }
+    out << "\n]}\n";
+    out.close();
+
+    if (!out) {
+        std::cerr << "❌ Failed to write trace file: " << path << std::endl;
+        return false;
+    }
+    std::cout << "📊 Trace written: " << path << " (" << events << " spans, "
+              << rings_.size() << " threads)" << std::endl;
+    return true;
+}
+
+} // namespace segmecam
@@ -27,6 +27,9 @@ void BackgroundPanel::Render() {
             case 3:
                 RenderSolidColorControls();
                 break;
+            case 4:
+                RenderVideoControls();
+                break;
             default:
                 break;
         }
@@ -41,7 +44,7 @@ void BackgroundPanel::RenderMaskControls() {
 void BackgroundPanel::RenderBackgroundMode() {
     ImGui::Text("Background Mode");
     
-    const char* modes[] = {"None", "Blur", "Image", "Solid Color"};
+    const char* modes[] = {"None", "Blur", "Image", "Solid Color", "Video"};
     ImGui::Combo("Mode", &state_.bg_mode, modes, IM_ARRAYSIZE(modes));
     
     // Alternative radio button layout
@@ -49,14 +52,23 @@ void BackgroundPanel::RenderBackgroundMode() {
     ImGui::RadioButton("None", &state_.bg_mode, 0); ImGui::SameLine();
     ImGui::RadioButton("Blur", &state_.bg_mode, 1); ImGui::SameLine();
     ImGui::RadioButton("Image", &state_.bg_mode, 2); ImGui::SameLine();
-    ImGui::RadioButton("Color", &state_.bg_mode, 3);
+    ImGui::RadioButton("Color", &state_.bg_mode, 3); ImGui::SameLine();
+    ImGui::RadioButton("Video", &state_.bg_mode, 4);
+    
+    // Guided upsampling follows hair and fine edges in the camera image,
+    // so less feathering is needed
+    const char* upsamplers[] = {"Bilinear", "Guided (edge-aware)"};
+    ImGui::Combo("Mask Edges", &state_.mask_upsampler, upsamplers, IM_ARRAYSIZE(upsamplers));
 }
 
 void BackgroundPanel::RenderBlurControls() {
     ImGui::Separator();
     ImGui::Text("Blur Settings");
     
-    ImGui::SliderInt("Blur Strength", &state_.blur_strength, 1, 61);
+    const char* engines[] = {"Gaussian", "Box (constant time)", "Pyramid (large radius)"};
+    ImGui::Combo("Engine", &state_.blur_backend, engines, IM_ARRAYSIZE(engines));
+    
+    ImGui::SliderInt("Blur Strength", &state_.blur_strength, 1, state_.blur_backend != 0 ? 99 : 61);
     // Ensure odd kernel size for proper blur
     if ((state_.blur_strength % 2) == 0) {
         state_.blur_strength++;
@@ -82,7 +94,7 @@ void BackgroundPanel::RenderBlurControls() {
     ImGui::TextDisabled("• Fast quality for real-time use");
     ImGui::TextDisabled("• High quality for recordings");
     
-    if (state_.blur_strength > 30) {
+    if (state_.blur_strength > 30 && state_.blur_backend == 0) {
         ImGui::TextColored(ImVec4(1, 0.6f, 0, 1), "⚠ High blur may impact performance");
     }
 }
@@ -197,6 +209,63 @@ void BackgroundPanel::RenderImageControls() {
     ImGui::TextDisabled("• Supports JPG, PNG, BMP formats");
 }
 
+void BackgroundPanel::RenderVideoControls() {
+    ImGui::Separator();
+    ImGui::Text("Video Background");
+    
+    if (video_path_edit_[0] == '\0' && state_.bg_video_path_buf[0] != '\0') {
+        std::snprintf(video_path_edit_, sizeof(video_path_edit_), "%s", state_.bg_video_path_buf);
+    }
+    ImGui::InputText("Video Path", video_path_edit_, sizeof(video_path_edit_));
+    
+    ImGui::SameLine();
+    if (ImGui::Button("Load##video")) {
+        std::snprintf(state_.bg_video_path_buf, sizeof(state_.bg_video_path_buf), "%s", video_path_edit_);
+        std::cout << "Background video: " << state_.bg_video_path_buf << std::endl;
+    }
+    
+#ifdef __linux__
+    ImGui::SameLine();
+    if (ImGui::Button("Browse##video")) {
+        FILE* fp = popen("zenity --file-selection --file-filter='Videos (*.mp4,*.mkv,*.webm,*.mov,*.avi) | *.mp4 *.mkv *.webm *.mov *.avi' --title='Select background video' 2>/dev/null", "r");
+        if (fp) {
+            char out[1024] = {0};
+            if (fgets(out, sizeof(out), fp)) {
+                size_t n = strlen(out);
+                while (n > 0 && (out[n-1] == '\n' || out[n-1] == '\r')) {
+                    out[--n] = '\0';
+                }
+                if (n > 0) {
+                    std::snprintf(video_path_edit_, sizeof(video_path_edit_), "%s", out);
+                    std::snprintf(state_.bg_video_path_buf, sizeof(state_.bg_video_path_buf), "%s", out);
+                    std::cout << "Background video: " << state_.bg_video_path_buf << std::endl;
+                }
+            }
+            pclose(fp);
+        }
+    }
+#endif
+    
+    ImGui::SameLine();
+    if (ImGui::Button("Clear##video")) {
+        state_.bg_video_path_buf[0] = '\0';
+        video_path_edit_[0] = '\0';
+        std::cout << "Cleared background video" << std::endl;
+    }
+    
+    ImGui::Checkbox("Keep short clips in memory", &state_.bg_video_preload);
+    
+    if (state_.bg_video_path_buf[0] == '\0') {
+        ImGui::TextDisabled("No video loaded");
+    }
+    
+    ImGui::Separator();
+    ImGui::TextDisabled("Tips:");
+    ImGui::TextDisabled("• Loops forever, decoded on a background thread");
+    ImGui::TextDisabled("• Clips up to ~256 MB decoded play from memory");
+    ImGui::TextDisabled("• Supports whatever OpenCV's video backend reads");
+}
+
 void BackgroundPanel::RenderSolidColorControls() {
     ImGui::Separator();
     ImGui::Text("Solid Color Background");
@@ -38,6 +38,8 @@ void BeautyPanel::RenderPresets() {
         // Copy current background settings
         bs.bg_mode = state_.bg_mode;
         bs.blur_strength = state_.blur_strength;
+        bs.blur_backend = state_.blur_backend;
+        bs.mask_upsampler = state_.mask_upsampler;
         bs.feather_px = state_.feather_px;
         bs.show_mask = state_.show_mask;
         
@@ -92,6 +94,8 @@ void BeautyPanel::RenderPresets() {
         // Copy back to AppState (only matching fields)
         state_.bg_mode = bs.bg_mode;
         state_.blur_strength = bs.blur_strength;
+        state_.blur_backend = bs.blur_backend;
+        state_.mask_upsampler = bs.mask_upsampler;
         state_.feather_px = bs.feather_px;
         state_.show_mask = bs.show_mask;
         
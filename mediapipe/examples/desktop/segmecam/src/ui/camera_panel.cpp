@@ -1,6 +1,5 @@
 #include "include/ui/ui_panels.h"
 #include "include/camera/camera_manager.h"
-#include "include/effects/effects_manager.h"
 #include "src/config/config_manager.h"
 #include "cam_enum.h"
 #include "vcam.h"
@@ -15,8 +14,8 @@
 namespace segmecam {
 
 // Camera Panel Implementation
-CameraPanel::CameraPanel(AppState& state, CameraManager& camera_mgr, EffectsManager& effects_mgr)
-    : UIPanel("Camera"), state_(state), camera_mgr_(camera_mgr), effects_mgr_(effects_mgr) {
+CameraPanel::CameraPanel(AppState& state, CameraManager& camera_mgr, const PanelLocks& locks)
+    : UIPanel("Camera"), state_(state), camera_mgr_(camera_mgr), locks_(locks) {
     SyncWithCameraState();
     RefreshVirtualCameraDevices();
 }
@@ -86,6 +85,7 @@ void CameraPanel::RenderCameraSelection() {
         if (ImGui::Combo("Camera", &ui_cam_idx_, items.data(), (int)items.size())) {
             if (ui_cam_idx_ != current_cam) {
                 // Use placeholder resolution and fps for now
+                auto lock = LockIf(locks_.camera);
                 camera_mgr_.SetCurrentCamera(ui_cam_idx_, 0, 0);
                 std::cout << "Camera changed to: " << items[ui_cam_idx_] << std::endl;
             }
@@ -93,6 +93,7 @@ void CameraPanel::RenderCameraSelection() {
     } else {
         ImGui::Text("No cameras detected");
         if (ImGui::Button("Refresh")) {
+            auto lock = LockIf(locks_.camera);
             camera_mgr_.RefreshCameraList();
         }
     }
@@ -116,7 +117,8 @@ void CameraPanel::RenderResolutionSettings() {
     if (!res_items_.empty()) {
         if (ImGui::Combo("Resolution", &ui_res_idx_, res_items_.data(), (int)res_items_.size())) {
             if (ui_res_idx_ >= 0 && ui_res_idx_ < (int)res_list.size()) {
-                const auto& selected_res = res_list[ui_res_idx_];
+                const auto selected_res = res_list[ui_res_idx_];
+                auto lock = LockIf(locks_.camera);
                 camera_mgr_.SetResolution(selected_res.first, selected_res.second);
                 std::cout << "Resolution changed to: " << selected_res.first << "x" << selected_res.second << std::endl;
             }
@@ -135,8 +137,10 @@ void CameraPanel::RenderResolutionSettings() {
     if (!fps_items_.empty()) {
         if (ImGui::Combo("FPS", &ui_fps_idx_, fps_items_.data(), (int)fps_items_.size())) {
             if (ui_fps_idx_ >= 0 && ui_fps_idx_ < (int)fps_list.size()) {
-                camera_mgr_.SetFPS(fps_list[ui_fps_idx_]);
-                std::cout << "FPS changed to: " << fps_list[ui_fps_idx_] << std::endl;
+                int selected_fps = fps_list[ui_fps_idx_];
+                auto lock = LockIf(locks_.camera);
+                camera_mgr_.SetFPS(selected_fps);
+                std::cout << "FPS changed to: " << selected_fps << std::endl;
             }
         }
     }
@@ -146,13 +150,21 @@ void CameraPanel::RenderVirtualCameraControls() {
     ImGui::Text("Virtual Camera Output");
     ImGui::Separator();
     
-    // Check if virtual camera is active
-    bool vcam_active = state_.vcam.IsOpen();
+    // Check if virtual camera is active (the vcam stage may reopen it meanwhile)
+    bool vcam_active;
+    int vcam_active_w, vcam_active_h;
+    {
+        auto lock = LockIf(locks_.vcam);
+        vcam_active = state_.vcam.IsOpen();
+        vcam_active_w = state_.vcam.Width();
+        vcam_active_h = state_.vcam.Height();
+    }
     
     if (vcam_active) {
-        ImGui::TextColored(ImVec4(0, 1, 0, 1), "Status: Active (%dx%d)", state_.vcam.Width(), state_.vcam.Height());
+        ImGui::TextColored(ImVec4(0, 1, 0, 1), "Status: Active (%dx%d)", vcam_active_w, vcam_active_h);
         
         if (ImGui::Button("Stop Virtual Camera")) {
+            auto lock = LockIf(locks_.vcam);
             state_.vcam.Close();
             std::cout << "Virtual camera stopped" << std::endl;
         }
@@ -188,7 +200,12 @@ void CameraPanel::RenderVirtualCameraControls() {
                 int vcam_width = state_.camera_width > 0 ? state_.camera_width : 640;
                 int vcam_height = state_.camera_height > 0 ? state_.camera_height : 480;
                 
-                if (state_.vcam.Open(device_path.c_str(), vcam_width, vcam_height)) {
+                bool opened;
+                {
+                    auto lock = LockIf(locks_.vcam);
+                    opened = state_.vcam.Open(device_path.c_str(), vcam_width, vcam_height);
+                }
+                if (opened) {
                     std::cout << "Virtual camera started on " << device_path 
                              << " at " << vcam_width << "x" << vcam_height << std::endl;
                 } else {
@@ -301,6 +318,7 @@ void CameraPanel::RenderCameraControls() {
     }
     
     if (ImGui::Button("Reset to Defaults")) {
+        auto lock = LockIf(locks_.camera);
         camera_mgr_.ApplyDefaultControls();
     }
 }
@@ -317,6 +335,7 @@ void CameraPanel::SliderCtrl(const char* label, CtrlRange& range, uint32_t contr
         // round to step
         int rs = minv + ((v - minv) / step) * step;
         range.val = rs;
+        auto lock = LockIf(locks_.camera);
         camera_mgr_.SetControl(control_id, range.val);
     }
 }
@@ -327,6 +346,7 @@ void CameraPanel::CheckboxCtrl(const char* label, CtrlRange& range, uint32_t con
     bool v = (range.val != 0);
     if (ImGui::Checkbox(label, &v)) {
         range.val = v ? 1 : 0;
+        auto lock = LockIf(locks_.camera);
         camera_mgr_.SetControl(control_id, range.val);
     }
 }
@@ -344,7 +364,12 @@ void CameraPanel::CheckboxExposureAuto(const char* label) {
         
         if (!enabled) {
             // Turn OFF -> MANUAL
-            if (camera_mgr_.SetControl(V4L2_CID_EXPOSURE_AUTO, V4L2_EXPOSURE_MANUAL)) {
+            bool ok;
+            {
+                auto lock = LockIf(locks_.camera);
+                ok = camera_mgr_.SetControl(V4L2_CID_EXPOSURE_AUTO, V4L2_EXPOSURE_MANUAL);
+            }
+            if (ok) {
                 range.val = V4L2_EXPOSURE_MANUAL;
             } else {
                 std::cout << "Failed to set EXPOSURE_AUTO to MANUAL" << std::endl;
@@ -359,6 +384,7 @@ void CameraPanel::CheckboxExposureAuto(const char* label) {
             bool ok = false;
             for (int c : candidates) {
                 if (c < r_autoexposure.min || c > r_autoexposure.max || c == (int)V4L2_EXPOSURE_MANUAL) continue;
+                auto lock = LockIf(locks_.camera);
                 if (camera_mgr_.SetControl(V4L2_CID_EXPOSURE_AUTO, c)) {
                     range.val = c;
                     ok = true;
@@ -473,12 +499,14 @@ void CameraPanel::LoadProfileIntoState(const std::string& profile_name) {
             ui_fps_idx_ = config.camera.ui_fps_idx >= 0 ? config.camera.ui_fps_idx : 0;
             
             // Apply camera change with UI indices
+            auto lock = LockIf(locks_.camera);
             camera_mgr_.SetCurrentCamera(ui_cam_idx_, ui_res_idx_, ui_fps_idx_);
             std::cout << "Profile loaded: Camera changed to index " << ui_cam_idx_ 
                       << " with resolution index " << ui_res_idx_ 
                       << " and FPS index " << ui_fps_idx_ << std::endl;
         } else {
             // Same camera, but possibly different resolution/FPS using actual values
+            auto lock = LockIf(locks_.camera);
             if (config.camera.res_w > 0 && config.camera.res_h > 0) {
                 camera_mgr_.SetResolution(config.camera.res_w, config.camera.res_h);
                 std::cout << "Profile loaded: Resolution changed to " 
@@ -511,17 +539,28 @@ void CameraPanel::LoadProfileIntoState(const std::string& profile_name) {
     // Background settings
     state_.bg_mode = config.background.bg_mode;
     state_.blur_strength = config.background.blur_strength;
+    state_.blur_backend = config.background.blur_backend;
+    state_.mask_upsampler = config.background.mask_upsampler;
     state_.feather_px = config.background.feather_px;
     strncpy(state_.bg_path_buf, config.background.bg_path.c_str(), sizeof(state_.bg_path_buf) - 1);
     state_.bg_path_buf[sizeof(state_.bg_path_buf) - 1] = '\0';
+    strncpy(state_.bg_video_path_buf, config.background.bg_video_path.c_str(), sizeof(state_.bg_video_path_buf) - 1);
+    state_.bg_video_path_buf[sizeof(state_.bg_video_path_buf) - 1] = '\0';
+    state_.bg_video_preload = config.background.bg_video_preload;
     state_.solid_color[0] = config.background.solid_color[0];
     state_.solid_color[1] = config.background.solid_color[1];
     state_.solid_color[2] = config.background.solid_color[2];
     
     // Load background image if path is provided
     if (!config.background.bg_path.empty() && state_.bg_mode == 2) { // 2 = background image mode
+        // Reaches the effects with the next published settings snapshot
         std::cout << "Loading background image from profile: " << config.background.bg_path << std::endl;
-        effects_mgr_.SetBackgroundImageFromPath(config.background.bg_path);
+        cv::Mat img = cv::imread(config.background.bg_path, cv::IMREAD_COLOR);
+        if (!img.empty()) {
+            state_.bg_image = img;
+        } else {
+            std::cerr << "Failed to load background image: " << config.background.bg_path << std::endl;
+        }
     }
     
     // Landmark settings
@@ -618,8 +657,12 @@ bool CameraPanel::SaveStateToProfile(const std::string& profile_name) {
     // Background settings
     config.background.bg_mode = state_.bg_mode;
     config.background.blur_strength = state_.blur_strength;
+    config.background.blur_backend = state_.blur_backend;
+    config.background.mask_upsampler = state_.mask_upsampler;
     config.background.feather_px = state_.feather_px;
     config.background.bg_path = std::string(state_.bg_path_buf);
+    config.background.bg_video_path = std::string(state_.bg_video_path_buf);
+    config.background.bg_video_preload = state_.bg_video_preload;
     config.background.solid_color[0] = state_.solid_color[0];
     config.background.solid_color[1] = state_.solid_color[1];
     config.background.solid_color[2] = state_.solid_color[2];
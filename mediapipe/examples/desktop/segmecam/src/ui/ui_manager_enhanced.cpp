@@ -3,6 +3,7 @@
 #include "app_state.h"
 #include "include/camera/camera_manager.h"
 #include "src/config/config_manager.h"
+#include "include/pipeline/trace.h"
 #include "imgui.h"
 #include "backends/imgui_impl_sdl2.h"
 #include "backends/imgui_impl_opengl3.h"
@@ -119,9 +120,10 @@ void UIManager::DrawInitialFrame() {
     std::cout << "Initial frame drawn" << std::endl;
 }
 
-void UIManager::InitializePanels(AppState& state, CameraManager& camera_mgr, EffectsManager& effects_mgr, ConfigManager* config_mgr) {
+void UIManager::InitializePanels(AppState& state, CameraManager& camera_mgr, ConfigManager* config_mgr,
+                                 const PanelLocks& locks) {
     // Initialize panels with their dependencies
-    auto camera_panel = std::make_unique<CameraPanel>(state, camera_mgr, effects_mgr);
+    auto camera_panel = std::make_unique<CameraPanel>(state, camera_mgr, locks);
     if (config_mgr) {
         camera_panel->SetConfigManager(config_mgr);
         // Update UI to show the default profile that was loaded at startup
@@ -182,6 +184,9 @@ bool UIManager::ProcessEvents(bool& running) {
                 running = false;
                 return false;
             }
+            if (event.key.keysym.sym == SDLK_F12 && !event.key.repeat) {
+                ToggleTracing();
+            }
         }
         
         // Handle drag-and-drop files
@@ -196,6 +201,18 @@ bool UIManager::ProcessEvents(bool& running) {
     return true;
 }
 
+void UIManager::ToggleTracing() {
+    Tracer& tracer = Tracer::Instance();
+    if (!tracer.IsEnabled()) {
+        tracer.Clear();
+        tracer.SetEnabled(true);
+        std::cout << "🔍 Tracing started (F12 again to save)" << std::endl;
+    } else {
+        tracer.SetEnabled(false);
+        tracer.WriteChromeTrace();
+    }
+}
+
 std::vector<std::string> UIManager::GetDroppedFiles() {
     std::vector<std::string> files = std::move(dropped_files_);
     dropped_files_.clear();
@@ -0,0 +1,124 @@
+#include "strip_compositor.h"
+#include "composite_kernels.h"
+#include "include/pipeline/frame_pool.h"
+#include "include/pipeline/trace.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unistd.h>
+
+namespace segmecam {
+
+namespace {
+
+constexpr int kMinStripRows = 16;
+constexpr long kDefaultL2Bytes = 256 * 1024;
+
+long L2CacheBytes() {
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+  long bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  if (bytes > 0) return bytes;
+#endif
+  return kDefaultL2Bytes;
+}
+
+// Same kernel size featherMask in segmecam_composite uses
+int FeatherKernel(float feather_px) {
+  if (feather_px <= 0.5f) return 0;
+  return (int)std::max(1.0f, feather_px) * 2 + 1;
+}
+
+// Vertical half of a bilinear resize (cv::resize pixel-center convention):
+// frame rows [y0, y1) from hmask, already resized to the frame width
+void UpsampleRows(const cv::Mat& hmask, int frame_rows, int y0, int y1, cv::Mat& out) {
+  out.create(y1 - y0, hmask.cols, CV_8UC1);
+  const double scale = (double)hmask.rows / frame_rows;
+  for (int y = y0; y < y1; ++y) {
+    double fy = (y + 0.5) * scale - 0.5;
+    int sy = (int)std::floor(fy);
+    fy -= sy;
+    if (sy < 0) { sy = 0; fy = 0.0; }
+    if (sy >= hmask.rows - 1) { sy = hmask.rows - 1; fy = 0.0; }
+    const int w = (int)std::lround(fy * 256.0);
+    const uint8_t* a = hmask.ptr<uint8_t>(sy);
+    const uint8_t* b = hmask.ptr<uint8_t>(std::min(sy + 1, hmask.rows - 1));
+    uint8_t* o = out.ptr<uint8_t>(y - y0);
+    for (int x = 0; x < hmask.cols; ++x) {
+      o[x] = (uint8_t)((a[x] * (256 - w) + b[x] * w + 128) >> 8);
+    }
+  }
+}
+
+} // namespace
+
+int StripRows(int row_bytes) {
+  static const long l2 = L2CacheBytes();
+  // Half the L2 for the strip; the rest covers halo rows, the mask source
+  // rows and whatever the sibling hyperthread keeps there
+  long rows = l2 / 2 / std::max(1, row_bytes);
+  return std::max(kMinStripRows, (int)(rows / 8 * 8));
+}
+
+void ForEachStrip(int rows, int row_bytes, const std::function<void(int, int)>& fn) {
+  if (rows <= 0) return;
+  const int strip = StripRows(row_bytes);
+  const int strips = (rows + strip - 1) / strip;
+  cv::parallel_for_(cv::Range(0, strips), [&](const cv::Range& r) {
+    for (int i = r.start; i < r.end; ++i) {
+      fn(i * strip, std::min(rows, (i + 1) * strip));
+    }
+  }, strips);
+}
+
+void CompositeStripsToRGB(const cv::Mat& frame_bgr, const cv::Mat& mask_u8,
+                          const cv::Mat& bg_bgr, const cv::Scalar& color,
+                          float feather_px, cv::Mat& out_rgb, FramePool* pool) {
+  SEGMECAM_TRACE_SCOPE("composite.strips");
+  CV_Assert(frame_bgr.type() == CV_8UC3 && mask_u8.type() == CV_8UC1 && !mask_u8.empty());
+  CV_Assert(bg_bgr.empty() || (bg_bgr.type() == CV_8UC3 && bg_bgr.size() == frame_bgr.size()));
+  out_rgb.create(frame_bgr.size(), CV_8UC3);
+
+  const bool upsample = mask_u8.size() != frame_bgr.size();
+  cv::Mat hmask;
+  if (upsample) {
+    // Horizontal pass at model height: a few hundred KB, once per frame
+    hmask = AcquireFrame(pool, cv::Size(frame_bgr.cols, mask_u8.rows), CV_8UC1);
+    cv::resize(mask_u8, hmask, hmask.size(), 0, 0, cv::INTER_LINEAR);
+  }
+  const int fks = FeatherKernel(feather_px);
+  const int halo = fks / 2;
+  const int rows = frame_bgr.rows;
+  // Per row: frame + output (+ background) + mask and feathered mask
+  const int row_bytes = frame_bgr.cols * (bg_bgr.empty() ? 8 : 11);
+
+  ForEachStrip(rows, row_bytes, [&](int y0, int y1) {
+    thread_local cv::Mat strip_mask, feathered;
+    const int ya = std::max(0, y0 - halo);
+    const int yb = std::min(rows, y1 + halo);
+    cv::Mat m;
+    if (upsample) {
+      UpsampleRows(hmask, rows, ya, yb, strip_mask);
+      m = strip_mask;
+    } else {
+      m = mask_u8.rowRange(ya, yb);
+    }
+    if (fks > 0) {
+      // Halo rows hold the kernel support; at the frame edges the strip
+      // border is the frame border, so reflection matches the whole frame
+      feathered.create(m.size(), CV_8UC1);
+      cv::GaussianBlur(m, feathered, cv::Size(fks, fks), 0, 0, cv::BORDER_REFLECT_101 | cv::BORDER_ISOLATED);
+      m = feathered;
+    }
+    const cv::Mat blend_mask = m.rowRange(y0 - ya, y1 - ya);
+    cv::Mat out = out_rgb.rowRange(y0, y1);
+    if (bg_bgr.empty()) {
+      BlendMaskedSolidToRGB(frame_bgr.rowRange(y0, y1), color, blend_mask, out);
+    } else {
+      BlendMaskedToRGB(frame_bgr.rowRange(y0, y1), bg_bgr.rowRange(y0, y1), blend_mask, out);
+    }
+  });
+}
+
+} // namespace segmecam
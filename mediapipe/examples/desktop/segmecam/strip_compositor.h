@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+
+namespace segmecam { class FramePool; }
+
+namespace segmecam {
+
+// Strip-parallel compositing.
+//
+// The frame is cut into horizontal strips sized so one strip's working set
+// (frame, background and output rows plus its mask rows) fits in a core's
+// L2. Strips run on OpenCV's thread pool (cv::parallel_for_, i.e. the
+// cv::setNumThreads() workers EffectsManager sets up), and each worker takes
+// its strip through every step while the rows are still in cache instead of
+// streaming the whole frame through memory once per step.
+
+// Rows per strip for a working set of row_bytes per image row (at least 16,
+// multiple of 8). Uses the L2 size reported by the OS, 256 KB if unknown.
+int StripRows(int row_bytes);
+
+// Runs fn(y0, y1) for every strip of [0, rows) in parallel. fn must only
+// touch its own rows of any output.
+void ForEachStrip(int rows, int row_bytes, const std::function<void(int, int)>& fn);
+
+// Fused composite, per strip:
+//   1. mask rows: bilinear upsample when mask_u8 is not frame-sized (e.g.
+//      the model-resolution mask; the horizontal pass is done once up front)
+//   2. feather: Gaussian of the same kernel as the blur composites, with a
+//      halo of rows so strips match a whole-frame blur (feather_px <= 0.5: off)
+//   3. blend + BGR->RGB via BlendMaskedToRGB / BlendMaskedSolidToRGB
+// bg_bgr: frame-sized CV_8UC3 background, or empty for the solid color.
+// out_rgb is (re)created as CV_8UC3 unless it already has that size/type.
+void CompositeStripsToRGB(const cv::Mat& frame_bgr, const cv::Mat& mask_u8,
+                          const cv::Mat& bg_bgr, const cv::Scalar& color,
+                          float feather_px, cv::Mat& out_rgb,
+                          FramePool* pool = nullptr);
+
+} // namespace segmecam
@@ -1,10 +1,10 @@
 #include "vcam.h"
+#include "include/pipeline/trace.h"
 
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <linux/videodev2.h>
-#include <vector>
 
 namespace segmecam {
 
@@ -28,17 +28,15 @@ void VCam::Close() {
 
 static inline uint8_t clamp8(int v) { return (uint8_t)(v < 0 ? 0 : v > 255 ? 255 : v); }
 
-bool VCam::WriteBGR(const cv::Mat& bgr) {
-  if (fd_ < 0 || bgr.empty()) return false;
-  if (bgr.cols != w_ || bgr.rows != h_) return false;
-  std::vector<uint8_t> yuyv; yuyv.resize((size_t)w_ * (size_t)h_ * 2u);
-  const int W = w_, H = h_;
-  const uint8_t* p = bgr.data; int stride = (int)bgr.step; uint8_t* o = yuyv.data();
+void VCam::PackYUYV(const cv::Mat& img, int r_off, int b_off, uint8_t* o) {
+  SEGMECAM_TRACE_SCOPE("vcam.convert");
+  const int W = img.cols, H = img.rows;
+  const uint8_t* p = img.data; int stride = (int)img.step;
   for (int y=0; y<H; ++y) {
     const uint8_t* row = p + y * stride;
     for (int x=0; x<W; x+=2) {
-      int b0=row[x*3+0], g0=row[x*3+1], r0=row[x*3+2];
-      int b1=row[(x+1)*3+0], g1=row[(x+1)*3+1], r1=row[(x+1)*3+2];
+      int b0=row[x*3+b_off], g0=row[x*3+1], r0=row[x*3+r_off];
+      int b1=row[(x+1)*3+b_off], g1=row[(x+1)*3+1], r1=row[(x+1)*3+r_off];
       int Y0 = ( 66*r0 +129*g0 + 25*b0 +128)>>8; Y0 += 16;
       int Y1 = ( 66*r1 +129*g1 + 25*b1 +128)>>8; Y1 += 16;
       int U  = (-38*r0 - 74*g0 +112*b0 +128)>>8; U += 128;
@@ -49,8 +47,19 @@ bool VCam::WriteBGR(const cv::Mat& bgr) {
       *o++ = clamp8(Y0); *o++ = clamp8(U); *o++ = clamp8(Y1); *o++ = clamp8(V);
     }
   }
-  ssize_t need = (ssize_t)yuyv.size();
-  ssize_t wr = ::write(fd_, yuyv.data(), need);
+}
+
+bool VCam::WriteBGR(const cv::Mat& bgr) { return WritePacked(bgr, 2, 0); }
+bool VCam::WriteRGB(const cv::Mat& rgb) { return WritePacked(rgb, 0, 2); }
+
+bool VCam::WritePacked(const cv::Mat& img, int r_off, int b_off) {
+  if (fd_ < 0 || img.empty() || img.type() != CV_8UC3) return false;
+  if (img.cols != w_ || img.rows != h_) return false;
+  yuyv_.resize((size_t)w_ * (size_t)h_ * 2u);
+  PackYUYV(img, r_off, b_off, yuyv_.data());
+  SEGMECAM_TRACE_SCOPE("vcam.write");
+  ssize_t need = (ssize_t)yuyv_.size();
+  ssize_t wr = ::write(fd_, yuyv_.data(), need);
   return wr == need;
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include "mediapipe/framework/port/opencv_core_inc.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 
@@ -20,10 +22,20 @@ public:
 
   // Convert BGR to YUYV and write to the device. Returns true on success.
   bool WriteBGR(const cv::Mat& bgr);
+  // Same for RGB input (display frames), saves a full-frame RGB->BGR conversion.
+  bool WriteRGB(const cv::Mat& rgb);
+
+  // The conversion behind WriteBGR/WriteRGB, exposed for benchmarking.
+  // r_off/b_off: byte offsets of red/blue within a 3-byte pixel; out must
+  // hold cols * rows * 2 bytes.
+  static void PackYUYV(const cv::Mat& img, int r_off, int b_off, uint8_t* out);
 
 private:
+  bool WritePacked(const cv::Mat& img, int r_off, int b_off);
+
   int fd_ = -1;
   int w_ = 0, h_ = 0;
+  std::vector<uint8_t> yuyv_;  // Reused output buffer
 };
 
 } // namespace segmecam